@@ -0,0 +1,95 @@
+/**
+ * @file Allocation_Tracker.cpp
+ * @brief Replacement global operator new / delete with opt-in counting.
+ *
+ * The plain and aligned forms are replaced: the array and nothrow forms
+ * of the standard library forward to them. The aligned form matters
+ * because std::pmr::new_delete_resource() allocates through it.
+ */
+
+#include "Allocation_Tracker.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+static atomic<bool> tracking(false);
+static atomic<uint64_t> allocation_count(0);
+static atomic<uint64_t> allocation_bytes(0);
+
+void Allocation_Tracker::enable() {
+  tracking.store(true, memory_order_relaxed);
+}
+
+void Allocation_Tracker::disable() {
+  tracking.store(false, memory_order_relaxed);
+}
+
+bool Allocation_Tracker::isEnabled() {
+  return tracking.load(memory_order_relaxed);
+}
+
+uint64_t Allocation_Tracker::getCount() {
+  return allocation_count.load(memory_order_relaxed);
+}
+
+uint64_t Allocation_Tracker::getBytes() {
+  return allocation_bytes.load(memory_order_relaxed);
+}
+
+#ifndef TRUTH_TABLE_NO_ALLOCATION_HOOK
+
+bool Allocation_Tracker::isHooked() {
+  return true;
+}
+
+void* operator new(size_t size) {
+  if (tracking.load(memory_order_relaxed)) {
+    allocation_count.fetch_add(1, memory_order_relaxed);
+    allocation_bytes.fetch_add(size, memory_order_relaxed);
+  }
+  if (void* memory = malloc(size ? size : 1)) {
+    return memory;
+  }
+  throw bad_alloc();
+}
+
+void* operator new(size_t size, align_val_t alignment) {
+  if (tracking.load(memory_order_relaxed)) {
+    allocation_count.fetch_add(1, memory_order_relaxed);
+    allocation_bytes.fetch_add(size, memory_order_relaxed);
+  }
+  // aligned_alloc needs a size that is a multiple of the alignment
+  const size_t align = static_cast<size_t>(alignment);
+  const size_t rounded = (size + align - 1) / align * align;
+  if (void* memory = aligned_alloc(align, rounded ? rounded : align)) {
+    return memory;
+  }
+  throw bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+  free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+  free(memory);
+}
+
+void operator delete(void* memory, align_val_t) noexcept {
+  free(memory);
+}
+
+void operator delete(void* memory, size_t, align_val_t) noexcept {
+  free(memory);
+}
+
+#else
+
+bool Allocation_Tracker::isHooked() {
+  return false;
+}
+
+#endif // TRUTH_TABLE_NO_ALLOCATION_HOOK
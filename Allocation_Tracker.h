@@ -0,0 +1,32 @@
+/**
+ * @class Allocation_Tracker
+ * @brief Counts heap allocations made through the global operator new.
+ *
+ * Allocation_Tracker.cpp replaces the global operator new / delete. The
+ * replacement only counts while tracking is enabled; otherwise it costs a
+ * single flag test on top of malloc. Build with
+ * -DTRUTH_TABLE_NO_ALLOCATION_HOOK to keep the standard operators
+ * (isHooked() then returns false and the counts stay at zero).
+ */
+
+#ifndef ALLOCATION_TRACKER_H
+#define ALLOCATION_TRACKER_H
+
+#include <cstdint>
+
+class Allocation_Tracker {
+  public:
+    // Start / stop counting (counts are kept across disable())
+    static void enable();
+    static void disable();
+    static bool isEnabled();
+
+    // False when the operator new hook was compiled out
+    static bool isHooked();
+
+    // Allocations and requested bytes since the program started counting
+    static uint64_t getCount();
+    static uint64_t getBytes();
+};
+
+#endif //ALLOCATION_TRACKER_H
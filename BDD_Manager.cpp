@@ -0,0 +1,422 @@
+/**
+ * @file BDD_Manager.cpp
+ * @brief Hash-consed ROBDD construction with an ite()-based apply.
+ *
+ * Nodes are appended to the arrays after their children, so every node's
+ * index is larger than the indices of the nodes below it. satCount() uses
+ * that to count bottom-up with one pass over the arrays.
+ */
+
+#include "BDD_Manager.h"
+#include "Boolean_Expression.h"
+#include "Truth_Table.h"
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_set>
+
+using namespace std;
+
+static const uint32_t TERMINAL_LEVEL = UINT32_MAX;   // terminals sit below every variable
+static const BDD_Manager::Node EMPTY = UINT32_MAX;   // unused unique/computed table slot
+
+// Mix three node fields into a table index
+static inline size_t hashTriple(uint32_t a, uint32_t b, uint32_t c) {
+  uint64_t h = a * 0x9E3779B97F4A7C15ull;
+  h ^= (b + 0x7F4A7C15ull + (h << 6) + (h >> 2)) * 0xBF58476D1CE4E5B9ull;
+  h ^= (c + 0x94D049BBull + (h << 6) + (h >> 2)) * 0x94D049BB133111EBull;
+  return static_cast<size_t>(h ^ (h >> 31));
+}
+
+// Constructor : create the two terminals and empty tables
+BDD_Manager::BDD_Manager(const vector<string>& initial_variables) : node_limit(EMPTY - 1) {
+  node_var = {TERMINAL_LEVEL, TERMINAL_LEVEL};
+  node_low = {FALSE_NODE, TRUE_NODE};
+  node_high = {FALSE_NODE, TRUE_NODE};
+
+  unique_table.assign(1 << 12, EMPTY);
+  computed_table.assign(1 << 14, Cache_Entry{EMPTY, EMPTY, EMPTY, EMPTY});
+
+  for (const string& name : initial_variables) {
+    variable(name);
+  }
+}
+
+uint32_t BDD_Manager::variable(const string& name) {
+  auto found = variable_index.find(name);
+  if (found != variable_index.end()) {
+    return found->second;
+  }
+  const uint32_t index = static_cast<uint32_t>(variables.size());
+  variables.push_back(name);
+  variable_index.emplace(name, index);
+  return index;
+}
+
+const vector<string>& BDD_Manager::getVariables() const {
+  return variables;
+}
+
+void BDD_Manager::setNodeLimit(size_t limit) {
+  node_limit = min<size_t>(limit, EMPTY - 1);
+}
+
+size_t BDD_Manager::getVariableCount() const {
+  return variables.size();
+}
+
+uint32_t BDD_Manager::level(Node node) const {
+  return node_var[node];
+}
+
+/**
+ * @brief Return the unique node (var, low, high), creating it if needed.
+ * Reduction rule: a node whose children are equal is never created.
+ */
+BDD_Manager::Node BDD_Manager::makeNode(uint32_t var, Node low, Node high) {
+  if (low == high) {
+    return low;
+  }
+
+  size_t mask = unique_table.size() - 1;
+  size_t bucket = hashTriple(var, low, high) & mask;
+  while (unique_table[bucket] != EMPTY) {
+    const Node candidate = unique_table[bucket];
+    if (node_var[candidate] == var && node_low[candidate] == low && node_high[candidate] == high) {
+      return candidate;
+    }
+    bucket = (bucket + 1) & mask;
+  }
+
+  if (node_var.size() >= node_limit) {
+    throw length_error("BDD node limit reached");
+  }
+
+  const Node node = static_cast<Node>(node_var.size());
+  node_var.push_back(var);
+  node_low.push_back(low);
+  node_high.push_back(high);
+  unique_table[bucket] = node;
+
+  // Keep the unique table at most half full
+  if (node_var.size() * 2 > unique_table.size()) {
+    growUniqueTable();
+  }
+  return node;
+}
+
+/**
+ * @brief Double the unique table (and the computed table with it) and rehash.
+ */
+void BDD_Manager::growUniqueTable() {
+  unique_table.assign(unique_table.size() * 2, EMPTY);
+  const size_t mask = unique_table.size() - 1;
+
+  for (Node node = 2; node < node_var.size(); ++node) {
+    size_t bucket = hashTriple(node_var[node], node_low[node], node_high[node]) & mask;
+    while (unique_table[bucket] != EMPTY) {
+      bucket = (bucket + 1) & mask;
+    }
+    unique_table[bucket] = node;
+  }
+
+  // A bigger diagram needs a bigger cache; old entries stay valid
+  if (computed_table.size() < unique_table.size() && computed_table.size() < (1u << 22)) {
+    vector<Cache_Entry> grown(computed_table.size() * 2, Cache_Entry{EMPTY, EMPTY, EMPTY, EMPTY});
+    const size_t cache_mask = grown.size() - 1;
+    for (const Cache_Entry& entry : computed_table) {
+      if (entry.f != EMPTY) {
+        grown[hashTriple(entry.f, entry.g, entry.h) & cache_mask] = entry;
+      }
+    }
+    computed_table.swap(grown);
+  }
+}
+
+BDD_Manager::Node BDD_Manager::literal(const string& name) {
+  return makeNode(variable(name), FALSE_NODE, TRUE_NODE);
+}
+
+/**
+ * @brief if f then g else h — the single operation behind every operator.
+ */
+BDD_Manager::Node BDD_Manager::ite(Node f, Node g, Node h) {
+  // Terminal cases
+  if (f == TRUE_NODE) return g;
+  if (f == FALSE_NODE) return h;
+  if (g == h) return g;
+  if (g == TRUE_NODE && h == FALSE_NODE) return f;
+
+  // Computed table lookup
+  Cache_Entry& entry = computed_table[hashTriple(f, g, h) & (computed_table.size() - 1)];
+  if (entry.f == f && entry.g == g && entry.h == h) {
+    return entry.result;
+  }
+
+  // Split on the top-most variable of the three operands
+  const uint32_t top = min(level(f), min(level(g), level(h)));
+  auto low = [&](Node n) { return level(n) == top ? node_low[n] : n; };
+  auto high = [&](Node n) { return level(n) == top ? node_high[n] : n; };
+
+  const Node f0 = low(f), g0 = low(g), h0 = low(h);
+  const Node f1 = high(f), g1 = high(g), h1 = high(h);
+
+  const Node then_branch = ite(f1, g1, h1);
+  const Node else_branch = ite(f0, g0, h0);
+  const Node result = makeNode(top, else_branch, then_branch);
+
+  // Recursion may have resized the table; look the slot up again
+  computed_table[hashTriple(f, g, h) & (computed_table.size() - 1)] = Cache_Entry{f, g, h, result};
+  return result;
+}
+
+BDD_Manager::Node BDD_Manager::apply_not(Node f) {
+  return ite(f, FALSE_NODE, TRUE_NODE);
+}
+
+BDD_Manager::Node BDD_Manager::apply_and(Node f, Node g) {
+  return ite(f, g, FALSE_NODE);
+}
+
+BDD_Manager::Node BDD_Manager::apply_or(Node f, Node g) {
+  return ite(f, TRUE_NODE, g);
+}
+
+BDD_Manager::Node BDD_Manager::apply_xor(Node f, Node g) {
+  return ite(f, apply_not(g), g);
+}
+
+BDD_Manager::Node BDD_Manager::apply_nand(Node f, Node g) {
+  return ite(f, apply_not(g), TRUE_NODE);
+}
+
+BDD_Manager::Node BDD_Manager::apply_nor(Node f, Node g) {
+  return ite(f, FALSE_NODE, apply_not(g));
+}
+
+/**
+ * @brief Build the diagram of a postfix token list.
+ * Works like the evaluator's value stack, but the stack holds nodes.
+ * Variables not seen before are appended to the variable order.
+ */
+BDD_Manager::Node BDD_Manager::build(const vector<string>& postfix) {
+  vector<Node> stack;
+
+  for (const string& token : postfix) {
+    if (token == "NOT") {
+      if (stack.empty()) {
+        throw invalid_argument("Missing operand for NOT");
+      }
+      stack.back() = apply_not(stack.back());
+    }
+    else if (token == "AND" || token == "OR" || token == "XOR" || token == "NAND" || token == "NOR") {
+      if (stack.size() < 2) {
+        throw invalid_argument("Missing operand for " + token);
+      }
+      const Node b = stack.back(); stack.pop_back();
+      const Node a = stack.back();
+
+      if (token == "AND") stack.back() = apply_and(a, b);
+      else if (token == "OR") stack.back() = apply_or(a, b);
+      else if (token == "XOR") stack.back() = apply_xor(a, b);
+      else if (token == "NAND") stack.back() = apply_nand(a, b);
+      else stack.back() = apply_nor(a, b);
+    }
+    else if (token == "TRUE" || token == "FALSE") {
+      stack.push_back(token == "TRUE" ? TRUE_NODE : FALSE_NODE);
+    }
+    else {
+      stack.push_back(literal(token));
+    }
+  }
+
+  if (stack.size() != 1) {
+    throw invalid_argument(stack.empty() ? "Empty expression" : "Missing operator between operands");
+  }
+  return stack.back();
+}
+
+/**
+ * @brief Count satisfying assignments over all manager variables.
+ *
+ * count[n] = assignments of the variables from level(n) downwards that
+ * satisfy node n. Skipped levels between a node and its child double the
+ * child's count once per skipped variable.
+ *
+ * Only nodes reachable from root are counted: nodes left over from
+ * earlier builds (e.g. a lone literal near the top of a wide AND) can have
+ * counts that overflow even when root's count fits.
+ */
+uint64_t BDD_Manager::satCount(Node root) const {
+  const uint32_t n = static_cast<uint32_t>(variables.size());
+  auto levelOf = [&](Node node) { return node <= TRUE_NODE ? n : node_var[node]; };
+
+  // Multiply by 2^shift, failing on overflow
+  auto scale = [](uint64_t value, uint32_t shift) {
+    if (value != 0 && (shift >= 64 || value > (UINT64_MAX >> shift))) {
+      throw overflow_error("Satisfying count does not fit in 64 bits");
+    }
+    return shift >= 64 ? 0 : value << shift;
+  };
+
+  // Mark what root depends on
+  const size_t size = max<size_t>(root, TRUE_NODE) + 1;
+  vector<bool> reachable(size, false);
+  vector<Node> pending = {root};
+  while (!pending.empty()) {
+    const Node node = pending.back();
+    pending.pop_back();
+    if (node <= TRUE_NODE || reachable[node]) {
+      continue;
+    }
+    reachable[node] = true;
+    pending.push_back(node_low[node]);
+    pending.push_back(node_high[node]);
+  }
+
+  // Children always have smaller indices, so one ascending pass suffices
+  vector<uint64_t> count(size, 0);
+  count[TRUE_NODE] = 1;
+  for (Node node = 2; node <= root; ++node) {
+    if (!reachable[node]) {
+      continue;
+    }
+    const uint32_t var = node_var[node];
+    const uint64_t low = scale(count[node_low[node]], levelOf(node_low[node]) - var - 1);
+    const uint64_t high = scale(count[node_high[node]], levelOf(node_high[node]) - var - 1);
+    if (low > UINT64_MAX - high) {
+      throw overflow_error("Satisfying count does not fit in 64 bits");
+    }
+    count[node] = low + high;
+  }
+
+  return scale(count[root], levelOf(root));
+}
+
+/**
+ * @brief Probability that a uniformly random assignment satisfies root.
+ */
+double BDD_Manager::satFraction(Node root) const {
+  vector<double> fraction(max<size_t>(root, TRUE_NODE) + 1, 0.0);
+  fraction[TRUE_NODE] = 1.0;
+  for (Node node = 2; node <= root; ++node) {
+    fraction[node] = (fraction[node_low[node]] + fraction[node_high[node]]) / 2;
+  }
+  return fraction[root];
+}
+
+string BDD_Manager::satCountText(Node root) const {
+  if (isTautology(root)) {
+    return rowCountText(variables.size());
+  }
+  try {
+    return to_string(satCount(root));
+  }
+  catch (const overflow_error&) {
+    ostringstream text;
+    text << satFraction(root) << " * 2^" << variables.size();
+    return text.str();
+  }
+}
+
+string BDD_Manager::rowCountText(size_t variables) {
+  if (variables < 64) {
+    return to_string(1ull << variables);
+  }
+  if (variables == 64) {
+    return "18446744073709551616";
+  }
+  return "2^" + to_string(variables);
+}
+
+unique_ptr<Truth_Table> BDD_Manager::countingTable(Boolean_Expression& expression, Expression_Cache* cache) {
+  if (expression.getVariableNames().size() > ENUMERATE_MAX_VARIABLES) {
+    return nullptr;
+  }
+  return make_unique<Truth_Table>(expression, true, cache);   // only the count is used
+}
+
+BDD_Manager::Row_Count BDD_Manager::countRows(Boolean_Expression& expression, const Truth_Table* table) {
+  Row_Count count;
+  if (table) {
+    count.rows = rowCountText(table->getVariables().size());
+    count.true_rows = to_string(table->countTrue());
+  }
+  else {
+    BDD_Manager bdd;
+    const Node root = bdd.build(expression.convertToPostfix());
+    count.rows = rowCountText(bdd.getVariableCount());
+    count.true_rows = bdd.satCountText(root);
+  }
+
+  count.status = "satisfiable";
+  if (count.true_rows == count.rows) count.status = "tautology";
+  else if (count.true_rows == "0") count.status = "contradiction";
+  return count;
+}
+
+bool BDD_Manager::isTautology(Node root) const {
+  return root == TRUE_NODE;
+}
+
+bool BDD_Manager::isSatisfiable(Node root) const {
+  return root != FALSE_NODE;
+}
+
+bool BDD_Manager::equivalent(Node a, Node b) const {
+  return a == b; // canonical: equal functions share one node
+}
+
+/**
+ * @brief Follow any path to TRUE; variables off the path are set to false.
+ */
+bool BDD_Manager::anySatisfying(Node root, vector<bool>& assignment) const {
+  assignment.assign(variables.size(), false);
+  if (root == FALSE_NODE) {
+    return false;
+  }
+
+  Node node = root;
+  while (node > TRUE_NODE) {
+    if (node_low[node] != FALSE_NODE) {
+      node = node_low[node];
+    }
+    else {
+      assignment[node_var[node]] = true;
+      node = node_high[node];
+    }
+  }
+  return true;
+}
+
+size_t BDD_Manager::size(Node root) const {
+  unordered_set<Node> seen;
+  vector<Node> pending = {root};
+  while (!pending.empty()) {
+    const Node node = pending.back();
+    pending.pop_back();
+    if (!seen.insert(node).second || node <= TRUE_NODE) {
+      continue;
+    }
+    pending.push_back(node_low[node]);
+    pending.push_back(node_high[node]);
+  }
+  return seen.size();
+}
+
+uint32_t BDD_Manager::getVar(Node node) const {
+  return node_var[node];
+}
+
+BDD_Manager::Node BDD_Manager::getLow(Node node) const {
+  return node_low[node];
+}
+
+BDD_Manager::Node BDD_Manager::getHigh(Node node) const {
+  return node_high[node];
+}
+
+size_t BDD_Manager::getNodeCount() const {
+  return node_var.size();
+}
@@ -0,0 +1,145 @@
+/**
+ * @class BDD_Manager
+ * @brief Reduced ordered binary decision diagrams for Boolean expressions.
+ *
+ * Answers "how many rows are true?", "is it a tautology?" and "are these two
+ * expressions equivalent?" without walking all 2^n rows.
+ *
+ * Storage:
+ *  - Nodes live in three parallel arrays (variable, low child, high child);
+ *    a node is referred to by its index. 0 is FALSE, 1 is TRUE.
+ *  - A unique table (open addressing) hash-conses (variable, low, high), so
+ *    equal functions always share one node: equivalence is index equality.
+ *  - A direct-mapped computed table caches ite(f, g, h) results.
+ *
+ * Every operator is applied through ite(): AND = ite(f, g, 0),
+ * OR = ite(f, 1, g), XOR = ite(f, ¬g, g), NOT = ite(f, 0, 1), ...
+ *
+ * Nodes are never freed; use one manager per batch of related queries.
+ */
+
+#ifndef BDD_MANAGER_H
+#define BDD_MANAGER_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+class Boolean_Expression;
+class Expression_Cache;
+class Truth_Table;
+
+class BDD_Manager {
+  public:
+    using Node = uint32_t;
+    static constexpr Node FALSE_NODE = 0;
+    static constexpr Node TRUE_NODE = 1;
+
+    // countRows() enumerates rows up to this many variables; a BDD above it
+    static constexpr size_t ENUMERATE_MAX_VARIABLES = 24;
+
+    // True-row count, row count and status of an expression, as text
+    struct Row_Count {
+      string true_rows;   // countTrue(), or satCountText() above ENUMERATE_MAX_VARIABLES
+      string rows;        // rowCountText()
+      string status;      // tautology, contradiction or satisfiable
+    };
+
+  private:
+    // Node storage: node i tests variable node_var[i]; terminals use variable_count sentinel
+    vector<uint32_t> node_var;
+    vector<Node> node_low;
+    vector<Node> node_high;
+
+    // Unique table: open addressing over node indices (EMPTY = unused bucket)
+    vector<Node> unique_table;
+
+    // Computed table for ite(f, g, h)
+    struct Cache_Entry {
+      Node f, g, h, result;
+    };
+    vector<Cache_Entry> computed_table;
+
+    vector<string> variables;                   // order: index = level
+    unordered_map<string, uint32_t> variable_index;
+    size_t node_limit;                          // makeNode() throws length_error beyond this
+
+    Node makeNode(uint32_t var, Node low, Node high);
+    void growUniqueTable();
+    uint32_t level(Node node) const;
+
+  public:
+    // variables fixes the initial order; more can be added by name later
+    explicit BDD_Manager(const vector<string>& variables = {});
+
+    // Level of a variable, adding it at the bottom of the order if new
+    uint32_t variable(const string& name);
+    const vector<string>& getVariables() const;
+    size_t getVariableCount() const;
+
+    // Give up (length_error) once the diagram holds this many nodes, for
+    // callers with a cheaper fallback than an exponential diagram
+    void setNodeLimit(size_t limit);
+
+    // Node for a single variable
+    Node literal(const string& name);
+
+    // if f then g else h
+    Node ite(Node f, Node g, Node h);
+
+    Node apply_not(Node f);
+    Node apply_and(Node f, Node g);
+    Node apply_or(Node f, Node g);
+    Node apply_xor(Node f, Node g);
+    Node apply_nand(Node f, Node g);
+    Node apply_nor(Node f, Node g);
+
+    // Build from postfix tokens (output of Boolean_Expression::convertToPostfix());
+    // throws invalid_argument on malformed postfix
+    Node build(const vector<string>& postfix);
+
+    // Satisfying assignments over all manager variables;
+    // throws overflow_error if the count does not fit in 64 bits
+    uint64_t satCount(Node root) const;
+
+    // Fraction of assignments that satisfy root (never overflows)
+    double satFraction(Node root) const;
+
+    // satCount() as text; a count past 64 bits is written as the row
+    // count (tautology) or as "<fraction> * 2^n"
+    string satCountText(Node root) const;
+
+    // Rows of a table over `variables` variables: 2^n written out up to
+    // n = 64, and as "2^n" above
+    static string rowCountText(size_t variables);
+
+    // The table countRows() enumerates (simplified, through the cache if
+    // any), or null when the expression has too many variables for it
+    static unique_ptr<Truth_Table> countingTable(Boolean_Expression& expression, Expression_Cache* cache);
+
+    // Count the expression's rows: by enumerating table (from
+    // countingTable()) when it is set, with a BDD otherwise. The one
+    // count behind --batch lines and the --serve count command.
+    static Row_Count countRows(Boolean_Expression& expression, const Truth_Table* table);
+
+    bool isTautology(Node root) const;
+    bool isSatisfiable(Node root) const;
+    bool equivalent(Node a, Node b) const;
+
+    // One satisfying assignment (value per manager variable); false if UNSAT
+    bool anySatisfying(Node root, vector<bool>& assignment) const;
+
+    // Nodes reachable from root (terminals included)
+    size_t size(Node root) const;
+
+    uint32_t getVar(Node node) const;
+    Node getLow(Node node) const;
+    Node getHigh(Node node) const;
+    size_t getNodeCount() const;
+};
+
+#endif //BDD_MANAGER_H
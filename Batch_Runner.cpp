@@ -0,0 +1,266 @@
+/**
+ * @file Batch_Runner.cpp
+ * @brief Reader thread, two worker pools and an in-order writer.
+ *
+ * Every stage ends by passing one end marker per downstream worker, so
+ * each worker of the next pool sees exactly one and stops; the writer
+ * stops after one marker from every evaluate worker.
+ *
+ * Each line gets a dense sequence number. The writer keeps a ring of
+ * REORDER_WINDOW result slots indexed by sequence % REORDER_WINDOW, and
+ * the reader waits while it is a full window ahead of the writer, so a
+ * finished result always has a free slot.
+ */
+
+#include "Batch_Runner.h"
+#include "BDD_Manager.h"
+#include "Boolean_Expression.h"
+#include "Bounded_Queue.h"
+#include "Ordered_Chunk_Writer.h"
+#include "Parse_Error.h"
+#include "Run_Stats.h"
+#include "Truth_Table.h"
+
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// A line read from the input
+struct Line_Job {
+  uint64_t sequence = 0;
+  uint64_t line_number = 0;
+  string text;
+  bool end = false;
+};
+
+// A parsed line: a compiled table, an expression for the BDD, or an error
+struct Parsed_Job {
+  uint64_t sequence = 0;
+  uint64_t line_number = 0;
+  unique_ptr<Boolean_Expression> expression;
+  unique_ptr<Truth_Table> table;   // set when rows are enumerated
+  string error;
+  string error_kind;               // Parse_Error::kindName(), or "invalid"
+  bool end = false;
+};
+
+// One formatted output line
+struct Result_Job {
+  uint64_t sequence = 0;
+  string text;
+  bool error = false;
+  bool end = false;
+};
+
+// Strip leading and trailing whitespace
+static string trim(const string& line) {
+  const size_t first = line.find_first_not_of(" \t\r\n");
+  if (first == string::npos) {
+    return "";
+  }
+  const size_t last = line.find_last_not_of(" \t\r\n");
+  return line.substr(first, last - first + 1);
+}
+
+/**
+ * @brief Stage 2 — tokenize, check the syntax and compile one line.
+ */
+static Parsed_Job parseLine(Line_Job& line, Expression_Cache* cache) {
+  Parsed_Job job;
+  job.sequence = line.sequence;
+  job.line_number = line.line_number;
+
+  try {
+    {
+      Run_Stats::Scope scope(Run_Stats::Phase::PARSE);
+      job.expression = make_unique<Boolean_Expression>(line.text);
+      job.expression->postfixTokens();   // throws Parse_Error on bad syntax
+      Run_Stats::add(Run_Stats::Counter::TOKENS, job.expression->getTokens().size());
+    }
+
+    job.table = BDD_Manager::countingTable(*job.expression, cache);
+  }
+  catch (const Parse_Error& error) {
+    job.error = error.what();
+    job.error_kind = Parse_Error::kindName(error.getKind());
+    job.table.reset();
+    job.expression.reset();
+  }
+  catch (const exception& error) {
+    job.error = error.what();
+    job.error_kind = "invalid";
+    job.table.reset();
+    job.expression.reset();
+  }
+  return job;
+}
+
+/**
+ * @brief Stage 3 — count the true rows and format the result line.
+ */
+static Result_Job evaluateJob(Parsed_Job& job) {
+  Result_Job result;
+  result.sequence = job.sequence;
+  string prefix = to_string(job.line_number) + "\t";
+
+  if (!job.error.empty()) {
+    result.text = prefix + "error\t" + job.error_kind + "\t" + job.error + "\n";
+    result.error = true;
+    return result;
+  }
+
+  try {
+    const BDD_Manager::Row_Count count = BDD_Manager::countRows(*job.expression, job.table.get());
+    result.text = prefix + count.status + "\t" + count.true_rows + "\t" + count.rows + "\t" +
+                  job.expression->getOriginalExpression() + "\n";
+  }
+  catch (const exception& error) {
+    result.text = prefix + "error\tinvalid\t" + error.what() + "\n";
+    result.error = true;
+  }
+  return result;
+}
+
+// Constructor : fix the size of each worker pool and of the cache
+Batch_Runner::Batch_Runner(unsigned threads, size_t cache_bytes)
+    : thread_count(Ordered_Chunk_Writer::resolveThreads(threads)) {
+  if (cache_bytes > 0) {
+    cache = make_unique<Expression_Cache>(cache_bytes);
+  }
+}
+
+unsigned Batch_Runner::getThreadCount() const {
+  return thread_count;
+}
+
+/**
+ * @brief Run the pipeline until the input is exhausted and every result
+ * has been written.
+ */
+Batch_Runner::Summary Batch_Runner::run(istream& input, ostream& output) const {
+  Bounded_Queue<Line_Job> lines(QUEUE_CAPACITY);
+  Bounded_Queue<Parsed_Job> parsed(QUEUE_CAPACITY);
+  Bounded_Queue<Result_Job> results(QUEUE_CAPACITY);
+  atomic<uint64_t> written(0);   // results the writer has already output
+
+  // Stage 1 : read and number the lines
+  thread reader([&] {
+    string line;
+    uint64_t line_number = 0;
+    uint64_t sequence = 0;
+
+    while (getline(input, line)) {
+      ++line_number;
+      string text = trim(line);
+      if (text.empty() || text[0] == '#') {
+        continue;
+      }
+
+      // Stay within one reorder window of the writer
+      while (sequence >= written.load(memory_order_acquire) + REORDER_WINDOW) {
+        this_thread::yield();
+      }
+
+      Line_Job job;
+      job.sequence = sequence++;
+      job.line_number = line_number;
+      job.text = move(text);
+      lines.push(move(job));
+    }
+
+    for (unsigned i = 0; i < thread_count; ++i) {
+      Line_Job end;
+      end.end = true;
+      lines.push(move(end));
+    }
+  });
+
+  // Stage 2 : parse and compile
+  vector<thread> parsers;
+  for (unsigned i = 0; i < thread_count; ++i) {
+    parsers.emplace_back([&] {
+      while (true) {
+        Line_Job line = lines.pop();
+        if (line.end) {
+          Parsed_Job end;
+          end.end = true;
+          parsed.push(move(end));
+          return;
+        }
+        parsed.push(parseLine(line, cache.get()));
+      }
+    });
+  }
+
+  // Stage 3 : evaluate and format
+  vector<thread> evaluators;
+  for (unsigned i = 0; i < thread_count; ++i) {
+    evaluators.emplace_back([&] {
+      while (true) {
+        Parsed_Job job = parsed.pop();
+        if (job.end) {
+          Result_Job end;
+          end.end = true;
+          results.push(move(end));
+          return;
+        }
+        results.push(evaluateJob(job));
+      }
+    });
+  }
+
+  // Writer : put results back in input order
+  Summary summary;
+  vector<string> pending(REORDER_WINDOW);
+  vector<bool> ready(REORDER_WINDOW, false);
+  uint64_t next = 0;
+  unsigned finished = 0;
+
+  while (finished < thread_count) {
+    Result_Job result = results.pop();
+    if (result.end) {
+      ++finished;
+      continue;
+    }
+
+    ++summary.expressions;
+    if (result.error) {
+      ++summary.errors;
+    }
+
+    const size_t slot = result.sequence % REORDER_WINDOW;
+    pending[slot] = move(result.text);
+    ready[slot] = true;
+
+    // Write every result that is now next in line
+    while (ready[next % REORDER_WINDOW]) {
+      const size_t head = next % REORDER_WINDOW;
+      Run_Stats::Scope scope(Run_Stats::Phase::OUTPUT);
+      Run_Stats::add(Run_Stats::Counter::OUTPUT_BYTES, pending[head].size());
+      output << pending[head];
+      pending[head].clear();
+      ready[head] = false;
+      ++next;
+      written.store(next, memory_order_release);
+    }
+  }
+
+  reader.join();
+  for (thread& t : parsers) {
+    t.join();
+  }
+  for (thread& t : evaluators) {
+    t.join();
+  }
+  output.flush();
+  if (cache) {
+    summary.cache = cache->getStatistics();
+  }
+  return summary;
+}
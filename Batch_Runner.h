@@ -0,0 +1,78 @@
+/**
+ * @class Batch_Runner
+ * @brief Evaluates many expressions (one per input line) through a
+ *        three-stage parallel pipeline.
+ *
+ *   reader ──► parse/compile pool ──► evaluate/format pool ──► writer
+ *          queue                 queue                    queue
+ *
+ *  - The reader thread numbers the lines and hands them on
+ *  - Parse workers tokenize, check and compile each expression
+ *  - Evaluate workers count its true rows with BDD_Manager::countRows()
+ *    (bit-sliced enumeration up to BDD_Manager::ENUMERATE_MAX_VARIABLES
+ *    variables, a BDD above that; the same count as --serve) and format
+ *    one result line
+ *  - The calling thread writes results strictly in input order
+ *
+ * Parse workers share one Expression_Cache: a line whose canonical form
+ * was seen before reuses the true-row count (and the compiled program,
+ * if it is spelled with the same tokens).
+ *
+ * Stages are joined by Bounded_Queue (lock-free, bounded), and the reader
+ * never runs more than REORDER_WINDOW lines ahead of the writer, so memory
+ * stays flat for any input size. A malformed line produces an error line;
+ * it does not stop the run.
+ *
+ * Output, one tab-separated line per expression (blank lines and lines
+ * starting with '#' are skipped):
+ *   line  status  true_rows  rows  expression
+ * Above 64 variables rows is "2^n", and a true-row count past 64 bits is
+ * "2^n" (tautology) or "<fraction> * 2^n" (BDD_Manager::satCountText()).
+ * status is tautology, contradiction, satisfiable or error; for an
+ * error the kind (Parse_Error::kindName(), e.g. missing_operand or
+ * unmatched_open, or "invalid" for other failures) and the message
+ * replace the counts:
+ *   line  error  kind  message
+ */
+
+#ifndef BATCH_RUNNER_H
+#define BATCH_RUNNER_H
+
+#include "Expression_Cache.h"
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <ostream>
+
+using namespace std;
+
+class Batch_Runner {
+  public:
+    // Lines waiting between two stages
+    static constexpr size_t QUEUE_CAPACITY = 1024;
+
+    // Lines that may be in flight between the reader and the writer
+    static constexpr size_t REORDER_WINDOW = 4096;
+
+    struct Summary {
+      uint64_t expressions = 0;
+      uint64_t errors = 0;
+      Expression_Cache::Statistics cache;   // after the run (zero without a cache)
+    };
+
+  private:
+    unsigned thread_count;   // workers per pool
+    unique_ptr<Expression_Cache> cache;   // null when disabled
+
+  public:
+    // threads == 0 uses one worker per hardware thread (per pool);
+    // cache_bytes == 0 turns the result cache off
+    explicit Batch_Runner(unsigned threads, size_t cache_bytes = Expression_Cache::DEFAULT_MAX_BYTES);
+
+    unsigned getThreadCount() const;
+
+    // Read expressions from input and write one result line each to output
+    Summary run(istream& input, ostream& output) const;
+};
+
+#endif //BATCH_RUNNER_H
@@ -0,0 +1,422 @@
+/**
+ * @file Bitslice_Evaluator.cpp
+ * @brief Bit-parallel evaluation of a Compiled_Program.
+ *
+ * Flow for one block:
+ *   1) loadVariables(): build each variable's bit vector from the row index
+ *   2) run*(): walk the instructions once; each gate is one bitwise
+ *              instruction over the whole block and writes its step vector
+ *
+ * updateBlock() instead reloads only the variables that changed and
+ * passes the kernels the changed variables' cones as the instruction
+ * order, so the same kernels serve full and incremental evaluation.
+ * With native code, run() calls the function generated for that order
+ * (the full pass or one cone) instead.
+ *
+ * Operands are value indices, i.e. positions in the buffer, so no stack is
+ * needed and no bit vector is ever copied while evaluating.
+ */
+
+#include "Bitslice_Evaluator.h"
+#include "Run_Stats.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define BITSLICE_HAS_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+bool Bitslice_Evaluator::jit_enabled = false;
+
+// Bit i of LOW_BIT_PATTERNS[p] is bit p of i: the value of the row-index bit p
+// for the 64 rows inside one word.
+static const uint64_t LOW_BIT_PATTERNS[6] = {
+    0xAAAAAAAAAAAAAAAAull, 0xCCCCCCCCCCCCCCCCull, 0xF0F0F0F0F0F0F0F0ull,
+    0xFF00FF00FF00FF00ull, 0xFFFF0000FFFF0000ull, 0xFFFFFFFF00000000ull,
+};
+
+// Index of the lowest set bit (word must be non-zero)
+static inline unsigned lowestBit(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctzll(word);
+#else
+  unsigned bit = 0;
+  while (!((word >> bit) & 1)) ++bit;
+  return bit;
+#endif
+}
+
+/**
+ * @brief Fill one bit vector per variable for the rows of this block.
+ * Variables are mapped MSB→LSB, like the table: slot j reads bit (n-1-j).
+ */
+static void loadVariables(size_t variable_count, size_t words, uint64_t first_row, uint64_t* buffer) {
+  for (size_t slot = 0; slot < variable_count; ++slot) {
+    const size_t bit = variable_count - slot - 1;
+    uint64_t* vec = buffer + slot * words;
+
+    for (size_t w = 0; w < words; ++w) {
+      if (bit < 6) {
+        vec[w] = LOW_BIT_PATTERNS[bit];
+      }
+      else {
+        const uint64_t row = first_row + 64 * w;
+        vec[w] = ((row >> bit) & 1) ? ~0ull : 0ull;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Portable kernel: one 64-bit word per bit vector.
+ * Runs instructions order[0 .. count) (or 0 .. count when order is null).
+ */
+static void runScalar(const vector<Instruction>& code, const uint32_t* order, size_t count,
+                      size_t variable_count, uint64_t* buffer) {
+  uint64_t* steps = buffer + variable_count;
+
+  for (size_t i = 0; i < count; ++i) {
+    const size_t k = order ? order[i] : i;
+    const Instruction& ins = code[k];
+    const uint64_t a = buffer[ins.a];
+    const uint64_t b = buffer[ins.b];
+    uint64_t* out = steps + k;
+
+    switch (ins.op) {
+      case Opcode::NOT:  *out = ~a; break;
+      case Opcode::AND:  *out = a & b; break;
+      case Opcode::OR:   *out = a | b; break;
+      case Opcode::XOR:  *out = a ^ b; break;
+      case Opcode::NAND: *out = ~(a & b); break;
+      case Opcode::NOR:  *out = ~(a | b); break;
+      case Opcode::CONST_TRUE: *out = ~0ull; break;
+      default:           *out = 0; break;
+    }
+  }
+}
+
+#ifdef BITSLICE_HAS_X86_KERNELS
+
+/**
+ * @brief AVX2 kernel: one 256-bit register (4 words) per bit vector.
+ * Same instruction order as runScalar().
+ */
+__attribute__((target("avx2")))
+static void runAvx2(const vector<Instruction>& code, const uint32_t* order, size_t count,
+                    size_t variable_count, uint64_t* buffer) {
+  __m256i* vectors = reinterpret_cast<__m256i*>(buffer);
+  __m256i* steps = vectors + variable_count;
+  const __m256i ones = _mm256_set1_epi64x(-1);
+
+  for (size_t i = 0; i < count; ++i) {
+    const size_t k = order ? order[i] : i;
+    const Instruction& ins = code[k];
+    const __m256i a = _mm256_loadu_si256(vectors + ins.a);
+    const __m256i b = _mm256_loadu_si256(vectors + ins.b);
+
+    __m256i result;
+    switch (ins.op) {
+      case Opcode::NOT:  result = _mm256_xor_si256(a, ones); break;
+      case Opcode::AND:  result = _mm256_and_si256(a, b); break;
+      case Opcode::OR:   result = _mm256_or_si256(a, b); break;
+      case Opcode::XOR:  result = _mm256_xor_si256(a, b); break;
+      case Opcode::NAND: result = _mm256_xor_si256(_mm256_and_si256(a, b), ones); break;
+      case Opcode::NOR:  result = _mm256_xor_si256(_mm256_or_si256(a, b), ones); break;
+      case Opcode::CONST_TRUE: result = ones; break;
+      default:           result = _mm256_setzero_si256(); break;
+    }
+
+    _mm256_storeu_si256(steps + k, result);
+  }
+}
+
+/**
+ * @brief AVX-512 kernel: one 512-bit register (8 words) per bit vector.
+ * NAND/NOR use a single ternary-logic instruction. Same instruction order
+ * as runScalar().
+ */
+__attribute__((target("avx512f")))
+static void runAvx512(const vector<Instruction>& code, const uint32_t* order, size_t count,
+                      size_t variable_count, uint64_t* buffer) {
+  __m512i* vectors = reinterpret_cast<__m512i*>(buffer);
+  __m512i* steps = vectors + variable_count;
+  const __m512i ones = _mm512_set1_epi64(-1);
+
+  for (size_t i = 0; i < count; ++i) {
+    const size_t k = order ? order[i] : i;
+    const Instruction& ins = code[k];
+    const __m512i a = _mm512_loadu_si512(vectors + ins.a);
+    const __m512i b = _mm512_loadu_si512(vectors + ins.b);
+
+    // Ternary-logic immediates: truth table over (a, b, c) with a=0xF0, b=0xCC
+    __m512i result;
+    switch (ins.op) {
+      case Opcode::NOT:  result = _mm512_xor_si512(a, ones); break;
+      case Opcode::AND:  result = _mm512_and_si512(a, b); break;
+      case Opcode::OR:   result = _mm512_or_si512(a, b); break;
+      case Opcode::XOR:  result = _mm512_xor_si512(a, b); break;
+      case Opcode::NAND: result = _mm512_ternarylogic_epi64(a, b, b, 0x3F); break;
+      case Opcode::NOR:  result = _mm512_ternarylogic_epi64(a, b, b, 0x03); break;
+      case Opcode::CONST_TRUE: result = ones; break;
+      default:           result = _mm512_setzero_si512(); break;
+    }
+
+    _mm512_storeu_si512(steps + k, result);
+  }
+}
+
+#endif // BITSLICE_HAS_X86_KERNELS
+
+// Words per bit vector for each kernel
+static size_t wordsFor(Bitslice_Evaluator::Kernel kernel) {
+  switch (kernel) {
+    case Bitslice_Evaluator::Kernel::AVX512: return 8;
+    case Bitslice_Evaluator::Kernel::AVX2:   return 4;
+    default:                                 return 1;
+  }
+}
+
+// Constructor : pick the widest kernel this CPU supports
+Bitslice_Evaluator::Bitslice_Evaluator(const Compiled_Program& program)
+    : Bitslice_Evaluator(program, detectKernel()) {}
+
+// Constructor : honour a requested kernel when the CPU can run it
+Bitslice_Evaluator::Bitslice_Evaluator(const Compiled_Program& program, Kernel requested)
+    : program(program), kernel(Kernel::SCALAR) {
+  const Kernel best = detectKernel();
+  if (requested == Kernel::AVX512 && best == Kernel::AVX512) {
+    kernel = Kernel::AVX512;
+  }
+  else if (requested == Kernel::AVX2 && best != Kernel::SCALAR) {
+    kernel = Kernel::AVX2;
+  }
+  block_words = wordsFor(kernel);
+  block_bits = 0;
+  while ((size_t(1) << block_bits) < getBlockRows()) {
+    ++block_bits;
+  }
+  buildCones();
+  if (jit_enabled && !program.getCode().empty() && program.getVariables().size() >= JIT_MIN_VARIABLES) {
+    buildJit();
+  }
+}
+
+/**
+ * @brief Record, for every variable that changes between blocks, which
+ * instructions depend on it.
+ * Dependencies are propagated as masks of row bits in program order, which
+ * is topological, so each cone comes out already in evaluation order.
+ */
+void Bitslice_Evaluator::buildCones() {
+  const size_t variable_count = program.getVariables().size();
+  const vector<Instruction>& code = program.getCode();
+  cones.assign(64, {});
+  cone_is_full.assign(64, false);
+
+  // depends[value]: row bits (>= block_bits) the value depends on
+  vector<uint64_t> depends(variable_count + code.size(), 0);
+  for (size_t slot = 0; slot < variable_count; ++slot) {
+    const size_t bit = variable_count - slot - 1;
+    if (bit >= block_bits && bit < 64) {
+      depends[slot] = 1ull << bit;
+    }
+  }
+  vector<size_t> cone_size(64, 0);
+  for (size_t k = 0; k < code.size(); ++k) {
+    const Instruction& ins = code[k];
+    // Constants depend on nothing, so no cone ever re-runs them
+    const unsigned operands = Expression_DAG::operandCount(ins.op);
+    uint64_t mask = operands >= 1 ? depends[ins.a] : 0;
+    if (operands == 2) {
+      mask |= depends[ins.b];
+    }
+    depends[variable_count + k] = mask;
+    for (uint64_t bits = mask; bits; bits &= bits - 1) {
+      ++cone_size[lowestBit(bits)];
+    }
+  }
+
+  for (size_t bit = block_bits; bit < 64; ++bit) {
+    if (2 * cone_size[bit] > code.size()) {
+      cone_is_full[bit] = true;
+    }
+    else {
+      cones[bit].reserve(cone_size[bit]);
+    }
+  }
+  for (size_t k = 0; k < code.size(); ++k) {
+    for (uint64_t bits = depends[variable_count + k]; bits; bits &= bits - 1) {
+      const size_t bit = lowestBit(bits);
+      if (!cone_is_full[bit]) {
+        cones[bit].push_back(static_cast<uint32_t>(k));
+      }
+    }
+  }
+}
+
+/**
+ * @brief Translate the full pass and every cone that updateBlock() runs
+ * into native code. Any failure leaves the evaluator interpreting.
+ */
+void Bitslice_Evaluator::buildJit() {
+  if (!Jit_Kernel::isSupported()) {
+    return;
+  }
+  Run_Stats::Scope scope(Run_Stats::Phase::COMPILE);
+
+  // orders[0] is the full pass, then one per cone
+  vector<Jit_Kernel::Order> orders = {{nullptr, program.getCode().size()}};
+  vector<size_t> cone_bits;
+  for (size_t bit = block_bits; bit < 64; ++bit) {
+    if (!cones[bit].empty()) {
+      orders.push_back({cones[bit].data(), cones[bit].size()});
+      cone_bits.push_back(bit);
+    }
+  }
+
+  try {
+    jit = make_shared<const Jit_Kernel>(program, block_words, orders);
+  }
+  catch (const exception&) {
+    return;
+  }
+  full_entry = jit->getEntry(0);
+  cone_entries.assign(64, nullptr);
+  for (size_t i = 0; i < cone_bits.size(); ++i) {
+    cone_entries[cone_bits[i]] = jit->getEntry(i + 1);
+  }
+  Run_Stats::add(Run_Stats::Counter::NATIVE_CODE_BYTES, jit->getCodeBytes());
+}
+
+/**
+ * @brief Ask the CPU which vector extensions it has (checked once).
+ */
+Bitslice_Evaluator::Kernel Bitslice_Evaluator::detectKernel() {
+#ifdef BITSLICE_HAS_X86_KERNELS
+  static const Kernel detected = [] {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return Kernel::AVX512;
+    if (__builtin_cpu_supports("avx2")) return Kernel::AVX2;
+    return Kernel::SCALAR;
+  }();
+  return detected;
+#else
+  return Kernel::SCALAR;
+#endif
+}
+
+string Bitslice_Evaluator::kernelName(Kernel kernel) {
+  switch (kernel) {
+    case Kernel::AVX512: return "avx512";
+    case Kernel::AVX2:   return "avx2";
+    default:             return "scalar";
+  }
+}
+
+void Bitslice_Evaluator::enableJit(bool enabled) {
+  jit_enabled = enabled;
+}
+
+bool Bitslice_Evaluator::isJitEnabled() {
+  return jit_enabled;
+}
+
+bool Bitslice_Evaluator::usesJit() const {
+  return full_entry != nullptr;
+}
+
+Bitslice_Evaluator::Kernel Bitslice_Evaluator::getKernel() const {
+  return kernel;
+}
+
+size_t Bitslice_Evaluator::getBlockWords() const {
+  return block_words;
+}
+
+size_t Bitslice_Evaluator::getBlockRows() const {
+  return block_words * 64;
+}
+
+size_t Bitslice_Evaluator::getBufferWords() const {
+  return (program.getVariables().size() + program.getStepCount()) * block_words;
+}
+
+// Run instructions order[0 .. count) (all of them, in order, when order is
+// null), or the native function generated for that order
+void Bitslice_Evaluator::run(const uint32_t* order, size_t count, Jit_Kernel::Entry native,
+                             uint64_t* buffer) const {
+  const size_t variable_count = program.getVariables().size();
+  if (native) {
+    native(buffer);
+    return;
+  }
+  switch (kernel) {
+#ifdef BITSLICE_HAS_X86_KERNELS
+    case Kernel::AVX512:
+      runAvx512(program.getCode(), order, count, variable_count, buffer);
+      break;
+    case Kernel::AVX2:
+      runAvx2(program.getCode(), order, count, variable_count, buffer);
+      break;
+#endif
+    default:
+      runScalar(program.getCode(), order, count, variable_count, buffer);
+      break;
+  }
+}
+
+/**
+ * @brief Evaluate one block of rows with the selected kernel.
+ */
+void Bitslice_Evaluator::evaluateBlock(uint64_t first_row, uint64_t* buffer) const {
+  loadVariables(program.getVariables().size(), block_words, first_row, buffer);
+  run(nullptr, program.getCode().size(), full_entry, buffer);
+}
+
+void Bitslice_Evaluator::evaluateVectors(uint64_t* buffer) const {
+  run(nullptr, program.getCode().size(), full_entry, buffer);
+}
+
+size_t Bitslice_Evaluator::getUpdateCost(uint64_t previous_row, uint64_t first_row) const {
+  size_t cost = 0;
+  for (uint64_t bits = (previous_row ^ first_row) >> block_bits << block_bits; bits; bits &= bits - 1) {
+    const size_t bit = lowestBit(bits);
+    cost += cone_is_full[bit] ? program.getCode().size() : cones[bit].size();
+  }
+  return cost;
+}
+
+/**
+ * @brief Move the buffer from one block to another.
+ * Cones are run one after another; an instruction in several cones may
+ * run more than once but ends up correct, because each cone is in program
+ * order and every changed variable is reloaded first. If that would cost
+ * as much as a full pass, the block is simply evaluated again.
+ */
+void Bitslice_Evaluator::updateBlock(uint64_t previous_row, uint64_t first_row, uint64_t* buffer) const {
+  const uint64_t changed = (previous_row ^ first_row) >> block_bits << block_bits;
+  if (getUpdateCost(previous_row, first_row) >= program.getCode().size()) {
+    evaluateBlock(first_row, buffer);
+    return;
+  }
+
+  const size_t variable_count = program.getVariables().size();
+  for (uint64_t bits = changed; bits; bits &= bits - 1) {
+    const size_t bit = lowestBit(bits);
+    if (bit < variable_count) {
+      uint64_t* vec = buffer + (variable_count - bit - 1) * block_words;
+      const uint64_t value = ((first_row >> bit) & 1) ? ~0ull : 0ull;
+      for (size_t w = 0; w < block_words; ++w) {
+        vec[w] = value;
+      }
+    }
+  }
+  for (uint64_t bits = changed; bits; bits &= bits - 1) {
+    const size_t bit = lowestBit(bits);
+    const vector<uint32_t>& cone = cones[bit];
+    if (!cone.empty()) {
+      run(cone.data(), cone.size(), cone_entries.empty() ? nullptr : cone_entries[bit], buffer);
+    }
+  }
+}
@@ -0,0 +1,166 @@
+/**
+ * @class Bitslice_Evaluator
+ * @brief Evaluates a Compiled_Program over many truth-table rows at once.
+ *
+ * Each variable is held as a bit vector: bit i of the vector is the
+ * variable's value in row (first_row + i). Every gate then becomes a single
+ * bitwise instruction over the whole block (AND → &, NOR → ~(a | b), ...).
+ *
+ * The kernel is picked at runtime:
+ *  - AVX-512 : 512 rows per instruction
+ *  - AVX2    : 256 rows per instruction
+ *  - Scalar  :  64 rows per instruction (portable fallback)
+ *
+ * Incremental blocks: inside a block only the low row bits vary, so two
+ * blocks differ only in the "high" variables read from the block index.
+ * For each high variable the evaluator keeps its fan-out cone (the
+ * instructions that depend on it, in program order). updateBlock() turns
+ * the buffer of one block into the next by reloading the changed
+ * variables and re-running only their cones. forEachBlock() visits blocks
+ * in Gray-code order, where exactly one high variable changes per step.
+ *
+ * With enableJit() (--jit) and at least JIT_MIN_VARIABLES variables, the
+ * full pass and each cone run as native code (Jit_Kernel) for the selected
+ * width, so no instruction is dispatched at run time; where that code
+ * cannot be generated (not x86-64, mapping refused, code budget exceeded),
+ * the interpreted kernels above are used instead.
+ */
+
+#ifndef BITSLICE_EVALUATOR_H
+#define BITSLICE_EVALUATOR_H
+
+#include "Compiled_Program.h"
+#include "Jit_Kernel.h"
+#include "Run_Stats.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class Bitslice_Evaluator {
+  public:
+    enum class Kernel { SCALAR, AVX2, AVX512 };
+
+    // With fewer variables the whole table is enumerated faster than
+    // native code can be generated, so the JIT is skipped
+    static constexpr size_t JIT_MIN_VARIABLES = 18;
+
+  private:
+    const Compiled_Program& program;
+    Kernel kernel;
+    size_t block_words;   // 64-bit words per bit vector (1, 4 or 8)
+    size_t block_bits;    // log2(rows per block): row bits that vary inside a block
+
+    // cones[bit]: instructions depending on the variable read from row bit
+    // `bit` (bit >= block_bits); empty with cone_is_full[bit] set when the
+    // cone is more than half the program (a full pass is then just as good)
+    vector<vector<uint32_t>> cones;
+    vector<bool> cone_is_full;
+
+    // Native code (--jit): shared by copies of the evaluator; the entries
+    // are null where the interpreter runs instead
+    static bool jit_enabled;
+    shared_ptr<const Jit_Kernel> jit;
+    Jit_Kernel::Entry full_entry = nullptr;
+    vector<Jit_Kernel::Entry> cone_entries;
+
+    void buildCones();
+    void buildJit();
+    void run(const uint32_t* order, size_t count, Jit_Kernel::Entry native, uint64_t* buffer) const;
+
+  public:
+    // Uses the widest kernel the running CPU supports
+    explicit Bitslice_Evaluator(const Compiled_Program& program);
+
+    // Forces a kernel (falls back to SCALAR if the CPU cannot run it)
+    Bitslice_Evaluator(const Compiled_Program& program, Kernel requested);
+
+    // Widest kernel available on this machine
+    static Kernel detectKernel();
+    static string kernelName(Kernel kernel);
+
+    // Generate native code in evaluators constructed from now on (call
+    // before starting worker threads)
+    static void enableJit(bool enabled);
+    static bool isJitEnabled();
+
+    // True when this evaluator runs native code for its full pass
+    bool usesJit() const;
+
+    Kernel getKernel() const;
+    size_t getBlockWords() const;   // words per bit vector
+    size_t getBlockRows() const;    // rows per evaluateBlock() call
+
+    // Words the caller must provide to evaluateBlock()
+    size_t getBufferWords() const;
+
+    /**
+     * Evaluate rows [first_row, first_row + getBlockRows()).
+     * first_row must be a multiple of getBlockRows().
+     *
+     * buffer layout (each entry getBlockWords() words):
+     *   [slot 0 .. slot n-1][step 0 .. step k-1]
+     * Bit i of word w in an entry is the value for row first_row + 64*w + i.
+     */
+    void evaluateBlock(uint64_t first_row, uint64_t* buffer) const;
+
+    // Same as evaluateBlock(), but with variable vectors the caller has
+    // already stored in the buffer (e.g. random input patterns)
+    void evaluateVectors(uint64_t* buffer) const;
+
+    /**
+     * Turn a buffer holding the block at previous_row into the block at
+     * first_row: only variables whose value differs between the two blocks
+     * are reloaded, and only the instructions in their cones are re-run.
+     */
+    void updateBlock(uint64_t previous_row, uint64_t first_row, uint64_t* buffer) const;
+
+    // Instructions that updateBlock() would run for this change
+    size_t getUpdateCost(uint64_t previous_row, uint64_t first_row) const;
+
+    // i-th Gray code: consecutive codes differ in exactly one bit
+    static uint64_t grayCode(uint64_t index) {
+      return index ^ (index >> 1);
+    }
+
+    /**
+     * Evaluate blocks first_block .. first_block + block_count - 1 (block
+     * indices, i.e. first row / getBlockRows()) into buffer, calling
+     * visit(block_index, buffer) after each. When block_count is a power of
+     * two and first_block a multiple of it, blocks are visited in Gray-code
+     * order (one variable changes per step); otherwise in index order,
+     * still re-running only the cones of the variables that change. Either
+     * way visit() receives the standard block index, so callers place the
+     * results in normal row order.
+     */
+    template <typename Visit>
+    void forEachBlock(uint64_t first_block, uint64_t block_count, uint64_t* buffer, Visit visit) const;
+};
+
+template <typename Visit>
+void Bitslice_Evaluator::forEachBlock(uint64_t first_block, uint64_t block_count, uint64_t* buffer,
+                                      Visit visit) const {
+  if (block_count == 0) {
+    return;
+  }
+  // One timer for the whole pass: per block it would cost as much as the block
+  Run_Stats::Scope scope(Run_Stats::Phase::EVALUATE);
+  Run_Stats::add(Run_Stats::Counter::BLOCKS, block_count);
+  const bool gray = (block_count & (block_count - 1)) == 0 && first_block % block_count == 0;
+  const uint64_t rows = getBlockRows();
+
+  uint64_t previous = first_block;
+  evaluateBlock(first_block * rows, buffer);
+  visit(first_block, buffer);
+
+  for (uint64_t i = 1; i < block_count; ++i) {
+    const uint64_t block = first_block + (gray ? grayCode(i) : i);
+    updateBlock(previous * rows, block * rows, buffer);
+    visit(block, buffer);
+    previous = block;
+  }
+}
+
+#endif //BITSLICE_EVALUATOR_H
@@ -15,8 +15,12 @@
    */
 
 #include "Boolean_Expression.h"
+#include "Expression_Simplifier.h"
+#include "Parse_Error.h"
+#include "Run_Stats.h"
 
-#include <iostream>
+#include <algorithm>
+#include <unordered_map>
 
 #include "AND_Operator.h"
 #include "OR_Operator.h"
@@ -31,14 +35,39 @@ using namespace std;
 // --------------------------- Precedence Table -------------------------------
 // Highest number = higher precedence. NOT binds strongest, then AND/NAND,
 // then OR/NOR/XOR. This table is consulted during infix→postfix conversion.
-map<string, int> logic_priority = {
-    {"NOT", 3},
-    {"AND", 2}, {"NAND", 2},
-    {"OR", 1}, {"NOR", 1}, {"XOR", 1},
-};
+static int precedence(Opcode op) {
+  switch (op) {
+    case Opcode::NOT:  return 3;
+    case Opcode::AND:
+    case Opcode::NAND: return 2;
+    default:           return 1;   // OR, NOR, XOR
+  }
+}
+
+// One instance of each operator, shared by every expression: they have no
+// state, so findOperators() needs no allocation per occurrence
+static const Boolean_Operator* operatorFor(Opcode op) {
+  static const AND_Operator and_operator;
+  static const OR_Operator or_operator;
+  static const NOT_Operator not_operator;
+  static const NAND_Operator nand_operator;
+  static const NOR_Operator nor_operator;
+  static const XOR_Operator xor_operator;
+
+  switch (op) {
+    case Opcode::AND:  return &and_operator;
+    case Opcode::OR:   return &or_operator;
+    case Opcode::NOT:  return &not_operator;
+    case Opcode::NAND: return &nand_operator;
+    case Opcode::NOR:  return &nor_operator;
+    case Opcode::XOR:  return &xor_operator;
+    default:           return nullptr;
+  }
+}
 
 // Constructor
-Boolean_Expression::Boolean_Expression(const string& expr): original_expression(expr) {
+Boolean_Expression::Boolean_Expression(const string& expr, pmr::memory_resource* resource)
+  : resource(resource), original_expression(expr, resource), tokenizer(resource), operators_found(resource) {
   splitExpression();
   findOperators();
 }
@@ -46,49 +75,22 @@ Boolean_Expression::Boolean_Expression(const string& expr): original_expression(
 /**
  * @brief Split the original string into tokens.
  * Rules:
- *  - Variables are single letters: A, B, C
+ *  - Variables are identifiers: A, B, req_valid, x17
  *  - Operators are words: AND, OR, NOT, XOR, NAND, NOR
+ *  - TRUE and FALSE are constants
  *  - Parentheses are single-character tokens: '(' and ')'
  *  - Whitespace separates tokens but is otherwise ignored
  *
  * Example:
  *   "(A AND B) XOR NOT C"
  *   → ["(", "A", "AND", "B", ")", "XOR", "NOT", "C"]
+ *
+ * Each token is a small record {kind, op, var_id, offset, length} pointing
+ * into original_expression (see Tokenizer); characters that cannot start a
+ * token throw Parse_Error.
  */
 void Boolean_Expression::splitExpression() {
-
-  expression_parts.clear();
-  string part; 
-
-  // Scan once across the raw expression
-  for (int i = 0; i < original_expression.length(); ++i) {
-    char ch = original_expression[i];
-
-    if (isspace(ch)) {
-      // Push any word we’ve collected so far
-      if (!part.empty()) {
-        expression_parts.push_back(part);
-        part.clear();
-      }
-    }
-    else if (ch == '(' || ch == ')') {
-      // Push any pending token, then push the parenthesis as its own token
-      if (!part.empty()) {
-        expression_parts.push_back(part);
-        part.clear();
-      }
-      expression_parts.emplace_back(1, ch); // Add bracket as a separate token
-    }
-    else {
-      // Build up a word token (e.g., AND/OR/NOT or variable letter)
-      part += ch;
-    }
-  }
-
-  // Append the final token if the loop ended mid-word
-  if (!part.empty()) {
-    expression_parts.push_back(part);
-  }
+  tokenizer.tokenize(original_expression);
 }
 
 /**
@@ -98,24 +100,9 @@ void Boolean_Expression::splitExpression() {
 void Boolean_Expression:: findOperators() {
   operators_found.clear();
 
-  for(const string& piece : expression_parts) {
-    if (piece == "AND") {
-      operators_found.push_back(std::make_unique <AND_Operator>());
-    }
-    else if (piece == "OR") {
-      operators_found.push_back(std::make_unique <OR_Operator>());
-    }
-    else if (piece == "NOT") {
-      operators_found.push_back(std::make_unique <NOT_Operator>());
-    }
-    else if (piece == "NAND") {
-      operators_found.push_back(std::make_unique <NAND_Operator>());
-    }
-    else if (piece == "NOR") {
-      operators_found.push_back(std::make_unique <NOR_Operator>());
-    }
-    else if (piece == "XOR") {
-      operators_found.push_back(std::make_unique <XOR_Operator>());
+  for (const Token& token : tokenizer.getTokens()) {
+    if (token.kind == Token_Kind::OPERATOR) {
+      operators_found.push_back(operatorFor(token.op));
     }
   }
 }
@@ -130,51 +117,98 @@ void Boolean_Expression:: findOperators() {
  *       - If "(" → push to stack
  *       - If ")" → pop until "("
  *   - After scanning → pop any remaining stack operators to output
+ *
+ * The scan also tracks whether an operand or an operator is expected next,
+ * so every syntax error is reported at the token where it happens.
  */
+pmr::vector<Token> Boolean_Expression::postfixTokens() const {
+  const pmr::vector<Token>& tokens = tokenizer.getTokens();
 
-vector<string> Boolean_Expression:: convertToPostfix() {
-  
-  vector<string> postfix_output; 
-  vector<string> logic_stack; // operator stack
-
-  for (const string& symbol : expression_parts) {
-    // Case 1: variable (operands go straight to output)
-    if (symbol == "A" || symbol == "B" || symbol == "C") {
-      postfix_output.push_back(symbol);
-    }
-    // Case 2: known operator (consult precedence table)
-    else if (logic_priority.find(symbol) != logic_priority.end()) {
-        // Pop stronger or equal-precedence operators before pushing current
-      while(!logic_stack.empty() && logic_stack.back() != "(" &&
-             logic_priority[symbol] <= logic_priority[logic_stack.back()]) {
-        postfix_output.push_back(logic_stack.back());
-        logic_stack.pop_back();
-      }
-      logic_stack.push_back(symbol); // Push current operator
-    }
-    // Case 3: open parenthesis → push
-    else if (symbol == "("){
-      logic_stack.push_back(symbol);
-    }
-    // Case 4: close parenthesis → drain until matching "("
-    else if (symbol == ")"){
-      while(!logic_stack.empty() && logic_stack.back() != "("){
-        postfix_output.push_back(logic_stack.back());
-        logic_stack.pop_back();
-      }
-      if(!logic_stack.empty()){
+  pmr::vector<Token> postfix_output(resource);
+  pmr::vector<Token> logic_stack(resource); // operator stack
+  postfix_output.reserve(tokens.size());
+
+  bool expect_operand = true;
+
+  for (const Token& token : tokens) {
+    switch (token.kind) {
+      // Case 1: variable or constant (operands go straight to output)
+      case Token_Kind::VARIABLE:
+      case Token_Kind::CONSTANT:
+        if (!expect_operand) {
+          throw Parse_Error(Parse_Error::Kind::MISSING_OPERATOR, "Missing operator before " + Parse_Error::quote(tokenText(token)),
+                            token.offset, token.length);
+        }
+        postfix_output.push_back(token);
+        expect_operand = false;
+        break;
+
+      // Case 2: known operator (consult precedence table)
+      case Token_Kind::OPERATOR:
+        if (token.op == Opcode::NOT) {
+          // NOT is a prefix operator: its operand has not been read yet, so it
+          // must never pop anything (otherwise "NOT NOT A" loses an operand).
+          if (!expect_operand) {
+            throw Parse_Error(Parse_Error::Kind::MISSING_OPERATOR, "Missing operator before NOT", token.offset, token.length);
+          }
+        }
+        else {
+          if (expect_operand) {
+            throw Parse_Error(Parse_Error::Kind::MISSING_OPERAND, "Missing operand before " + string(tokenText(token)),
+                              token.offset, token.length);
+          }
+          // Pop stronger or equal-precedence operators before pushing current.
+          while (!logic_stack.empty() && logic_stack.back().kind == Token_Kind::OPERATOR &&
+                 precedence(token.op) <= precedence(logic_stack.back().op)) {
+            postfix_output.push_back(logic_stack.back());
+            logic_stack.pop_back();
+          }
+          expect_operand = true;
+        }
+        logic_stack.push_back(token); // Push current operator
+        break;
+
+      // Case 3: open parenthesis → push
+      case Token_Kind::LEFT_PAREN:
+        if (!expect_operand) {
+          throw Parse_Error(Parse_Error::Kind::MISSING_OPERATOR, "Missing operator before '('", token.offset, token.length);
+        }
+        logic_stack.push_back(token);
+        break;
+
+      // Case 4: close parenthesis → drain until matching "("
+      case Token_Kind::RIGHT_PAREN:
+        if (expect_operand) {
+          throw Parse_Error(Parse_Error::Kind::MISSING_OPERAND, "Missing operand before ')'", token.offset, token.length);
+        }
+        while (!logic_stack.empty() && logic_stack.back().kind != Token_Kind::LEFT_PAREN) {
+          postfix_output.push_back(logic_stack.back());
+          logic_stack.pop_back();
+        }
+        if (logic_stack.empty()) {
+          throw Parse_Error(Parse_Error::Kind::UNMATCHED_CLOSE, "Unmatched ')'", token.offset, token.length);
+        }
         logic_stack.pop_back(); // Remove "("
-      }
-    }
-    // Case 5: anything else is unexpected (typo or unknown token)
-    else
-    {
-      std::cout << "Undefined operator " << symbol << std::endl;
+        break;
     }
   }
 
+  if (tokens.empty()) {
+    throw Parse_Error(Parse_Error::Kind::EMPTY_EXPRESSION, "Empty expression", 0);
+  }
+  if (expect_operand) {
+    throw Parse_Error(Parse_Error::Kind::MISSING_OPERAND, "Missing operand at end of expression", original_expression.size());
+  }
+
   // After the loop, move remaining operators to output
-  while (!logic_stack.empty()){
+  while (!logic_stack.empty()) {
+    if (logic_stack.back().kind == Token_Kind::LEFT_PAREN) {
+      const size_t open = count_if(logic_stack.begin(), logic_stack.end(),
+                                   [](const Token& entry) { return entry.kind == Token_Kind::LEFT_PAREN; });
+      throw Parse_Error(Parse_Error::Kind::UNMATCHED_OPEN,
+                        "Unmatched '('" + (open > 1 ? " (" + to_string(open) + " left open)" : string()),
+                        logic_stack.back().offset, logic_stack.back().length);
+    }
     postfix_output.push_back(logic_stack.back());
     logic_stack.pop_back();
   }
@@ -183,86 +217,302 @@ vector<string> Boolean_Expression:: convertToPostfix() {
 }
 
 /**
- * @brief Evaluate a postfix sequence for a given assignment of A/B/C
+ * @brief Postfix as strings, for code that works on token text
+ * (BDD_Manager::build(), evaluateWithSteps()).
+ * Example: ["A", "AND", "B", "XOR", "NOT", "C"] → ["A", "B", "AND", "C", "NOT", "XOR"]
+ */
+vector<string> Boolean_Expression:: convertToPostfix() {
+  vector<string> postfix_output;
+  for (const Token& token : postfixTokens()) {
+    postfix_output.emplace_back(tokenText(token));
+  }
+  return postfix_output;
+}
+
+/**
+ * @brief Evaluate a postfix sequence for a given assignment of the variables
  *        while capturing readable step labels for the truth table.
  *
- * Stacks:
- *   - eval_stack   : holds boolean values during evaluation
- *   - label_stack  : mirrors eval_stack with human-readable labels
- *                    (e.g., "NOT C", "(A AND B)")
+ * Convenience wrapper for a single row: it compiles the postfix into a
+ * Compiled_Program (which builds the labels once) and runs it. Code that
+ * evaluates many rows should compile once and call
+ * Compiled_Program::evaluate() with its own buffers instead.
  *
  * Return:
  *   - pair of ( vector of (label, value) for each intermediate step, final result )
  *   - The steps drive the truth-table “explanation” columns.
  */
 pair<vector<pair<string, bool>>, bool>
-Boolean_Expression::evaluateWithSteps(const vector<string>& postfix, const map<char, bool>& input_values) {
-  vector<bool> eval_stack; // boolean values (operands & results)
-  vector<string> label_stack; // matching labels for pretty output
-  vector<pair<string, bool>> steps; // ordered (label, result)
+Boolean_Expression::evaluateWithSteps(const vector<string>& postfix, const map<string, bool>& input_values) {
+  vector<string> variables;
+  for (const auto& input : input_values) {
+    variables.push_back(input.first);
+  }
+  const Compiled_Program program = Compiled_Program::compile(postfix, variables);
 
   // Example:
   // postfix: ["A", "B", "C", "NOT", "XOR", "AND"]
   // inputs : {A:1, B:0, C:1}
-  for (const string& piece : postfix) {
-    // Operand → push its boolean value + its label ("A"/"B"/"C")
-    if (piece == "A" || piece == "B" || piece == "C") {
-      eval_stack.push_back(input_values.at(piece[0])); // piece[0] is 'A'/'B'/'C'
-      label_stack.push_back(piece);
-    }
-    // Unary operator: NOT
-    else if (piece == "NOT") {
-      // Pop one value, compute, push result; keep label in sync
-      bool a = eval_stack.back(); eval_stack.pop_back();
-      string aLabel = label_stack.back(); label_stack.pop_back();
-
-      bool result = !a;
-      string label = "NOT " + aLabel;
-      steps.emplace_back(label, result);
-
-      eval_stack.push_back(result);
-      label_stack.push_back(label);
-    }
-    // Binary operators: AND/OR/XOR/NAND/NOR
-    else {
-      // Pop right then left (stack order), compute, label as "(left op right)"
-      bool b = eval_stack.back(); eval_stack.pop_back();
-      bool a = eval_stack.back(); eval_stack.pop_back();
+  unique_ptr<bool[]> inputs(new bool[variables.size() + 1]);
+  unique_ptr<bool[]> values(new bool[program.getStepCount() + 1]);
+  size_t slot = 0;
+  for (const auto& input : input_values) {
+    inputs[slot++] = input.second;
+  }
+
+  const bool result = program.evaluate(inputs.get(), values.get());
+
+  vector<pair<string, bool>> steps; // ordered (label, result)
+  for (size_t step = 0; step < program.getStepCount(); ++step) {
+    steps.emplace_back(program.getStepLabels()[step], values[step]);
+  }
+  return { steps, result };
+}
+
+/**
+ * @brief Compile this expression for fast repeated evaluation.
+ * The tokens are interpreted once here; afterwards each row only
+ * runs the integer opcodes (see Compiled_Program::evaluate()).
+ */
+Compiled_Program Boolean_Expression::compile(const vector<string>& variables, bool simplify) {
+  Expression_DAG dag(variables);
+  const Expression_DAG::Node_Id root = buildGraph(dag, simplify);
+  Run_Stats::add(Run_Stats::Counter::NODES, dag.getNodeCount() - variables.size());
+  Run_Stats::raise(Run_Stats::Counter::PEAK_STACK_DEPTH, dag.getPeakDepth());
+  return Compiled_Program::compile(dag, root);
+}
+
+/**
+ * @brief Add this expression's subexpressions to an expression graph.
+ * Each interned name is mapped to its slot in dag.getVariables() once;
+ * throws invalid_argument if a name has no slot. To simplify, the
+ * expression is first built in a scratch graph over the same variables.
+ */
+Expression_DAG::Node_Id Boolean_Expression::buildGraph(Expression_DAG& dag, bool simplify) const {
+  const vector<string>& variables = dag.getVariables();
+  if (simplify) {
+    Expression_DAG original(variables);
+    const Expression_DAG::Node_Id root = buildGraph(original);
+    Expression_Simplifier simplifier(original, dag);
+    return simplifier.simplify(root);
+  }
 
-      string bLabel = label_stack.back(); label_stack.pop_back();
-      string aLabel = label_stack.back(); label_stack.pop_back();
+  // Interned name (var_id) → slot in the graph's variable order
+  unordered_map<string_view, uint32_t> slot_of;
+  for (uint32_t slot = 0; slot < variables.size(); ++slot) {
+    slot_of.emplace(variables[slot], slot);
+  }
 
-      string label = "(" + aLabel + " " + piece + " " + bLabel + ")";
-      bool result = false;
+  const pmr::vector<string_view>& names = tokenizer.getNames();
+  vector<uint32_t> slots(names.size());
+  for (size_t id = 0; id < names.size(); ++id) {
+    auto found = slot_of.find(names[id]);
+    if (found == slot_of.end()) {
+      throw invalid_argument("Unknown variable " + string(names[id]));
+    }
+    slots[id] = found->second;
+  }
 
-      if (piece == "AND") result = a && b;
-      else if (piece == "OR") result = a || b;
-      else if (piece == "XOR") result = a != b;
-      else if (piece == "NAND") result = !(a && b);
-      else if (piece == "NOR") result = !(a || b);
+  return dag.build(postfixTokens(), slots);
+}
 
-      steps.emplace_back(label, result);
-      eval_stack.push_back(result);
-      label_stack.push_back(label);
+/**
+ * @brief Variable names are identifiers that are not keywords.
+ * Example: "A", "req_valid", "x17" are variables; "AND", "TRUE", "17x", "a-b" are not.
+ */
+bool Boolean_Expression::isVariable(const string& token) {
+  if (token.empty() || !Tokenizer::isIdentifierStart(token[0])) {
+    return false;
+  }
+  for (char ch : token) {
+    if (!Tokenizer::isIdentifierChar(ch)) {
+      return false;
     }
   }
+  Opcode op;
+  return !Expression_DAG::lookupOpcode(token, op);
+}
 
-  // The remaining stack top is the final result for this input assignment
-  return { steps, eval_stack.back() };
+const pmr::vector<Token>& Boolean_Expression::getTokens() const {
+  return tokenizer.getTokens();
+}
+
+const pmr::vector<string_view>& Boolean_Expression::getVariableNames() const {
+  return tokenizer.getNames();
+}
+
+string_view Boolean_Expression::tokenText(const Token& token) const {
+  return string_view(original_expression).substr(token.offset, token.length);
 }
 
 /**
  * @brief Expose the detected operators (for UI explanation).
- * Returns a const reference so ownership stays within the expression object.
+ * The pointers refer to shared, immutable operator instances.
  */
-const std::vector<std::unique_ptr<Boolean_Operator>>&
-Boolean_Expression::getOperators() const {
+const pmr::vector<const Boolean_Operator*>& Boolean_Expression::getOperators() const {
     return operators_found;
 }
 
+pmr::memory_resource* Boolean_Expression::getResource() const {
+  return resource;
+}
+
+/**
+ * @brief Simplified form, for display next to the original.
+ * Example: "NOT NOT A AND (A OR B) AND NOT (C AND D)" → "A AND (C NAND D)"
+ */
+string Boolean_Expression::getSimplifiedExpression() const {
+  vector<string> variables(getVariableNames().begin(), getVariableNames().end());
+  Expression_DAG dag(variables);
+  return dag.toText(buildGraph(dag, true));
+}
+
+// Final mix of splitmix64: spreads a value over all 64 bits
+static inline uint64_t mixHash(uint64_t h) {
+  h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+  h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+  return h ^ (h >> 31);
+}
+
+// AND, OR and XOR chains can be regrouped freely; NAND and NOR cannot
+static inline bool isAssociative(Opcode op) {
+  return op == Opcode::AND || op == Opcode::OR || op == Opcode::XOR;
+}
+
+/**
+ * @brief Canonical text of the expression (see Expression_Cache).
+ *
+ * One pass over the postfix builds a tree whose nodes carry a hash that
+ * ignores operand order: a binary node hashes the sum of its operands'
+ * mixed hashes, and an AND/OR/XOR node adds the sum of an operand with the
+ * same operator instead of its hash, so any grouping of a chain gives the
+ * same value. NOT NOT cancels. The text is then written top-down (without
+ * recursion), gathering each chain's operands and sorting them by hash:
+ *   "C AND (B OR A)" and "(A OR B) AND C" → the same text, such as
+ *   "AND(C,OR(A,B))" (operands in hash order, not by name)
+ * Variables are hashed by name, so the result does not depend on the
+ * order in which names first appear.
+ */
+string Boolean_Expression::getCanonicalForm() const {
+  struct Canonical_Node {
+    Opcode op;
+    uint32_t a;      // operand node (VAR: var_id)
+    uint32_t b;
+    uint64_t sum;    // binary: sum of the mixed operand hashes (chains flattened)
+    uint64_t hash;
+  };
+  static constexpr uint32_t NONE = UINT32_MAX;
+
+  const pmr::vector<string_view>& names = tokenizer.getNames();
+  vector<uint64_t> name_hashes(names.size());
+  for (size_t id = 0; id < names.size(); ++id) {
+    uint64_t h = 0xCBF29CE484222325ull;   // FNV-1a
+    for (char ch : names[id]) {
+      h = (h ^ static_cast<unsigned char>(ch)) * 0x100000001B3ull;
+    }
+    name_hashes[id] = mixHash(h);
+  }
+
+  auto salt = [](Opcode op) { return (static_cast<uint64_t>(op) + 1) * 0x9E3779B97F4A7C15ull; };
+
+  vector<Canonical_Node> nodes;
+  vector<uint32_t> stack;
+  for (const Token& token : postfixTokens()) {
+    const uint32_t id = static_cast<uint32_t>(nodes.size());
+    if (token.kind == Token_Kind::VARIABLE) {
+      nodes.push_back({Opcode::VAR, token.var_id, 0, 0, name_hashes[token.var_id]});
+    }
+    else if (token.kind == Token_Kind::CONSTANT) {
+      nodes.push_back({token.op, 0, 0, 0, mixHash(salt(token.op))});
+    }
+    else if (token.op == Opcode::NOT) {
+      const uint32_t operand = stack.back();
+      if (nodes[operand].op == Opcode::NOT) {
+        stack.back() = nodes[operand].a;   // NOT NOT x → x
+        continue;
+      }
+      nodes.push_back({Opcode::NOT, operand, 0, 0, mixHash(nodes[operand].hash ^ salt(Opcode::NOT))});
+      stack.back() = id;
+      continue;
+    }
+    else {
+      const uint32_t b = stack.back();
+      stack.pop_back();
+      const uint32_t a = stack.back();
+      stack.pop_back();
+      auto part = [&](uint32_t operand) {
+        const Canonical_Node& node = nodes[operand];
+        return (isAssociative(token.op) && node.op == token.op) ? node.sum : mixHash(node.hash);
+      };
+      const uint64_t sum = part(a) + part(b);
+      nodes.push_back({token.op, a, b, sum, mixHash(sum ^ salt(token.op))});
+    }
+    stack.push_back(id);
+  }
+
+  // Write the text from the root; a work item is a node, or NONE with a
+  // character to append
+  struct Work {
+    uint32_t node;
+    char text;
+  };
+  string text;
+  vector<Work> work = {{stack.back(), 0}};
+  vector<uint32_t> operands, chain;
+
+  while (!work.empty()) {
+    const Work item = work.back();
+    work.pop_back();
+    if (item.node == NONE) {
+      text += item.text;
+      continue;
+    }
+
+    const Canonical_Node& node = nodes[item.node];
+    if (node.op == Opcode::VAR) {
+      text += names[node.a];
+      continue;
+    }
+    text += Expression_DAG::opcodeName(node.op);
+    if (Expression_DAG::operandCount(node.op) == 0) {
+      continue;
+    }
+    text += '(';
+    work.push_back({NONE, ')'});
+    if (node.op == Opcode::NOT) {
+      work.push_back({node.a, 0});
+      continue;
+    }
+
+    // Operands of the whole chain, in hash order
+    operands.clear();
+    chain.assign({node.a, node.b});
+    while (!chain.empty()) {
+      const uint32_t operand = chain.back();
+      chain.pop_back();
+      if (isAssociative(node.op) && nodes[operand].op == node.op) {
+        chain.push_back(nodes[operand].a);
+        chain.push_back(nodes[operand].b);
+      }
+      else {
+        operands.push_back(operand);
+      }
+    }
+    sort(operands.begin(), operands.end(), [&](uint32_t x, uint32_t y) { return nodes[x].hash < nodes[y].hash; });
+
+    for (size_t i = operands.size(); i-- > 0; ) {
+      work.push_back({operands[i], 0});
+      if (i > 0) {
+        work.push_back({NONE, ','});
+      }
+    }
+  }
+  return text;
+}
+
 /**
  * @brief Original, unmodified user expression (for display/backreference)
  */
 string Boolean_Expression:: getOriginalExpression() const{
-  return original_expression;
+  return string(original_expression);
 }
@@ -4,8 +4,17 @@
  *
  * Responsible for:
  *  - Splitting user input into tokens (variables and operators)
- *  - Converting infix expressions to postfix form (for safe evaluation)
+ *    Variables are any identifier that is not a keyword (A, req_valid, x17);
+ *    TRUE and FALSE are constants
+ *    Tokens point into the original string; nothing is copied (Tokenizer)
+ *  - Converting infix expressions to postfix form (for safe evaluation);
+ *    syntax errors are thrown as Parse_Error with their position
  *  - Evaluating postfix expressions with step-by-step tracking
+ *
+ * The source text, tokens, variable names, operator list and postfix
+ * output are allocated from one memory resource. By default that is the
+ * heap; Expression_Arena passes a monotonic arena instead, so a whole
+ * batch of expressions is freed at once.
  */
 
 #ifndef BOOLEAN_EXPRESSION_H
@@ -15,19 +24,28 @@
 #include <map>
 #include <vector>
 #include <memory>
+#include <memory_resource>
+#include <string_view>
 #include "Boolean_Operator.h"
+#include "Compiled_Program.h"
+#include "Tokenizer.h"
 
 using namespace std;
 
 class Boolean_Expression {
 private:
-  string original_expression;           // Variable to store original user input
-  vector<string> expression_parts;      // Variable to store splited parts of expression (symbols)
-  std::vector<std::unique_ptr<Boolean_Operator>> operators_found; // Variable to store detected operators
+  pmr::memory_resource* resource;       // where every buffer below comes from
+  pmr::string original_expression;      // Variable to store original user input
+  Tokenizer tokenizer;                  // tokens of original_expression (views into it)
+  pmr::vector<const Boolean_Operator*> operators_found; // Variable to store detected operators (shared instances)
 
 public:
   // Constructor
-  explicit Boolean_Expression(const string& expr);
+  explicit Boolean_Expression(const string& expr, pmr::memory_resource* resource = pmr::get_default_resource());
+
+  // Tokens refer to original_expression by position, so the object stays put
+  Boolean_Expression(const Boolean_Expression&) = delete;
+  Boolean_Expression& operator=(const Boolean_Expression&) = delete;
 
   // Break expression into words
   void splitExpression();
@@ -35,15 +53,51 @@ public:
   // Identify all boolean Operators used
   void findOperators();
 
-  // Convert infix into postfix
+  // Convert infix into postfix (token records / token strings);
+  // throws Parse_Error on a syntax error
+  pmr::vector<Token> postfixTokens() const;
   vector<string> convertToPostfix();
 
-  // Evaluate postfix with steps
+  // Evaluate postfix with steps for one row (compiles on every call;
+  // use compile() + Compiled_Program::evaluate() for many rows)
   pair<std::vector<std::pair<std::string, bool>>, bool>
-  evaluateWithSteps(const std::vector<std::string>& postfix, const std::map<char, bool>& input_values);
+  evaluateWithSteps(const std::vector<std::string>& postfix, const std::map<std::string, bool>& input_values);
+
+  // Compile postfix into opcodes and step labels; variables[i] becomes input slot i.
+  // With simplify, the steps are those of the simplified expression.
+  Compiled_Program compile(const vector<string>& variables, bool simplify = false);
+
+  // Intern the expression into dag (its variables name the input slots);
+  // returns the root node. Unlike compile() this builds no labels, so it
+  // suits very large expressions (see Tseitin_Encoder). With simplify,
+  // only the Expression_Simplifier's output is added to dag.
+  Expression_DAG::Node_Id buildGraph(Expression_DAG& dag, bool simplify = false) const;
+
+  // The expression after Expression_Simplifier, as text ("A AND NOT B")
+  string getSimplifiedExpression() const;
+
+  // Normalized text that is equal for spellings of the same expression
+  // which differ only in spacing, parentheses, operand order or grouping
+  // of AND / OR / XOR chains: "(B OR A) AND C" → "AND(C,OR(A,B))" (operands
+  // in hash order). Key of Expression_Cache; throws Parse_Error.
+  string getCanonicalForm() const;
+
+  // True if token is a variable name: letter or '_' first, then letters,
+  // digits or '_', and not an operator keyword
+  static bool isVariable(const string& token);
+
+  // Tokens in source order, and the distinct variable names (by var_id)
+  const pmr::vector<Token>& getTokens() const;
+  const pmr::vector<string_view>& getVariableNames() const;
+
+  // Source text of a token
+  string_view tokenText(const Token& token) const;
+
+  // Return list of operators (one per occurrence)
+  const pmr::vector<const Boolean_Operator*>& getOperators() const;
 
-  // Return list of operators
-  const std::vector<std::unique_ptr<Boolean_Operator>>& getOperators() const;
+  // The resource this expression allocates from
+  pmr::memory_resource* getResource() const;
 
 
   // Get the original expression string
@@ -0,0 +1,134 @@
+/**
+ * @class Bounded_Queue
+ * @brief Fixed-capacity lock-free multi-producer / multi-consumer queue.
+ *
+ * Dmitry Vyukov's bounded MPMC design: a ring of cells, each with a
+ * sequence number that says whose turn the cell is.
+ *  - A producer may write cell i when sequence == position
+ *  - A consumer may read it when sequence == position + 1
+ * Producers and consumers only contend on their own position counter
+ * (one compare-and-swap per operation); no mutex is ever taken.
+ *
+ * push() / pop() wait by spinning and then yielding, so a full or empty
+ * queue also acts as back-pressure between pipeline stages.
+ */
+
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <utility>
+
+using namespace std;
+
+template <typename T>
+class Bounded_Queue {
+  private:
+    struct Cell {
+      atomic<size_t> sequence;
+      T value;
+    };
+
+    unique_ptr<Cell[]> cells;
+    size_t mask;
+
+    // Separate cache lines, so producers and consumers do not share one
+    alignas(64) atomic<size_t> enqueue_position;
+    alignas(64) atomic<size_t> dequeue_position;
+
+    // Back off while a queue is full or empty
+    static void pause(unsigned& attempts) {
+      if (++attempts > 64) {
+        this_thread::yield();
+      }
+    }
+
+  public:
+    // capacity is rounded up to a power of two (at least 2)
+    explicit Bounded_Queue(size_t capacity) : enqueue_position(0), dequeue_position(0) {
+      size_t size = 2;
+      while (size < capacity) {
+        size *= 2;
+      }
+      cells.reset(new Cell[size]);
+      mask = size - 1;
+      for (size_t i = 0; i < size; ++i) {
+        cells[i].sequence.store(i, memory_order_relaxed);
+      }
+    }
+
+    Bounded_Queue(const Bounded_Queue&) = delete;
+    Bounded_Queue& operator=(const Bounded_Queue&) = delete;
+
+    // Move value in if there is room; false if the queue is full
+    bool tryPush(T& value) {
+      size_t position = enqueue_position.load(memory_order_relaxed);
+      while (true) {
+        Cell& cell = cells[position & mask];
+        const size_t sequence = cell.sequence.load(memory_order_acquire);
+        const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+        if (difference == 0) {
+          if (enqueue_position.compare_exchange_weak(position, position + 1, memory_order_relaxed)) {
+            cell.value = move(value);
+            cell.sequence.store(position + 1, memory_order_release);
+            return true;
+          }
+        }
+        else if (difference < 0) {
+          return false;   // a whole lap behind: full
+        }
+        else {
+          position = enqueue_position.load(memory_order_relaxed);
+        }
+      }
+    }
+
+    // Move the oldest value out; false if the queue is empty
+    bool tryPop(T& value) {
+      size_t position = dequeue_position.load(memory_order_relaxed);
+      while (true) {
+        Cell& cell = cells[position & mask];
+        const size_t sequence = cell.sequence.load(memory_order_acquire);
+        const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+
+        if (difference == 0) {
+          if (dequeue_position.compare_exchange_weak(position, position + 1, memory_order_relaxed)) {
+            value = move(cell.value);
+            cell.sequence.store(position + mask + 1, memory_order_release);
+            return true;
+          }
+        }
+        else if (difference < 0) {
+          return false;   // not written yet: empty
+        }
+        else {
+          position = dequeue_position.load(memory_order_relaxed);
+        }
+      }
+    }
+
+    // Wait until there is room, then push
+    void push(T value) {
+      unsigned attempts = 0;
+      while (!tryPush(value)) {
+        pause(attempts);
+      }
+    }
+
+    // Wait until a value is available, then pop it
+    T pop() {
+      T value;
+      unsigned attempts = 0;
+      while (!tryPop(value)) {
+        pause(attempts);
+      }
+      return value;
+    }
+};
+
+#endif //BOUNDED_QUEUE_H
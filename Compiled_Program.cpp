@@ -0,0 +1,227 @@
+/**
+ * @file Compiled_Program.cpp
+ * @brief Compiles an expression graph into register instructions and
+ * evaluates them per row.
+ *
+ * Example (variables A, B, C → values 0, 1, 2):
+ *   (A AND B) OR ((A AND B) XOR C)
+ *   → 3 = 0 AND 1, 4 = 3 XOR 2, 5 = 3 OR 4
+ */
+
+#include "Compiled_Program.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+using namespace std;
+
+// Keep the start and end of an over-long label: "((((x0 AND x1) ... x9) OR x3)"
+static void shortenLabel(string& label) {
+  constexpr size_t KEEP = (Compiled_Program::MAX_LABEL_BYTES - 5) / 2;
+  if (label.size() > Compiled_Program::MAX_LABEL_BYTES) {
+    label = label.substr(0, KEEP) + " ... " + label.substr(label.size() - KEEP);
+  }
+}
+
+Compiled_Program Compiled_Program::compile(const vector<string>& postfix, const vector<string>& variables) {
+  Expression_DAG dag(variables);
+  const Expression_DAG::Node_Id root = dag.build(postfix);
+  return compile(dag, root);
+}
+
+Compiled_Program Compiled_Program::compile(const Expression_DAG& dag, Expression_DAG::Node_Id root) {
+  return compile(dag, vector<Expression_DAG::Node_Id>{root});
+}
+
+/**
+ * @brief Number the nodes reachable from the roots and emit one
+ * instruction each.
+ *
+ * Node ids are already a topological order, so a single descending pass
+ * marks what the roots use and an ascending pass emits it. A node used by
+ * several roots is emitted once. Each label is built from its operands'
+ * labels once, when its node is emitted, and shortened to at most
+ * MAX_LABEL_BYTES, so building it costs O(MAX_LABEL_BYTES).
+ */
+Compiled_Program Compiled_Program::compile(const Expression_DAG& dag, const vector<Expression_DAG::Node_Id>& roots) {
+  Compiled_Program program;
+  program.variables = dag.getVariables();
+  const uint32_t n = static_cast<uint32_t>(program.variables.size());
+  if (roots.empty()) {
+    throw invalid_argument("Nothing to compile: no roots");
+  }
+  const Expression_DAG::Node_Id last = *max_element(roots.begin(), roots.end());
+
+  // Nodes the roots depend on
+  vector<bool> used(last + 1, false);
+  for (Expression_DAG::Node_Id root : roots) {
+    used[root] = true;
+  }
+  for (uint32_t id = last + 1; id-- > n; ) {
+    if (!used[id]) continue;
+    const Expression_DAG::Node& node = dag.getNode(id);
+    const unsigned operands = Expression_DAG::operandCount(node.op);
+    if (operands >= 1) used[node.a] = true;
+    if (operands == 2) used[node.b] = true;
+  }
+
+  // Node id → value index, and the label of each value
+  vector<uint32_t> value(last + 1, 0);
+  vector<string> labels(program.variables);
+  for (uint32_t slot = 0; slot < n && slot <= last; ++slot) {
+    value[slot] = slot;
+  }
+
+  for (uint32_t id = n; id <= last; ++id) {
+    if (!used[id]) continue;
+    const Expression_DAG::Node& node = dag.getNode(id);
+    const unsigned operands = Expression_DAG::operandCount(node.op);
+    const uint32_t a = operands >= 1 ? value[node.a] : 0;
+    const uint32_t b = operands == 2 ? value[node.b] : a;
+
+    value[id] = n + static_cast<uint32_t>(program.code.size());
+    program.code.push_back({node.op, a, b});
+
+    // "TRUE", "NOT a" or "(a OP b)"
+    if (operands == 0) {
+      labels.push_back(Expression_DAG::opcodeName(node.op));
+    }
+    else if (node.op == Opcode::NOT) {
+      labels.push_back("NOT " + labels[a]);
+    }
+    else {
+      labels.push_back("(" + labels[a] + " " + Expression_DAG::opcodeName(node.op) + " " + labels[b] + ")");
+    }
+    shortenLabel(labels.back());
+  }
+
+  for (Expression_DAG::Node_Id root : roots) {
+    program.outputs.push_back(value[root]);
+  }
+  program.result = program.outputs.back();
+  program.result_label = labels[program.result];
+  program.step_labels.assign(make_move_iterator(labels.begin() + n), make_move_iterator(labels.end()));
+  return program;
+}
+
+/**
+ * @brief Run the program for one input row.
+ * Operands below n are inputs, the rest are earlier steps of this row.
+ */
+bool Compiled_Program::evaluate(const bool* inputs, bool* steps) const {
+  const uint32_t n = static_cast<uint32_t>(variables.size());
+  auto value = [&](uint32_t index) { return index < n ? inputs[index] : steps[index - n]; };
+
+  bool* out = steps;
+  for (const Instruction& ins : code) {
+    // Constants read no operand (with no variables, value 0 is this very step)
+    if (Expression_DAG::operandCount(ins.op) == 0) {
+      *out++ = ins.op == Opcode::CONST_TRUE;
+      continue;
+    }
+    const bool a = value(ins.a);
+    const bool b = value(ins.b);
+
+    switch (ins.op) {
+      case Opcode::NOT:  *out = !a; break;
+      case Opcode::AND:  *out = a && b; break;
+      case Opcode::OR:   *out = a || b; break;
+      case Opcode::XOR:  *out = a != b; break;
+      case Opcode::NAND: *out = !(a && b); break;
+      case Opcode::NOR:  *out = !(a || b); break;
+      default:           *out = false; break;
+    }
+    ++out;
+  }
+
+  return value(result);
+}
+
+/**
+ * @brief The label of a value without shortening, rebuilt from the
+ * instructions: the same "NOT a" / "(a OP b)" text compile() starts from.
+ * Walks with an explicit stack, so deep chains do not recurse; a shared
+ * value is written out at each of its uses, as in the labels.
+ */
+string Compiled_Program::fullLabel(uint32_t index) const {
+  struct Frame {
+    uint32_t index;
+    uint8_t stage;      // 0: before the first operand, 1: between operands, 2: done
+  };
+  const uint32_t n = static_cast<uint32_t>(variables.size());
+
+  string text;
+  vector<Frame> stack;
+  stack.push_back({index, 0});
+
+  while (!stack.empty()) {
+    Frame& frame = stack.back();
+    if (frame.index < n) {
+      text += variables[frame.index];
+      stack.pop_back();
+      continue;
+    }
+    const Instruction& ins = code[frame.index - n];
+
+    if (Expression_DAG::operandCount(ins.op) == 0) {
+      text += Expression_DAG::opcodeName(ins.op);
+      stack.pop_back();
+    }
+    else if (ins.op == Opcode::NOT) {
+      if (frame.stage == 0) {
+        frame.stage = 2;
+        text += "NOT ";
+        stack.push_back({ins.a, 0});
+      }
+      else {
+        stack.pop_back();
+      }
+    }
+    else if (frame.stage == 0) {
+      frame.stage = 1;
+      text += '(';
+      stack.push_back({ins.a, 0});
+    }
+    else if (frame.stage == 1) {
+      frame.stage = 2;
+      text += ' ';
+      text += Expression_DAG::opcodeName(ins.op);
+      text += ' ';
+      stack.push_back({ins.b, 0});
+    }
+    else {
+      text += ')';
+      stack.pop_back();
+    }
+  }
+  return text;
+}
+
+const vector<Instruction>& Compiled_Program::getCode() const {
+  return code;
+}
+
+const vector<string>& Compiled_Program::getVariables() const {
+  return variables;
+}
+
+const vector<string>& Compiled_Program::getStepLabels() const {
+  return step_labels;
+}
+
+const string& Compiled_Program::getResultLabel() const {
+  return result_label;
+}
+
+size_t Compiled_Program::getStepCount() const {
+  return code.size();
+}
+
+uint32_t Compiled_Program::getResultIndex() const {
+  return result;
+}
+
+const vector<uint32_t>& Compiled_Program::getOutputIndices() const {
+  return outputs;
+}
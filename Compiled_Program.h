@@ -0,0 +1,82 @@
+/**
+ * @class Compiled_Program
+ * @brief Flat, integer-coded form of a Boolean expression.
+ *
+ * convertToPostfix() produces string tokens. Compiling them once turns the
+ * expression into an Expression_DAG (so repeated subexpressions appear
+ * once) and then into a list of register instructions: values 0 .. n-1 are
+ * the variables, and instruction k writes value n + k from two earlier
+ * values. The per-row evaluator never compares strings or searches a map.
+ *
+ * The program is also the expression's evaluation plan: the step labels
+ * ("NOT C", "(A AND B)", ...) are built here once, so evaluating a row
+ * only writes values into a buffer the caller owns. A label longer than
+ * MAX_LABEL_BYTES keeps its start and end around " ... ", so a chain
+ * nested thousands of levels deep costs linear, not quadratic, memory.
+ * These labels are for display; fullLabel() rebuilds the whole text.
+ */
+
+#ifndef COMPILED_PROGRAM_H
+#define COMPILED_PROGRAM_H
+
+#include "Expression_DAG.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// One step: values[n + k] = op(values[a], values[b])
+struct Instruction {
+  Opcode op;
+  uint32_t a;   // value index of the first operand (0 for constants)
+  uint32_t b;   // value index of the second operand (unused for NOT and constants)
+};
+
+class Compiled_Program {
+  public:
+    // Longest step label kept whole
+    static constexpr size_t MAX_LABEL_BYTES = 128;
+
+  private:
+    vector<Instruction> code;
+    vector<string> variables;   // slot index → variable name
+    vector<string> step_labels; // one label per instruction
+    string result_label;        // label of the final value (last step, or the lone variable)
+    uint32_t result = 0;        // value index of the result
+    vector<uint32_t> outputs;   // value index of each root (just the result for one root)
+
+  public:
+    // Translate postfix tokens into instructions; variables[i] becomes slot i.
+    // Equal subexpressions are compiled (and labelled) once.
+    static Compiled_Program compile(const vector<string>& postfix, const vector<string>& variables);
+
+    // Compile the subgraph reachable from root, in node order
+    static Compiled_Program compile(const Expression_DAG& dag, Expression_DAG::Node_Id root);
+
+    // Compile the subgraph reachable from any of the roots, each shared
+    // node once; the result is the last root (see getOutputIndices())
+    static Compiled_Program compile(const Expression_DAG& dag, const vector<Expression_DAG::Node_Id>& roots);
+
+    // Evaluate one row. inputs[i] is the value of slot i; steps receives
+    // one value per instruction (getStepCount() entries). Never allocates.
+    bool evaluate(const bool* inputs, bool* steps) const;
+
+    const vector<Instruction>& getCode() const;
+    const vector<string>& getVariables() const;
+    const vector<string>& getStepLabels() const;
+    const string& getResultLabel() const;
+
+    // Label of a value (variable slot or n + step) at full length, for
+    // files that must record the whole expression; O(text length)
+    string fullLabel(uint32_t index) const;
+    size_t getStepCount() const;
+
+    // Value index of the result (a variable slot, or n + step)
+    uint32_t getResultIndex() const;
+
+    // Value index of every root, in the order they were compiled
+    const vector<uint32_t>& getOutputIndices() const;
+};
+
+#endif //COMPILED_PROGRAM_H
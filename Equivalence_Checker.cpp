@@ -0,0 +1,190 @@
+/**
+ * @file Equivalence_Checker.cpp
+ * @brief Structural, simulated and exact comparison of two expressions.
+ *
+ * The miter is one extra XOR node over both roots: it is 1 exactly on the
+ * rows where the expressions differ, so "equivalent" is "the miter is never
+ * 1" and every stage looks for a 1 in it.
+ *
+ * Example: A AND (B OR C)  vs  (A AND B) OR C
+ *   miter = (A AND (B OR C)) XOR ((A AND B) OR C)
+ *   random vectors soon hit A=0, C=1 → counterexample A=0 B=0 C=1
+ */
+
+#include "Equivalence_Checker.h"
+#include "BDD_Manager.h"
+#include "Bitslice_Evaluator.h"
+#include "Run_Stats.h"
+#include "SAT_Solver.h"
+#include "Truth_Table.h"
+#include "Tseitin_Encoder.h"
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+
+using namespace std;
+
+// splitmix64: one well-mixed 64-bit word per call, i.e. 64 random rows of one variable
+static inline uint64_t nextRandom(uint64_t& state) {
+  uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+// Index of the lowest set bit (word must be non-zero)
+static inline unsigned lowestBit(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctzll(word);
+#else
+  unsigned bit = 0;
+  while (!((word >> bit) & 1)) ++bit;
+  return bit;
+#endif
+}
+
+// Constructor : simulation budget and random seed (same seed, same vectors)
+Equivalence_Checker::Equivalence_Checker(uint64_t random_vectors, uint64_t seed)
+  : random_vectors(random_vectors), seed(seed) {
+}
+
+/**
+ * @brief Run the stages until one decides.
+ */
+Equivalence_Checker::Result Equivalence_Checker::check(Boolean_Expression& first, Boolean_Expression& second) const {
+  Result result;
+  result.variables = Truth_Table::collectVariables({&first, &second});
+  const size_t n = result.variables.size();
+
+  // 1) Structure: simplified into one graph, equal expressions often meet
+  Expression_DAG dag(result.variables);
+  const Expression_DAG::Node_Id first_root = first.buildGraph(dag, true);
+  const Expression_DAG::Node_Id second_root = second.buildGraph(dag, true);
+  if (first_root == second_root) {
+    return result;
+  }
+  const Expression_DAG::Node_Id miter = dag.makeNode(Opcode::XOR, first_root, second_root);
+
+  // Record a counterexample and both expressions' values on it
+  auto differ = [&](Method method, vector<bool> row) {
+    result.equivalent = false;
+    result.method = method;
+    result.counterexample = move(row);
+
+    const Compiled_Program program = first.compile(result.variables);
+    unique_ptr<bool[]> inputs(new bool[n + 1]);
+    unique_ptr<bool[]> steps(new bool[program.getStepCount() + 1]);
+    for (size_t slot = 0; slot < n; ++slot) {
+      inputs[slot] = result.counterexample[slot];
+    }
+    result.first_value = program.evaluate(inputs.get(), steps.get());
+    result.second_value = !result.first_value;
+    return result;
+  };
+
+  const bool enumerable = n <= ENUMERATE_MAX_VARIABLES;
+  const bool few_rows = enumerable && (1ull << n) <= random_vectors;
+
+  {
+    // Stages 2 and 3a evaluate the same compiled miter
+    const Compiled_Program program = Compiled_Program::compile(dag, miter);
+    const Bitslice_Evaluator evaluator(program);
+    const size_t words = evaluator.getBlockWords();
+    const uint64_t rows = evaluator.getBlockRows();
+    const size_t difference = program.getResultIndex() * words;
+    vector<uint64_t> buffer(evaluator.getBufferWords());
+
+    // 2) Random simulation: fill every variable vector with random bits
+    if (!few_rows) {
+      Run_Stats::Scope scope(Run_Stats::Phase::EVALUATE);
+      uint64_t state = seed;
+      for (uint64_t done = 0; done < random_vectors; done += rows) {
+        for (size_t w = 0; w < n * words; ++w) {
+          buffer[w] = nextRandom(state);
+        }
+        evaluator.evaluateVectors(buffer.data());
+        Run_Stats::add(Run_Stats::Counter::BLOCKS, 1);
+        result.simulated_vectors += rows;
+
+        for (size_t w = 0; w < words; ++w) {
+          if (buffer[difference + w] != 0) {
+            const unsigned bit = lowestBit(buffer[difference + w]);
+            vector<bool> row(n);
+            for (size_t slot = 0; slot < n; ++slot) {
+              row[slot] = (buffer[slot * words + w] >> bit) & 1;
+            }
+            return differ(Method::SIMULATION, move(row));
+          }
+        }
+      }
+    }
+
+    // 3a) Every row. With fewer rows than a block, the rows past 2^n repeat
+    // the first ones, so the lowest differing row is always a real one.
+    if (enumerable) {
+      const uint64_t block_count = max<uint64_t>(1, (1ull << n) / rows);
+      uint64_t first_row = UINT64_MAX;
+      evaluator.forEachBlock(0, block_count, buffer.data(), [&](uint64_t block, const uint64_t* values) {
+        for (size_t w = 0; w < words; ++w) {
+          if (values[difference + w] != 0) {
+            first_row = min(first_row, block * rows + 64 * w + lowestBit(values[difference + w]));
+            break;
+          }
+        }
+      });
+
+      if (first_row == UINT64_MAX) {
+        result.method = Method::ENUMERATION;
+        return result;
+      }
+      vector<bool> row(n);
+      for (size_t slot = 0; slot < n; ++slot) {
+        row[slot] = (first_row >> (n - slot - 1)) & 1;
+      }
+      return differ(Method::ENUMERATION, move(row));
+    }
+  }
+
+  // 3b) BDDs over the same order: equal functions are the same node
+  try {
+    BDD_Manager bdd(result.variables);
+    bdd.setNodeLimit(BDD_NODE_LIMIT);
+    const BDD_Manager::Node f = bdd.build(first.convertToPostfix());
+    const BDD_Manager::Node g = bdd.build(second.convertToPostfix());
+    if (bdd.equivalent(f, g)) {
+      result.method = Method::BDD;
+      return result;
+    }
+    vector<bool> row;
+    bdd.anySatisfying(bdd.apply_xor(f, g), row);
+    return differ(Method::BDD, move(row));
+  }
+  catch (const length_error&) {
+    // Too large a diagram: the SAT solver below does not need one
+  }
+
+  // 3c) SAT on the miter: satisfiable exactly when the expressions differ
+  const Tseitin_Encoder cnf(dag, miter);
+  SAT_Solver solver;
+  cnf.addTo(solver);
+  if (solver.solve() != SAT_Solver::Result::SATISFIABLE) {
+    result.method = Method::SAT;
+    return result;
+  }
+  vector<bool> row(n);
+  for (size_t slot = 0; slot < n; ++slot) {
+    row[slot] = solver.getModelValue(static_cast<int>(slot + 1));
+  }
+  return differ(Method::SAT, move(row));
+}
+
+string Equivalence_Checker::methodName(Method method) {
+  switch (method) {
+    case Method::STRUCTURE:   return "structure";
+    case Method::SIMULATION:  return "simulation";
+    case Method::ENUMERATION: return "enumeration";
+    case Method::BDD:         return "bdd";
+    default:                  return "sat";
+  }
+}
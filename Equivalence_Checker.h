@@ -0,0 +1,70 @@
+/**
+ * @class Equivalence_Checker
+ * @brief Decides whether two expressions have the same truth table, and
+ * finds a row where they differ if not.
+ *
+ * Stages, cheapest first:
+ *  1) Structure: both expressions are simplified into one Expression_DAG;
+ *     if they end up as the same node they are equivalent
+ *  2) Random simulation: the miter (first XOR second) is evaluated
+ *     bit-parallel on random input vectors; any 1 is a counterexample.
+ *     Most differences show up in the first block.
+ *  3) Exact: every row (Bitslice_Evaluator, up to ENUMERATE_MAX_VARIABLES),
+ *     else both BDDs in one manager (canonical, so equal functions are the
+ *     same node), else, if the BDD grows past BDD_NODE_LIMIT, the miter on
+ *     the SAT solver (UNSAT means equivalent)
+ *
+ * When 2^n rows are no more than the simulation budget, stage 2 is
+ * skipped: enumerating every row costs the same and is exact.
+ *
+ * Variables are the union of both expressions', in Truth_Table order, so
+ * a counterexample can be read like a table row.
+ */
+
+#ifndef EQUIVALENCE_CHECKER_H
+#define EQUIVALENCE_CHECKER_H
+
+#include "Boolean_Expression.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class Equivalence_Checker {
+  public:
+    enum class Method { STRUCTURE, SIMULATION, ENUMERATION, BDD, SAT };
+
+    struct Result {
+      bool equivalent = true;
+      Method method = Method::STRUCTURE;   // stage that decided
+      vector<string> variables;            // union of both expressions' variables
+      vector<bool> counterexample;         // one value per variable (empty when equivalent)
+      bool first_value = false;            // the expressions' values on the counterexample
+      bool second_value = false;
+      uint64_t simulated_vectors = 0;      // random input vectors evaluated in stage 2
+    };
+
+    // Random vectors per check before the exact stage
+    static constexpr uint64_t DEFAULT_RANDOM_VECTORS = 1 << 20;
+
+    // Enumerate every row up to this many variables (16M rows)
+    static constexpr size_t ENUMERATE_MAX_VARIABLES = 24;
+
+    // BDD size at which the exact stage switches to the SAT solver
+    static constexpr size_t BDD_NODE_LIMIT = 1 << 22;
+
+  private:
+    uint64_t random_vectors;
+    uint64_t seed;
+
+  public:
+    explicit Equivalence_Checker(uint64_t random_vectors = DEFAULT_RANDOM_VECTORS, uint64_t seed = 1);
+
+    // Compare two parsed expressions; throws Parse_Error on a syntax error
+    Result check(Boolean_Expression& first, Boolean_Expression& second) const;
+
+    static string methodName(Method method);
+};
+
+#endif //EQUIVALENCE_CHECKER_H
@@ -0,0 +1,622 @@
+/**
+ * @file Evaluation_Server.cpp
+ * @brief Event loop, worker pool and request handlers of --serve.
+ *
+ * Ownership: the loop thread owns the sockets and the connection table;
+ * a worker holds a shared_ptr to the connection it serves and touches only
+ * the fields under Connection::lock. Workers never call into the socket:
+ * they append frames and post the connection id as a notice, and the loop
+ * sends. When a peer disappears the loop marks the connection closed, and
+ * the worker's next sendFrame() abandons the request.
+ *
+ * Example session (">" request, "<" response frames):
+ *   > count \n A AND (B OR C)             < E "3	8	satisfiable"
+ *   > table \n A XOR B \n csv             < D header  D rows ...  E ""
+ *   > evaluate \n A AND B \n A=1 B=0      < E "0\n(A AND B)	0\n"
+ */
+
+#include "Evaluation_Server.h"
+#include "BDD_Manager.h"
+#include "Boolean_Expression.h"
+#include "Equivalence_Checker.h"
+#include "Ordered_Chunk_Writer.h"
+#include "Truth_Table.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <cerrno>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// Constructor : size the pool and the cache; nothing is opened until run()
+Evaluation_Server::Evaluation_Server(const string& socket_path, unsigned threads, size_t cache_bytes)
+  : socket_path(socket_path), thread_count(Ordered_Chunk_Writer::resolveThreads(threads)),
+    cache(cache_bytes), stopping(false), requests_served(0) {
+#ifdef __linux__
+  // Created here so stop() works even before run() starts
+  wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+#endif
+}
+
+Evaluation_Server::~Evaluation_Server() {
+#ifdef __linux__
+  if (wake_fd >= 0) {
+    close(wake_fd);
+  }
+#endif
+}
+
+uint64_t Evaluation_Server::getRequestsServed() const {
+  return requests_served.load(memory_order_relaxed);
+}
+
+Expression_Cache::Statistics Evaluation_Server::getCacheStatistics() const {
+  return cache.getStatistics();
+}
+
+#ifndef __linux__
+
+void Evaluation_Server::run() {
+  throw runtime_error("--serve needs Linux (epoll and Unix domain sockets)");
+}
+
+void Evaluation_Server::stop() {
+  stopping.store(true);
+}
+
+#else
+
+// epoll tags of the two non-client descriptors; clients use their id (>= 2)
+static constexpr uint64_t LISTEN_TAG = 0;
+static constexpr uint64_t WAKE_TAG = 1;
+
+// Thrown inside a worker when its client has gone; not an error to report
+struct Client_Gone {};
+
+static void putLength(string& out, uint32_t length) {
+  for (int shift = 0; shift < 32; shift += 8) {
+    out += static_cast<char>((length >> shift) & 0xFF);
+  }
+}
+
+static uint32_t getLength(const char* bytes) {
+  uint32_t length = 0;
+  for (int i = 3; i >= 0; --i) {
+    length = (length << 8) | static_cast<unsigned char>(bytes[i]);
+  }
+  return length;
+}
+
+static runtime_error systemError(const string& what) {
+  return runtime_error(what + ": " + strerror(errno));
+}
+
+/**
+ * @brief Serve until stop(): open the socket, start the workers, and
+ * dispatch epoll events. Everything is torn down on the way out, also
+ * when an exception leaves the loop.
+ */
+void Evaluation_Server::run() {
+  if (wake_fd < 0) {
+    throw systemError("eventfd");
+  }
+  try {
+    openSocket();
+    for (unsigned i = 0; i < thread_count; ++i) {
+      workers.emplace_back(&Evaluation_Server::workerLoop, this);
+    }
+
+    epoll_event events[64];
+    while (!stopping.load()) {
+      const int count = epoll_wait(epoll_fd, events, 64, -1);
+      if (count < 0) {
+        if (errno == EINTR) continue;
+        throw systemError("epoll_wait");
+      }
+
+      for (int i = 0; i < count; ++i) {
+        const uint64_t tag = events[i].data.u64;
+        if (tag == LISTEN_TAG) {
+          acceptClients();
+        }
+        else if (tag == WAKE_TAG) {
+          uint64_t value;
+          while (read(wake_fd, &value, sizeof(value)) > 0) {
+          }
+          handleNotices();
+        }
+        else {
+          auto found = connections.find(tag);
+          if (found == connections.end()) {
+            continue;   // dropped earlier in this batch
+          }
+          const shared_ptr<Connection> connection = found->second;
+          if (events[i].events & (EPOLLHUP | EPOLLERR)) {
+            dropClient(connection);   // both directions gone: nothing can be delivered
+            continue;
+          }
+          if (events[i].events & EPOLLIN) {
+            readClient(connection);
+          }
+          if ((events[i].events & EPOLLOUT) && connections.count(tag)) {
+            flushClient(connection);
+          }
+        }
+      }
+    }
+  }
+  catch (...) {
+    closeAll();
+    throw;
+  }
+  closeAll();
+}
+
+// Safe in a signal handler: an atomic store and a write()
+void Evaluation_Server::stop() {
+  stopping.store(true);
+  wake();
+}
+
+/**
+ * @brief Bind and listen. A socket file nobody listens on (left by an
+ * earlier run) is replaced; a live server's socket or any other file at
+ * the path is an error.
+ */
+void Evaluation_Server::openSocket() {
+  sockaddr_un address = {};
+  address.sun_family = AF_UNIX;
+  if (socket_path.empty() || socket_path.size() >= sizeof(address.sun_path)) {
+    throw runtime_error("Socket path must be 1 to " + to_string(sizeof(address.sun_path) - 1) + " bytes");
+  }
+  memcpy(address.sun_path, socket_path.c_str(), socket_path.size() + 1);
+
+  struct stat existing;
+  if (stat(socket_path.c_str(), &existing) == 0) {
+    if (!S_ISSOCK(existing.st_mode)) {
+      throw runtime_error(socket_path + " exists and is not a socket");
+    }
+    const int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    const bool live = probe >= 0 && connect(probe, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+    if (probe >= 0) close(probe);
+    if (live) {
+      throw runtime_error("Another server is listening on " + socket_path);
+    }
+    unlink(socket_path.c_str());
+  }
+
+  const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (fd < 0) {
+    throw systemError("socket");
+  }
+  if (bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0) {
+    const runtime_error error = systemError("bind " + socket_path);
+    close(fd);
+    throw error;
+  }
+  listen_fd = fd;   // from here on closeAll() removes the socket file
+  if (listen(listen_fd, SOMAXCONN) < 0) {
+    throw systemError("listen");
+  }
+
+  epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if (epoll_fd < 0) {
+    throw systemError("epoll_create1");
+  }
+  epoll_event event = {};
+  event.events = EPOLLIN;
+  event.data.u64 = LISTEN_TAG;
+  epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &event);
+  event.data.u64 = WAKE_TAG;
+  epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &event);
+}
+
+/**
+ * @brief Stop the workers (abandoning their requests), close every
+ * descriptor and remove the socket file.
+ */
+void Evaluation_Server::closeAll() {
+  for (auto& entry : connections) {
+    Connection& connection = *entry.second;
+    {
+      lock_guard<mutex> guard(connection.lock);
+      connection.closed = true;
+    }
+    connection.drained.notify_all();
+    close(connection.fd);
+  }
+  {
+    lock_guard<mutex> guard(task_lock);
+    tasks_closed = true;
+    tasks.clear();
+  }
+  task_ready.notify_all();
+  for (thread& worker : workers) {
+    worker.join();
+  }
+  workers.clear();
+  connections.clear();
+
+  if (epoll_fd >= 0) {
+    close(epoll_fd);
+    epoll_fd = -1;
+  }
+  if (listen_fd >= 0) {
+    close(listen_fd);
+    listen_fd = -1;
+    unlink(socket_path.c_str());
+  }
+}
+
+void Evaluation_Server::acceptClients() {
+  while (true) {
+    const int fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) {
+      if (errno == EINTR) continue;
+      return;   // EAGAIN, or out of descriptors: try again on the next event
+    }
+
+    shared_ptr<Connection> connection = make_shared<Connection>();
+    connection->fd = fd;
+    connection->id = ++next_id;
+    connection->events = EPOLLIN;
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.u64 = connection->id;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0) {
+      close(fd);
+      continue;
+    }
+    connections.emplace(connection->id, move(connection));
+  }
+}
+
+/**
+ * @brief Read what has arrived and split it into requests. A peer that
+ * has finished sending still gets the answers to what it sent.
+ */
+void Evaluation_Server::readClient(const shared_ptr<Connection>& connection) {
+  char buffer[1 << 16];
+  while (!connection->read_closed) {
+    const ssize_t received = recv(connection->fd, buffer, sizeof(buffer), 0);
+    if (received > 0) {
+      connection->input.append(buffer, static_cast<size_t>(received));
+      continue;
+    }
+    if (received == 0) {
+      connection->read_closed = true;
+    }
+    else if (errno == EINTR) {
+      continue;
+    }
+    else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+      dropClient(connection);
+      return;
+    }
+    break;
+  }
+
+  string& input = connection->input;
+  size_t position = 0;
+  while (input.size() - position >= 4) {
+    const uint32_t length = getLength(input.data() + position);
+    if (length > MAX_REQUEST_BYTES) {
+      dropClient(connection);
+      return;
+    }
+    if (input.size() - position - 4 < length) {
+      break;
+    }
+    connection->queued.push_back(input.substr(position + 4, length));
+    position += 4 + length;
+  }
+  input.erase(0, position);
+
+  dispatch(connection);
+  flushClient(connection);
+}
+
+/**
+ * @brief Send as much pending output as the socket takes, wake a worker
+ * waiting on the high-water mark, and close the connection once a peer
+ * that stopped sending has nothing left to receive.
+ */
+void Evaluation_Server::flushClient(const shared_ptr<Connection>& connection) {
+  bool pending;
+  bool failed = false;
+  {
+    lock_guard<mutex> guard(connection->lock);
+    string& output = connection->output;
+    size_t start = 0;
+    while (start < output.size()) {
+      const ssize_t sent = send(connection->fd, output.data() + start, output.size() - start, MSG_NOSIGNAL);
+      if (sent > 0) {
+        start += static_cast<size_t>(sent);
+      }
+      else if (sent < 0 && errno == EINTR) {
+        continue;
+      }
+      else {
+        failed = sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK;
+        break;
+      }
+    }
+    output.erase(0, start);
+    pending = !output.empty();
+  }
+  connection->drained.notify_all();
+
+  if (failed || (connection->read_closed && !connection->busy && connection->queued.empty() && !pending)) {
+    dropClient(connection);
+    return;
+  }
+  updateEvents(*connection, pending);
+}
+
+// Read while the peer may still send; write while output is pending
+void Evaluation_Server::updateEvents(Connection& connection, bool pending) {
+  uint32_t wanted = 0;
+  if (!connection.read_closed) wanted |= EPOLLIN;
+  if (pending) wanted |= EPOLLOUT;
+  if (wanted != connection.events) {
+    epoll_event event = {};
+    event.events = wanted;
+    event.data.u64 = connection.id;
+    epoll_ctl(epoll_fd, EPOLL_CTL_MOD, connection.fd, &event);
+    connection.events = wanted;
+  }
+}
+
+// Hand the connection's next request to the pool, one at a time
+void Evaluation_Server::dispatch(const shared_ptr<Connection>& connection) {
+  if (connection->busy || connection->queued.empty()) {
+    return;
+  }
+  connection->busy = true;
+  {
+    lock_guard<mutex> guard(task_lock);
+    tasks.push_back({connection, move(connection->queued.front())});
+  }
+  connection->queued.pop_front();
+  task_ready.notify_one();
+}
+
+void Evaluation_Server::dropClient(const shared_ptr<Connection>& connection) {
+  epoll_ctl(epoll_fd, EPOLL_CTL_DEL, connection->fd, nullptr);
+  close(connection->fd);
+  {
+    lock_guard<mutex> guard(connection->lock);
+    connection->closed = true;
+  }
+  connection->drained.notify_all();
+  connections.erase(connection->id);
+}
+
+/**
+ * @brief Act on the notices posted by workers: send new output, and start
+ * the next request of a connection whose worker has finished.
+ */
+void Evaluation_Server::handleNotices() {
+  vector<uint64_t> ids;
+  {
+    lock_guard<mutex> guard(notice_lock);
+    ids.swap(notices);
+  }
+
+  for (uint64_t id : ids) {
+    auto found = connections.find(id);
+    if (found == connections.end()) {
+      continue;
+    }
+    const shared_ptr<Connection> connection = found->second;
+    {
+      lock_guard<mutex> guard(connection->lock);
+      if (connection->finished) {
+        connection->finished = false;
+        connection->busy = false;
+      }
+    }
+    dispatch(connection);
+    flushClient(connection);
+  }
+}
+
+void Evaluation_Server::notice(uint64_t id) {
+  {
+    lock_guard<mutex> guard(notice_lock);
+    notices.push_back(id);
+  }
+  wake();
+}
+
+void Evaluation_Server::wake() {
+  const uint64_t one = 1;
+  if (wake_fd >= 0 && write(wake_fd, &one, sizeof(one)) < 0) {
+    // The counter is already non-zero: the loop will wake anyway
+  }
+}
+
+// Worker: take requests until the queue is closed
+void Evaluation_Server::workerLoop() {
+  while (true) {
+    Task task;
+    {
+      unique_lock<mutex> guard(task_lock);
+      task_ready.wait(guard, [&] { return tasks_closed || !tasks.empty(); });
+      if (tasks.empty()) {
+        return;
+      }
+      task = move(tasks.front());
+      tasks.pop_front();
+    }
+
+    try {
+      serve(*task.connection, task.request);
+    }
+    catch (const Client_Gone&) {
+      // Nobody to answer
+    }
+    requests_served.fetch_add(1, memory_order_relaxed);
+
+    {
+      lock_guard<mutex> guard(task.connection->lock);
+      task.connection->finished = true;
+    }
+    notice(task.connection->id);
+  }
+}
+
+/**
+ * @brief Append one response frame, first waiting while the client is a
+ * full high-water mark behind. Throws Client_Gone if it has disconnected.
+ */
+void Evaluation_Server::sendFrame(Connection& connection, char type, const string& payload) {
+  {
+    unique_lock<mutex> guard(connection.lock);
+    connection.drained.wait(guard, [&] {
+      return connection.closed || connection.output.size() < OUTPUT_HIGH_WATER;
+    });
+    if (connection.closed) {
+      throw Client_Gone();
+    }
+    putLength(connection.output, static_cast<uint32_t>(payload.size() + 1));
+    connection.output += type;
+    connection.output += payload;
+  }
+  notice(connection.id);
+}
+
+// Parse and syntax-check one expression of a request
+static unique_ptr<Boolean_Expression> parseExpression(const vector<string>& lines, size_t index) {
+  if (index >= lines.size() || lines[index].empty()) {
+    throw invalid_argument("Missing expression on line " + to_string(index + 1));
+  }
+  unique_ptr<Boolean_Expression> expression = make_unique<Boolean_Expression>(lines[index]);
+  expression->postfixTokens();   // throws Parse_Error
+  return expression;
+}
+
+/**
+ * @brief Run one request and answer it. Failures (bad syntax, unknown
+ * command, too many variables) become an error frame.
+ */
+void Evaluation_Server::serve(Connection& connection, const string& request) {
+  // Lines of the request, without a trailing '\r'
+  vector<string> lines;
+  size_t start = 0;
+  while (start <= request.size()) {
+    size_t end = request.find('\n', start);
+    if (end == string::npos) end = request.size();
+    string line = request.substr(start, end - start);
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    lines.push_back(move(line));
+    start = end + 1;
+  }
+  const string& command = lines[0];
+
+  try {
+    if (command == "evaluate") {
+      unique_ptr<Boolean_Expression> expression = parseExpression(lines, 1);
+      Truth_Table table(*expression, false, &cache);
+      const Compiled_Program& program = table.getProgram();
+      const vector<string>& variables = table.getVariables();
+
+      // NAME=0|1, separated by spaces or commas
+      unique_ptr<bool[]> inputs(new bool[variables.size() + 1]);
+      vector<bool> given(variables.size(), false);
+      const string assignments = lines.size() > 2 ? lines[2] : "";
+      size_t position = 0;
+      while (position < assignments.size()) {
+        const size_t end = min(assignments.find_first_of(" \t,", position), assignments.size());
+        const string item = assignments.substr(position, end - position);
+        position = end + 1;
+        if (item.empty()) continue;
+
+        const size_t equals = item.find('=');
+        const string value = equals == string::npos ? "" : item.substr(equals + 1);
+        if (value != "0" && value != "1") {
+          throw invalid_argument("Expected NAME=0 or NAME=1, got " + item);
+        }
+        const auto slot = find(variables.begin(), variables.end(), item.substr(0, equals));
+        if (slot == variables.end()) {
+          throw invalid_argument("Unknown variable " + item.substr(0, equals));
+        }
+        inputs[slot - variables.begin()] = value == "1";
+        given[slot - variables.begin()] = true;
+      }
+      for (size_t i = 0; i < variables.size(); ++i) {
+        if (!given[i]) {
+          throw invalid_argument("No value for " + variables[i]);
+        }
+      }
+
+      unique_ptr<bool[]> steps(new bool[program.getStepCount() + 1]);
+      const bool result = program.evaluate(inputs.get(), steps.get());
+      string body = result ? "1\n" : "0\n";
+      for (size_t step = 0; step < program.getStepCount(); ++step) {
+        body += program.getStepLabels()[step] + "\t" + (steps[step] ? "1" : "0") + "\n";
+      }
+      sendFrame(connection, FRAME_END, body);
+    }
+    else if (command == "count") {
+      unique_ptr<Boolean_Expression> expression = parseExpression(lines, 1);
+      const unique_ptr<Truth_Table> table = BDD_Manager::countingTable(*expression, &cache);
+      const BDD_Manager::Row_Count count = BDD_Manager::countRows(*expression, table.get());
+      sendFrame(connection, FRAME_END, count.true_rows + "\t" + count.rows + "\t" + count.status);
+    }
+    else if (command == "table") {
+      unique_ptr<Boolean_Expression> expression = parseExpression(lines, 1);
+      Table_Options options;
+      if (lines.size() > 2 && !lines[2].empty() && !Table_Writer::parseFormat(lines[2], options.format)) {
+        throw invalid_argument("Unknown format " + lines[2]);
+      }
+      Truth_Table table(*expression, false, &cache);
+      options.sink = [&](const string& data) { sendFrame(connection, FRAME_DATA, data); };
+      table.displayTable(options);
+      sendFrame(connection, FRAME_END, "");
+    }
+    else if (command == "equiv") {
+      unique_ptr<Boolean_Expression> first = parseExpression(lines, 1);
+      unique_ptr<Boolean_Expression> second = parseExpression(lines, 2);
+      const Equivalence_Checker::Result result = Equivalence_Checker().check(*first, *second);
+
+      string body = (result.equivalent ? "equivalent\t" : "different\t") +
+                    Equivalence_Checker::methodName(result.method);
+      if (!result.equivalent) {
+        body += '\t';
+        for (size_t i = 0; i < result.variables.size(); ++i) {
+          body += (i ? " " : "") + result.variables[i] + (result.counterexample[i] ? "=1" : "=0");
+        }
+      }
+      sendFrame(connection, FRAME_END, body);
+    }
+    else if (command == "stats") {
+      const Expression_Cache::Statistics statistics = cache.getStatistics();
+      sendFrame(connection, FRAME_END,
+                "requests\t" + to_string(getRequestsServed()) + "\n" +
+                "cache_hits\t" + to_string(statistics.hits) + "\n" +
+                "cache_misses\t" + to_string(statistics.misses) + "\n" +
+                "cache_evictions\t" + to_string(statistics.evictions) + "\n" +
+                "cache_entries\t" + to_string(statistics.entries) + "\n" +
+                "cache_bytes\t" + to_string(statistics.bytes) + "\n");
+    }
+    else {
+      throw invalid_argument("Unknown command '" + command + "' (evaluate, count, table, equiv, stats)");
+    }
+  }
+  catch (const exception& error) {
+    sendFrame(connection, FRAME_ERROR, error.what());
+  }
+}
+
+#endif
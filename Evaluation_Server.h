@@ -0,0 +1,157 @@
+/**
+ * @class Evaluation_Server
+ * @brief Long-running evaluation service on a Unix domain socket (--serve).
+ *
+ * One process answers many requests, so callers pay neither the startup
+ * nor the compile cost again: compiled programs and counts stay warm in an
+ * Expression_Cache shared by every request.
+ *
+ *   epoll loop (accept, read, write) ──► task queue ──► worker pool
+ *        ▲                                                  │
+ *        └──────────── eventfd: "output is waiting" ◄───────┘
+ *
+ *  - The calling thread runs an epoll event loop: it accepts clients,
+ *    reads request frames and writes response bytes, all non-blocking
+ *  - Complete requests go to a pool of workers, which parse, compile and
+ *    evaluate, and append response frames to the connection's output
+ *  - A worker that has OUTPUT_HIGH_WATER bytes unsent waits until the loop
+ *    has drained them, so a table of any size streams through a bounded
+ *    buffer; if the client goes away, the worker stops
+ *
+ * Protocol (all integers little-endian):
+ *   request  = u32 length, then length bytes of text: lines separated by '\n'
+ *     evaluate \n EXPR \n NAME=0|1 NAME=0|1 ...  → result, then one
+ *                                                  "label<TAB>value" line per step
+ *     count    \n EXPR                  → "true_rows<TAB>rows<TAB>status"
+ *                                         (BDD_Manager::countRows(), as in Batch_Runner; "2^n" past 64 variables)
+ *     table    \n EXPR [\n FORMAT]      → the truth table (text, csv, jsonl, markdown)
+ *     equiv    \n EXPR1 \n EXPR2        → "equivalent<TAB>method" or
+ *                                         "different<TAB>method<TAB>A=0 B=1 ..."
+ *     stats                             → "name<TAB>value" lines (requests, cache)
+ *   response = one or more frames: u32 length, then length bytes holding
+ *              a type byte and a payload
+ *     'D' part of the body, more follows   'E' last part of the body
+ *     'X' error message (ends the response)
+ *
+ * A connection's requests are answered one at a time, in order; clients
+ * may send several before reading. Each connection is served by at most
+ * one worker at a time, and different connections are served in parallel.
+ *
+ * Only Linux has epoll and eventfd; elsewhere run() throws runtime_error.
+ */
+
+#ifndef EVALUATION_SERVER_H
+#define EVALUATION_SERVER_H
+
+#include "Expression_Cache.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+class Evaluation_Server {
+  public:
+    // Largest request accepted; a longer one closes the connection
+    static constexpr uint32_t MAX_REQUEST_BYTES = 16 << 20;
+
+    // Unsent response bytes per connection before a worker waits
+    static constexpr size_t OUTPUT_HIGH_WATER = 4 << 20;
+
+    // Response frame types
+    static constexpr char FRAME_DATA = 'D';
+    static constexpr char FRAME_END = 'E';
+    static constexpr char FRAME_ERROR = 'X';
+
+  private:
+    // State of one client. input and queued are the loop's alone; the
+    // rest is shared with the serving worker under lock.
+    struct Connection {
+      int fd = -1;
+      uint64_t id = 0;
+      string input;                  // bytes read, not yet split into requests
+      deque<string> queued;          // complete requests waiting for a worker
+      bool busy = false;             // a worker owns the current request
+      bool read_closed = false;      // peer finished sending; answer what is queued, then close
+      uint32_t events = 0;           // epoll events currently registered
+
+      mutex lock;
+      condition_variable drained;    // output fell below the high-water mark, or closed
+      string output;                 // frames not yet sent
+      bool finished = false;         // the worker completed its request
+      bool closed = false;           // peer gone or server stopping
+    };
+
+    struct Task {
+      shared_ptr<Connection> connection;
+      string request;
+    };
+
+    string socket_path;
+    unsigned thread_count;
+    Expression_Cache cache;
+
+    int listen_fd = -1;
+    int epoll_fd = -1;
+    int wake_fd = -1;                // eventfd: workers (and stop()) wake the loop
+    atomic<bool> stopping;
+    atomic<uint64_t> requests_served;
+
+    unordered_map<uint64_t, shared_ptr<Connection>> connections;
+    uint64_t next_id = 1;            // ids 0 and 1 tag the listening socket and the eventfd
+
+    mutex task_lock;                 // task queue: idle workers sleep instead of spinning
+    condition_variable task_ready;
+    deque<Task> tasks;
+    bool tasks_closed = false;
+
+    mutex notice_lock;               // connections with new output or a finished request
+    vector<uint64_t> notices;
+
+    vector<thread> workers;
+
+    void openSocket();
+    void closeAll();
+    void acceptClients();
+    void readClient(const shared_ptr<Connection>& connection);
+    void flushClient(const shared_ptr<Connection>& connection);
+    void updateEvents(Connection& connection, bool pending);
+    void dispatch(const shared_ptr<Connection>& connection);
+    void dropClient(const shared_ptr<Connection>& connection);
+    void handleNotices();
+    void notice(uint64_t id);
+    void wake();
+    void workerLoop();
+
+    // Worker side: serve one request, appending frames to the connection
+    void serve(Connection& connection, const string& request);
+    void sendFrame(Connection& connection, char type, const string& payload);
+
+  public:
+    // threads == 0 uses one worker per hardware thread; the cache holds
+    // compiled expressions across requests (cache_bytes may be 0)
+    Evaluation_Server(const string& socket_path, unsigned threads, size_t cache_bytes);
+    ~Evaluation_Server();
+
+    Evaluation_Server(const Evaluation_Server&) = delete;
+    Evaluation_Server& operator=(const Evaluation_Server&) = delete;
+
+    // Listen and serve until stop(); throws runtime_error if the socket
+    // cannot be set up. The socket file is removed on return.
+    void run();
+
+    // Ask run() to return; safe from a signal handler or another thread
+    void stop();
+
+    uint64_t getRequestsServed() const;
+    Expression_Cache::Statistics getCacheStatistics() const;
+};
+
+#endif //EVALUATION_SERVER_H
@@ -0,0 +1,70 @@
+/**
+ * @file Expression_Arena.cpp
+ * @brief Placement of expressions in a monotonic buffer resource.
+ *
+ * The expressions' destructors are never run. That is safe because every
+ * container inside a Boolean_Expression allocates from the arena (the
+ * operator list holds pointers to shared instances), so nothing outside
+ * the arena is left to free.
+ */
+
+#include "Expression_Arena.h"
+
+#include <new>
+
+using namespace std;
+
+void* Expression_Arena::Overflow_Resource::do_allocate(size_t size, size_t alignment) {
+  bytes += size;
+  return pmr::new_delete_resource()->allocate(size, alignment);
+}
+
+void Expression_Arena::Overflow_Resource::do_deallocate(void* memory, size_t size, size_t alignment) {
+  pmr::new_delete_resource()->deallocate(memory, size, alignment);
+}
+
+bool Expression_Arena::Overflow_Resource::do_is_equal(const pmr::memory_resource& other) const noexcept {
+  return this == &other;
+}
+
+// Constructor : one buffer of initial_bytes, overflowing to the heap
+Expression_Arena::Expression_Arena(size_t initial_bytes)
+  : buffer(new byte[initial_bytes ? initial_bytes : 1]), buffer_size(initial_bytes ? initial_bytes : 1) {
+  resource.emplace(buffer.get(), buffer_size, &overflow);
+}
+
+/**
+ * @brief Construct a Boolean_Expression in arena memory.
+ * If the constructor throws, the partly built members are destroyed as
+ * usual and the raw space simply stays unused until release().
+ */
+Boolean_Expression& Expression_Arena::parse(const string& text) {
+  void* memory = resource->allocate(sizeof(Boolean_Expression), alignof(Boolean_Expression));
+  Boolean_Expression* expression = new (memory) Boolean_Expression(text, &*resource);
+  ++expression_count;
+  return *expression;
+}
+
+/**
+ * @brief Forget every expression in one step.
+ * Overflow blocks go back to the heap and, if there were any, the buffer
+ * grows to cover them, so the next batch of the same size fits in it.
+ */
+void Expression_Arena::release() {
+  resource.reset();   // frees the overflow blocks
+  if (overflow.bytes > 0) {
+    buffer_size += overflow.bytes;
+    buffer.reset(new byte[buffer_size]);
+    overflow.bytes = 0;
+  }
+  resource.emplace(buffer.get(), buffer_size, &overflow);
+  expression_count = 0;
+}
+
+size_t Expression_Arena::getExpressionCount() const {
+  return expression_count;
+}
+
+pmr::memory_resource* Expression_Arena::getResource() {
+  return &*resource;
+}
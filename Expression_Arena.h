@@ -0,0 +1,83 @@
+/**
+ * @class Expression_Arena
+ * @brief Parses many expressions into one monotonic memory arena.
+ *
+ * Every Boolean_Expression made by parse() lives in the arena together
+ * with its source copy, tokens, variable names, operator list and any
+ * postfix output it produces: a handful of large blocks instead of a
+ * dozen small heap allocations per expression. release() drops all
+ * expressions at once, without visiting them.
+ *
+ * The arena starts in one buffer. When a batch outgrows it, extra blocks
+ * come from the heap; release() then frees them and enlarges the buffer
+ * to what the batch used, so a steady workload reuses the same (already
+ * paged-in) memory and never calls malloc.
+ *
+ * Typical bulk use:
+ *   Expression_Arena arena;
+ *   for (each line) { Boolean_Expression& e = arena.parse(line); ... }
+ *   arena.release();   // every expression is gone
+ *
+ * Memory is only reclaimed by release() (or the destructor), so an arena
+ * suits batches of short-lived expressions. Compiled programs and truth
+ * tables keep using the heap: they may outlive the batch. An arena is not
+ * thread-safe; use one per thread.
+ */
+
+#ifndef EXPRESSION_ARENA_H
+#define EXPRESSION_ARENA_H
+
+#include "Boolean_Expression.h"
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <string>
+
+using namespace std;
+
+class Expression_Arena {
+  public:
+    static const size_t DEFAULT_BUFFER_BYTES = 64 * 1024;   // initial buffer; grows to fit a batch
+
+  private:
+    // Heap blocks taken when the buffer runs out; counts their bytes
+    class Overflow_Resource : public pmr::memory_resource {
+      public:
+        size_t bytes = 0;
+
+      private:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void* memory, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const pmr::memory_resource& other) const noexcept override;
+    };
+
+    Overflow_Resource overflow;
+    unique_ptr<byte[]> buffer;
+    size_t buffer_size;
+    optional<pmr::monotonic_buffer_resource> resource;   // rebuilt by release()
+    size_t expression_count = 0;
+
+  public:
+    explicit Expression_Arena(size_t initial_bytes = DEFAULT_BUFFER_BYTES);
+
+    // Expressions are never destroyed one by one, so the arena cannot be copied
+    Expression_Arena(const Expression_Arena&) = delete;
+    Expression_Arena& operator=(const Expression_Arena&) = delete;
+
+    // Build an expression inside the arena; throws Parse_Error like the
+    // Boolean_Expression constructor. Valid until release().
+    Boolean_Expression& parse(const string& text);
+
+    // Drop every expression parsed so far; the buffer is kept for reuse
+    void release();
+
+    // Expressions parsed since the last release()
+    size_t getExpressionCount() const;
+
+    // For other per-batch data that should be freed with the expressions
+    pmr::memory_resource* getResource();
+};
+
+#endif //EXPRESSION_ARENA_H
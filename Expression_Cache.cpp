@@ -0,0 +1,218 @@
+/**
+ * @file Expression_Cache.cpp
+ * @brief Open-addressing lookup, LRU list and byte accounting.
+ *
+ * Every entry is in exactly one of two places: live (in the table and the
+ * LRU list) or free (in free_slots, its key and entry released). The
+ * table is kept at most half full, so probes stay short.
+ */
+
+#include "Expression_Cache.h"
+#include "Run_Stats.h"
+
+using namespace std;
+
+// Constructor : empty cache with a 64-bucket table
+Expression_Cache::Expression_Cache(size_t max_bytes) : max_bytes(max_bytes), table(64, NONE) {
+}
+
+// FNV-1a over the key, finished with the splitmix64 mix
+uint64_t Expression_Cache::hashKey(const string& key) {
+  uint64_t h = 0xCBF29CE484222325ull;
+  for (char ch : key) {
+    h = (h ^ static_cast<unsigned char>(ch)) * 0x100000001B3ull;
+  }
+  h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+  h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+  return h ^ (h >> 31);
+}
+
+/**
+ * @brief Heap bytes an entry keeps alive, roughly: key, spelling,
+ * instructions, names and labels of the program, and the bitset.
+ */
+size_t Expression_Cache::entryBytes(const string& key, const Entry& entry) {
+  size_t bytes = sizeof(Slot) + sizeof(Entry) + key.size() + entry.spelling.size();
+  if (entry.program) {
+    const Compiled_Program& program = *entry.program;
+    bytes += sizeof(Compiled_Program) + program.getCode().size() * sizeof(Instruction);
+    bytes += program.getResultLabel().size();
+    for (const string& name : program.getVariables()) {
+      bytes += sizeof(string) + name.size();
+    }
+    for (const string& label : program.getStepLabels()) {
+      bytes += sizeof(string) + label.size();
+    }
+  }
+  if (entry.result_bits) {
+    bytes += entry.result_bits->size() * sizeof(uint64_t);
+  }
+  return bytes;
+}
+
+// Bucket holding key, or the empty bucket where it would go
+size_t Expression_Cache::findBucket(const string& key, uint64_t hash) const {
+  const size_t mask = table.size() - 1;
+  size_t bucket = hash & mask;
+  while (table[bucket] != NONE) {
+    const Slot& slot = slots[table[bucket]];
+    if (slot.hash == hash && slot.key == key) {
+      break;
+    }
+    bucket = (bucket + 1) & mask;
+  }
+  return bucket;
+}
+
+// Take an entry out of the LRU list
+void Expression_Cache::unlink(uint32_t id) {
+  Slot& slot = slots[id];
+  if (slot.newer != NONE) slots[slot.newer].older = slot.older;
+  else newest = slot.older;
+  if (slot.older != NONE) slots[slot.older].newer = slot.newer;
+  else oldest = slot.newer;
+  slot.newer = slot.older = NONE;
+}
+
+// Put an (unlinked) entry at the most recently used end
+void Expression_Cache::pushNewest(uint32_t id) {
+  slots[id].older = newest;
+  slots[id].newer = NONE;
+  if (newest != NONE) slots[newest].newer = id;
+  newest = id;
+  if (oldest == NONE) oldest = id;
+}
+
+/**
+ * @brief Remove a live entry. Its bucket is refilled by backward shift:
+ * each following entry of the probe run moves into the hole unless its
+ * home bucket lies after the hole, so no tombstones are needed.
+ */
+void Expression_Cache::erase(uint32_t id) {
+  Slot& slot = slots[id];
+  const size_t mask = table.size() - 1;
+  size_t hole = findBucket(slot.key, slot.hash);
+  table[hole] = NONE;
+  for (size_t next = (hole + 1) & mask; table[next] != NONE; next = (next + 1) & mask) {
+    const size_t home = slots[table[next]].hash & mask;
+    if (((next - home) & mask) >= ((next - hole) & mask)) {
+      table[hole] = table[next];
+      table[next] = NONE;
+      hole = next;
+    }
+  }
+
+  unlink(id);
+  statistics.bytes -= slot.bytes;
+  --statistics.entries;
+  string().swap(slot.key);
+  slot.entry.reset();
+  slot.bytes = 0;
+  free_slots.push_back(id);
+}
+
+/**
+ * @brief Double the table and reinsert the live entries.
+ */
+void Expression_Cache::growTable() {
+  table.assign(table.size() * 2, NONE);
+  const size_t mask = table.size() - 1;
+  for (uint32_t id = newest; id != NONE; id = slots[id].older) {
+    size_t bucket = slots[id].hash & mask;
+    while (table[bucket] != NONE) {
+      bucket = (bucket + 1) & mask;
+    }
+    table[bucket] = id;
+  }
+}
+
+shared_ptr<const Expression_Cache::Entry> Expression_Cache::find(const string& key) {
+  const uint64_t hash = hashKey(key);
+  lock_guard<mutex> guard(lock);
+
+  const uint32_t id = table[findBucket(key, hash)];
+  if (id == NONE) {
+    ++statistics.misses;
+    Run_Stats::add(Run_Stats::Counter::CACHE_MISSES, 1);
+    return nullptr;
+  }
+  ++statistics.hits;
+  Run_Stats::add(Run_Stats::Counter::CACHE_HITS, 1);
+  unlink(id);
+  pushNewest(id);
+  return slots[id].entry;
+}
+
+/**
+ * @brief Store an entry as the most recently used, then evict from the
+ * least recently used end until the total fits again.
+ */
+shared_ptr<const Expression_Cache::Entry> Expression_Cache::insert(const string& key, Entry entry) {
+  const size_t bytes = entryBytes(key, entry);
+  shared_ptr<const Entry> stored = make_shared<const Entry>(move(entry));
+  if (bytes > max_bytes / 4) {
+    return stored;
+  }
+
+  const uint64_t hash = hashKey(key);
+  lock_guard<mutex> guard(lock);
+
+  const size_t bucket = findBucket(key, hash);
+  uint32_t id = table[bucket];
+  if (id != NONE) {
+    // Replace: same key, newer contents
+    statistics.bytes -= slots[id].bytes;
+    unlink(id);
+  }
+  else {
+    if (!free_slots.empty()) {
+      id = free_slots.back();
+      free_slots.pop_back();
+    }
+    else {
+      id = static_cast<uint32_t>(slots.size());
+      slots.emplace_back();
+    }
+    slots[id].key = key;
+    slots[id].hash = hash;
+    table[bucket] = id;
+    ++statistics.entries;
+  }
+
+  slots[id].entry = stored;
+  slots[id].bytes = bytes;
+  statistics.bytes += bytes;
+  ++statistics.insertions;
+  pushNewest(id);
+
+  while (statistics.bytes > max_bytes && oldest != id) {
+    erase(oldest);
+    ++statistics.evictions;
+  }
+
+  // Keep the table at most half full
+  if (statistics.entries * 2 > table.size()) {
+    growTable();
+  }
+  return stored;
+}
+
+// Drop every entry; the hit and miss counters are kept
+void Expression_Cache::clear() {
+  lock_guard<mutex> guard(lock);
+  slots.clear();
+  free_slots.clear();
+  table.assign(64, NONE);
+  newest = oldest = NONE;
+  statistics.entries = 0;
+  statistics.bytes = 0;
+}
+
+Expression_Cache::Statistics Expression_Cache::getStatistics() const {
+  lock_guard<mutex> guard(lock);
+  return statistics;
+}
+
+size_t Expression_Cache::getMaxBytes() const {
+  return max_bytes;
+}
@@ -0,0 +1,112 @@
+/**
+ * @class Expression_Cache
+ * @brief Byte-bounded LRU cache of compiled expressions and their results,
+ *        keyed by the expression's canonical form.
+ *
+ * The same expression often arrives many times, spelled differently:
+ *   "A AND (B OR C)", "(C OR B) AND A", "A  AND  ((B) OR C)"
+ * all have one canonical form (Boolean_Expression::getCanonicalForm()),
+ * so the second and later lines reuse the first one's true-row count or
+ * result bitset once computed (see Truth_Table). The Compiled_Program is
+ * stored with the spelling it was compiled from, since its steps and
+ * labels follow that spelling; only the same tokens reuse it.
+ *
+ * Entries are immutable and shared: find() hands out a shared_ptr, so an
+ * entry evicted while a table still uses it stays valid until released.
+ * Adding a count to an entry inserts a new entry under the same key.
+ *
+ * Storage follows Expression_DAG: entries live in one vector and are found
+ * through an open-addressing table of entry ids (linear probing, removal
+ * by backward shift). The LRU order is a doubly linked list threaded
+ * through the entries by index. The size of an entry is an estimate of
+ * its heap bytes (key, instructions, labels, bitset); once the total is
+ * over the limit, the least recently used entries are evicted.
+ *
+ * One mutex guards everything; a lookup holds it for one probe and a list
+ * update, while compiling and counting happen outside it.
+ */
+
+#ifndef EXPRESSION_CACHE_H
+#define EXPRESSION_CACHE_H
+
+#include "Compiled_Program.h"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class Expression_Cache {
+  public:
+    struct Entry {
+      shared_ptr<const Compiled_Program> program;
+      string spelling;                                  // tokens the program was compiled from
+      shared_ptr<const vector<uint64_t>> result_bits;   // packed result column, if stored
+      uint64_t true_rows = 0;                           // valid when counted
+      bool counted = false;
+    };
+
+    struct Statistics {
+      uint64_t hits = 0;
+      uint64_t misses = 0;
+      uint64_t insertions = 0;
+      uint64_t evictions = 0;
+      size_t entries = 0;
+      size_t bytes = 0;         // estimated bytes of the cached entries
+    };
+
+    static constexpr size_t DEFAULT_MAX_BYTES = size_t(64) << 20;
+
+  private:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    struct Slot {
+      string key;
+      uint64_t hash = 0;
+      shared_ptr<const Entry> entry;   // null while the slot is free
+      size_t bytes = 0;
+      uint32_t newer = NONE;           // LRU neighbours (NONE at the ends)
+      uint32_t older = NONE;
+    };
+
+    size_t max_bytes;
+    mutable mutex lock;
+    vector<Slot> slots;
+    vector<uint32_t> free_slots;
+    vector<uint32_t> table;            // open addressing over slot ids
+    uint32_t newest = NONE;
+    uint32_t oldest = NONE;
+    Statistics statistics;
+
+    static uint64_t hashKey(const string& key);
+    static size_t entryBytes(const string& key, const Entry& entry);
+    size_t findBucket(const string& key, uint64_t hash) const;
+    void unlink(uint32_t id);
+    void pushNewest(uint32_t id);
+    void erase(uint32_t id);
+    void growTable();
+
+  public:
+    // max_bytes bounds the estimated size of all entries together
+    explicit Expression_Cache(size_t max_bytes = DEFAULT_MAX_BYTES);
+
+    Expression_Cache(const Expression_Cache&) = delete;
+    Expression_Cache& operator=(const Expression_Cache&) = delete;
+
+    // The entry for key, marked most recently used; null on a miss.
+    // Counts a hit or a miss.
+    shared_ptr<const Entry> find(const string& key);
+
+    // Store (or replace) the entry for key and return it. An entry larger
+    // than a quarter of the limit is returned without being stored, so one
+    // large bitset cannot flush the whole cache.
+    shared_ptr<const Entry> insert(const string& key, Entry entry);
+
+    void clear();
+    Statistics getStatistics() const;
+    size_t getMaxBytes() const;
+};
+
+#endif //EXPRESSION_CACHE_H
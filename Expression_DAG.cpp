@@ -0,0 +1,340 @@
+/**
+ * @file Expression_DAG.cpp
+ * @brief Interning of expression nodes with commutative normalization.
+ *
+ * Example (variables A, B, C):
+ *   postfix ["A", "B", "AND", "A", "B", "AND", "C", "XOR", "OR"]
+ *   → 3: (0 AND 1), 4: (3 XOR 2), 5: (3 OR 4)
+ *   The second "A B AND" finds node 3 in the unique table.
+ */
+
+#include "Expression_DAG.h"
+#include "Parse_Error.h"
+#include "Tokenizer.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+
+using namespace std;
+
+static const Expression_DAG::Node_Id EMPTY = UINT32_MAX;   // unused unique-table slot
+
+// Operand pair in canonical order: binary operators are commutative
+static inline void normalize(Opcode op, Expression_DAG::Node_Id& a, Expression_DAG::Node_Id& b) {
+  if (Expression_DAG::operandCount(op) == 2 && a > b) {
+    const Expression_DAG::Node_Id swapped = a;
+    a = b;
+    b = swapped;
+  }
+}
+
+// Mix a node's fields into a table index
+static inline size_t hashNode(Opcode op, Expression_DAG::Node_Id a, Expression_DAG::Node_Id b) {
+  normalize(op, a, b);
+  uint64_t h = (static_cast<uint64_t>(op) + 1) * 0x9E3779B97F4A7C15ull;
+  h ^= (a + 0x7F4A7C15ull + (h << 6) + (h >> 2)) * 0xBF58476D1CE4E5B9ull;
+  h ^= (b + 0x94D049BBull + (h << 6) + (h >> 2)) * 0x94D049BB133111EBull;
+  return static_cast<size_t>(h ^ (h >> 31));
+}
+
+// Constructor : one VAR node per variable, empty unique table
+Expression_DAG::Expression_DAG(const vector<string>& variables) : variables(variables) {
+  nodes.reserve(variables.size());
+  for (Node_Id slot = 0; slot < variables.size(); ++slot) {
+    nodes.push_back({Opcode::VAR, slot, 0});
+  }
+  unique_table.assign(1 << 8, EMPTY);
+}
+
+/**
+ * @brief Map an operator or constant keyword to its opcode.
+ * Switching on the length leaves at most four comparisons.
+ * @return true if the token is a keyword.
+ */
+bool Expression_DAG::lookupOpcode(string_view token, Opcode& op) {
+  switch (token.size()) {
+    case 2:
+      if (token == "OR") { op = Opcode::OR; return true; }
+      break;
+    case 3:
+      if (token == "AND") { op = Opcode::AND; return true; }
+      if (token == "NOT") { op = Opcode::NOT; return true; }
+      if (token == "XOR") { op = Opcode::XOR; return true; }
+      if (token == "NOR") { op = Opcode::NOR; return true; }
+      break;
+    case 4:
+      if (token == "NAND") { op = Opcode::NAND; return true; }
+      if (token == "TRUE") { op = Opcode::CONST_TRUE; return true; }
+      break;
+    case 5:
+      if (token == "FALSE") { op = Opcode::CONST_FALSE; return true; }
+      break;
+  }
+  return false;
+}
+
+const char* Expression_DAG::opcodeName(Opcode op) {
+  switch (op) {
+    case Opcode::NOT:  return "NOT";
+    case Opcode::AND:  return "AND";
+    case Opcode::OR:   return "OR";
+    case Opcode::XOR:  return "XOR";
+    case Opcode::NAND: return "NAND";
+    case Opcode::NOR:  return "NOR";
+    case Opcode::CONST_FALSE: return "FALSE";
+    case Opcode::CONST_TRUE:  return "TRUE";
+    default:           return "VAR";
+  }
+}
+
+unsigned Expression_DAG::operandCount(Opcode op) {
+  switch (op) {
+    case Opcode::VAR:
+    case Opcode::CONST_FALSE:
+    case Opcode::CONST_TRUE: return 0;
+    case Opcode::NOT:        return 1;
+    default:                 return 2;
+  }
+}
+
+/**
+ * @brief Return the unique node (op, a, b), creating it if needed.
+ * (op, a, b) and (op, b, a) are the same node for binary operators.
+ */
+Expression_DAG::Node_Id Expression_DAG::makeNode(Opcode op, Node_Id a, Node_Id b) {
+  const unsigned operands = operandCount(op);
+  if (operands < 2) {
+    b = 0;
+  }
+  if (operands < 1) {
+    a = 0;
+  }
+
+  Node_Id key_a = a, key_b = b;
+  normalize(op, key_a, key_b);
+
+  const size_t mask = unique_table.size() - 1;
+  size_t bucket = hashNode(op, a, b) & mask;
+  while (unique_table[bucket] != EMPTY) {
+    const Node& candidate = nodes[unique_table[bucket]];
+    Node_Id other_a = candidate.a, other_b = candidate.b;
+    normalize(candidate.op, other_a, other_b);
+    if (candidate.op == op && other_a == key_a && other_b == key_b) {
+      return unique_table[bucket];
+    }
+    bucket = (bucket + 1) & mask;
+  }
+
+  if (nodes.size() >= EMPTY - 1) {
+    throw length_error("Expression node limit reached");
+  }
+
+  const Node_Id id = static_cast<Node_Id>(nodes.size());
+  nodes.push_back({op, a, b});
+  unique_table[bucket] = id;
+
+  // Keep the unique table at most half full
+  if ((nodes.size() - variables.size()) * 2 > unique_table.size()) {
+    growUniqueTable();
+  }
+  return id;
+}
+
+/**
+ * @brief Double the unique table and rehash the operator nodes.
+ */
+void Expression_DAG::growUniqueTable() {
+  unique_table.assign(unique_table.size() * 2, EMPTY);
+  const size_t mask = unique_table.size() - 1;
+
+  for (Node_Id id = static_cast<Node_Id>(variables.size()); id < nodes.size(); ++id) {
+    size_t bucket = hashNode(nodes[id].op, nodes[id].a, nodes[id].b) & mask;
+    while (unique_table[bucket] != EMPTY) {
+      bucket = (bucket + 1) & mask;
+    }
+    unique_table[bucket] = id;
+  }
+}
+
+/**
+ * @brief Build the graph of a postfix token list.
+ *
+ * The stack holds node ids; tracking its depth rejects malformed postfix
+ * (missing operand, leftover operands) before anything is evaluated.
+ */
+Expression_DAG::Node_Id Expression_DAG::build(const vector<string>& postfix) {
+  // Name → slot, built once per call
+  unordered_map<string, Node_Id> slots;
+  for (Node_Id slot = 0; slot < variables.size(); ++slot) {
+    slots.emplace(variables[slot], slot);
+  }
+
+  vector<Node_Id> stack;
+
+  for (const string& token : postfix) {
+    Opcode op;
+
+    if (lookupOpcode(token, op)) {
+      const size_t arity = operandCount(op);
+      if (stack.size() < arity) {
+        throw invalid_argument("Missing operand for " + token);
+      }
+      if (arity == 0) {
+        stack.push_back(makeNode(op));
+        peak_depth = max(peak_depth, stack.size());
+      }
+      else if (op == Opcode::NOT) {
+        stack.back() = makeNode(op, stack.back());
+      }
+      else {
+        const Node_Id b = stack.back();
+        stack.pop_back();
+        stack.back() = makeNode(op, stack.back(), b);
+      }
+    }
+    else {
+      // Operand: find its slot among the table's variables
+      auto found = slots.find(token);
+      if (found == slots.end()) {
+        throw invalid_argument("Unknown variable " + token);
+      }
+      stack.push_back(found->second);
+      peak_depth = max(peak_depth, stack.size());
+    }
+  }
+
+  if (stack.size() != 1) {
+    throw invalid_argument(stack.empty() ? "Empty expression" : "Missing operator between operands");
+  }
+  return stack.back();
+}
+
+/**
+ * @brief Same as build() above, but from tokens: no strings are compared,
+ * and errors point at the offending token.
+ */
+Expression_DAG::Node_Id Expression_DAG::build(const pmr::vector<Token>& postfix, const vector<uint32_t>& slots) {
+  vector<Node_Id> stack;
+
+  for (const Token& token : postfix) {
+    if (token.kind == Token_Kind::OPERATOR) {
+      const size_t arity = (token.op == Opcode::NOT) ? 1 : 2;
+      if (stack.size() < arity) {
+        throw Parse_Error(Parse_Error::Kind::MISSING_OPERAND, string("Missing operand for ") + opcodeName(token.op),
+                          token.offset, token.length);
+      }
+      if (token.op == Opcode::NOT) {
+        stack.back() = makeNode(token.op, stack.back());
+      }
+      else {
+        const Node_Id b = stack.back();
+        stack.pop_back();
+        stack.back() = makeNode(token.op, stack.back(), b);
+      }
+    }
+    else if (token.kind == Token_Kind::VARIABLE && slots[token.var_id] < variables.size()) {
+      stack.push_back(slots[token.var_id]);
+      peak_depth = max(peak_depth, stack.size());
+    }
+    else if (token.kind == Token_Kind::CONSTANT) {
+      stack.push_back(makeNode(token.op));
+      peak_depth = max(peak_depth, stack.size());
+    }
+    else {
+      // A variable without a slot; parentheses never reach postfix
+      throw Parse_Error(Parse_Error::Kind::INVALID_NAME, "Unexpected token", token.offset, token.length);
+    }
+  }
+
+  if (stack.size() != 1) {
+    throw invalid_argument(stack.empty() ? "Empty expression" : "Missing operator between operands");
+  }
+  return stack.back();
+}
+
+/**
+ * @brief Render a subexpression as infix text.
+ *
+ * Walks the tree with an explicit stack (deep expressions do not recurse)
+ * and writes straight into one string. An operand gets parentheses when it
+ * is binary and its operator differs from its parent's, or when the parent
+ * is NAND/NOR (which are not associative):
+ *   AND(AND(A, B), NOT(OR(C, D)))  →  "A AND B AND NOT (C OR D)"
+ * A shared node is written out at each of its uses.
+ */
+string Expression_DAG::toText(Node_Id root) const {
+  struct Frame {
+    Node_Id id;
+    uint8_t stage;      // 0: before the first operand, 1: between operands, 2: done
+    bool parenthesize;
+  };
+
+  auto needsParens = [&](Opcode parent, Node_Id child) {
+    const Opcode op = nodes[child].op;
+    if (operandCount(op) < 2) return false;
+    if (parent == Opcode::NOT) return true;
+    return op != parent || parent == Opcode::NAND || parent == Opcode::NOR;
+  };
+
+  string text;
+  vector<Frame> stack;
+  stack.push_back({root, 0, false});
+
+  while (!stack.empty()) {
+    Frame& frame = stack.back();
+    const Node& node = nodes[frame.id];
+
+    if (node.op == Opcode::VAR) {
+      text += variables[node.a];
+      stack.pop_back();
+    }
+    else if (operandCount(node.op) == 0) {
+      text += opcodeName(node.op);
+      stack.pop_back();
+    }
+    else if (node.op == Opcode::NOT) {
+      if (frame.stage == 0) {
+        frame.stage = 2;
+        text += "NOT ";
+        stack.push_back({node.a, 0, needsParens(Opcode::NOT, node.a)});
+      }
+      else {
+        stack.pop_back();
+      }
+    }
+    else if (frame.stage == 0) {
+      frame.stage = 1;
+      if (frame.parenthesize) text += '(';
+      stack.push_back({node.a, 0, needsParens(node.op, node.a)});
+    }
+    else if (frame.stage == 1) {
+      frame.stage = 2;
+      text += ' ';
+      text += opcodeName(node.op);
+      text += ' ';
+      stack.push_back({node.b, 0, needsParens(node.op, node.b)});
+    }
+    else {
+      if (frame.parenthesize) text += ')';
+      stack.pop_back();
+    }
+  }
+  return text;
+}
+
+size_t Expression_DAG::getPeakDepth() const {
+  return peak_depth;
+}
+
+const Expression_DAG::Node& Expression_DAG::getNode(Node_Id id) const {
+  return nodes[id];
+}
+
+size_t Expression_DAG::getNodeCount() const {
+  return nodes.size();
+}
+
+const vector<string>& Expression_DAG::getVariables() const {
+  return variables;
+}
@@ -0,0 +1,98 @@
+/**
+ * @class Expression_DAG
+ * @brief Hash-consed expression graph: every distinct subexpression is one node.
+ *
+ * Built from postfix tokens. Before a node is created, a unique table
+ * (open addressing, like BDD_Manager) is searched for an equal node, so
+ * repeated subexpressions such as the two "(A AND B)" in
+ *   (A AND B) OR ((A AND B) XOR C)
+ * become a single node that is evaluated and shown once.
+ *
+ * All binary operators are commutative, so "(B AND A)" is found as
+ * "(A AND B)". A node keeps the operand order it was first seen with,
+ * which is the order its label is printed in.
+ *
+ * Nodes 0 .. n-1 are the variables. Every other node is created after its
+ * operands, so node ids are a topological order. TRUE and FALSE are
+ * nodes without operands (CONST_TRUE, CONST_FALSE).
+ */
+
+#ifndef EXPRESSION_DAG_H
+#define EXPRESSION_DAG_H
+
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+struct Token;
+
+// One opcode per node kind
+enum class Opcode : uint8_t {
+  VAR,   // variable; operand a is its slot
+  NOT,
+  AND,
+  OR,
+  XOR,
+  NAND,
+  NOR,
+  CONST_FALSE,   // the literal FALSE (no operands)
+  CONST_TRUE,    // the literal TRUE
+};
+
+class Expression_DAG {
+  public:
+    using Node_Id = uint32_t;
+
+    struct Node {
+      Opcode op;
+      Node_Id a;   // first operand (slot for VAR)
+      Node_Id b;   // second operand (binary operators only)
+    };
+
+  private:
+    vector<Node> nodes;
+    vector<string> variables;       // slot → name
+    vector<Node_Id> unique_table;   // open addressing over operator node ids
+    size_t peak_depth = 0;          // deepest operand stack seen by build()
+
+    void growUniqueTable();
+
+  public:
+    // variables[i] becomes node i
+    explicit Expression_DAG(const vector<string>& variables);
+
+    // The node for (op, a, b), creating it only if no equal node exists
+    Node_Id makeNode(Opcode op, Node_Id a = 0, Node_Id b = 0);
+
+    // Build from postfix tokens (output of Boolean_Expression::convertToPostfix());
+    // throws invalid_argument on malformed postfix or unknown variables
+    Node_Id build(const vector<string>& postfix);
+
+    // Build from postfix tokens (Boolean_Expression::postfixTokens());
+    // slots[var_id] is the variable slot of each interned name
+    Node_Id build(const pmr::vector<Token>& postfix, const vector<uint32_t>& slots);
+
+    // Map a keyword ("AND", "NOT", ..., "TRUE", "FALSE") to its opcode
+    static bool lookupOpcode(string_view token, Opcode& op);
+    static const char* opcodeName(Opcode op);
+
+    // Operands an opcode reads: 0 for VAR and constants, 1 for NOT, else 2
+    static unsigned operandCount(Opcode op);
+
+    // Infix text of the subexpression at root, e.g. "A AND B AND NOT (C OR D)";
+    // only nested operands with a different operator are parenthesized
+    string toText(Node_Id root) const;
+
+    // Deepest operand stack any build() needed (what a stack evaluator would use)
+    size_t getPeakDepth() const;
+
+    const Node& getNode(Node_Id id) const;
+    size_t getNodeCount() const;
+    const vector<string>& getVariables() const;
+};
+
+#endif //EXPRESSION_DAG_H
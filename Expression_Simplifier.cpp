@@ -0,0 +1,355 @@
+/**
+ * @file Expression_Simplifier.cpp
+ * @brief Rewriting into n-ary terms and back into binary nodes.
+ *
+ * Flow:
+ *   1) Count the uses of every source node the roots depend on
+ *   2) In node (topological) order, turn each node into a literal; binary
+ *      operators go through reduceAndOr() / reduceXor(), which flatten,
+ *      fold and deduplicate the operand lists
+ *   3) Emit the terms the roots need, in term (topological) order, as
+ *      chains of binary nodes in the target graph
+ *
+ * Example: (A AND B) AND NOT (B AND A)
+ *   → AND(A, B) and NOT AND(A, B) in one list: every operand of the
+ *     negated term is in the list, so the AND is FALSE
+ */
+
+#include "Expression_Simplifier.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+static const Expression_DAG::Node_Id UNSET = UINT32_MAX;   // also an unused unique-table slot
+
+// Mix a term's operator and operands into a table index
+static size_t hashTerm(Opcode op, const vector<uint32_t>& operands) {
+  uint64_t h = (static_cast<uint64_t>(op) + 1) * 0x9E3779B97F4A7C15ull;
+  for (uint32_t operand : operands) {
+    h = (h ^ operand) * 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 29;
+  }
+  return static_cast<size_t>(h ^ (h >> 32));
+}
+
+// Constructor : term 0 is TRUE, terms 1 .. n are the variables
+Expression_Simplifier::Expression_Simplifier(const Expression_DAG& source, Expression_DAG& target)
+  : source(source), target(target) {
+  if (source.getVariables().size() != target.getVariables().size()) {
+    throw invalid_argument("Simplifier graphs have different variables");
+  }
+  terms.push_back({Opcode::CONST_TRUE, 0, {}});
+  for (uint32_t slot = 0; slot < source.getVariables().size(); ++slot) {
+    terms.push_back({Opcode::VAR, slot, {}});
+  }
+  unique_table.assign(1 << 8, UNSET);
+}
+
+// The literal of term (op, operands), creating the term only if no equal
+// one exists; operands must be sorted
+Expression_Simplifier::Literal Expression_Simplifier::makeTerm(Opcode op, const vector<Literal>& operands) {
+  const size_t mask = unique_table.size() - 1;
+  size_t bucket = hashTerm(op, operands) & mask;
+  while (unique_table[bucket] != UNSET) {
+    const Term& candidate = terms[unique_table[bucket]];
+    if (candidate.op == op && candidate.operands == operands) {
+      return unique_table[bucket] * 2;
+    }
+    bucket = (bucket + 1) & mask;
+  }
+
+  const uint32_t id = static_cast<uint32_t>(terms.size());
+  terms.push_back({op, 0, operands});
+  unique_table[bucket] = id;
+  if (terms.size() * 2 > unique_table.size()) {
+    growUniqueTable();
+  }
+  return id * 2;
+}
+
+// Double the unique table and rehash the operator terms
+void Expression_Simplifier::growUniqueTable() {
+  unique_table.assign(unique_table.size() * 2, UNSET);
+  const size_t mask = unique_table.size() - 1;
+  for (uint32_t id = 0; id < terms.size(); ++id) {
+    if (terms[id].operands.empty()) continue;
+    size_t bucket = hashTerm(terms[id].op, terms[id].operands) & mask;
+    while (unique_table[bucket] != UNSET) {
+      bucket = (bucket + 1) & mask;
+    }
+    unique_table[bucket] = id;
+  }
+}
+
+/**
+ * @brief AND or OR of some literals (the rules are each other's duals).
+ *
+ * For AND: TRUE is dropped and FALSE wins; for OR the other way round.
+ * After flattening and sorting, x and NOT x are neighbours, so the
+ * complement check is one pass. Absorption looks for an operand of each
+ * OR term (for AND) in the list itself.
+ */
+Expression_Simplifier::Literal Expression_Simplifier::reduceAndOr(Opcode op, const vector<Operand>& operands) {
+  const Opcode dual = op == Opcode::AND ? Opcode::OR : Opcode::AND;
+  const Literal identity = op == Opcode::AND ? TRUE_LITERAL : FALSE_LITERAL;
+  const Literal absorbing = identity ^ 1;
+
+  // Flatten single-use terms of the same operator
+  list.clear();
+  for (const Operand& operand : operands) {
+    const Term& term = terms[operand.literal >> 1];
+    if (!(operand.literal & 1) && operand.single_use && term.op == op) {
+      list.insert(list.end(), term.operands.begin(), term.operands.end());
+    }
+    else {
+      list.push_back(operand.literal);
+    }
+  }
+
+  // Constants, idempotence and complements
+  if (find(list.begin(), list.end(), absorbing) != list.end()) {
+    return absorbing;
+  }
+  list.erase(remove(list.begin(), list.end(), identity), list.end());
+  sort(list.begin(), list.end());
+  list.erase(unique(list.begin(), list.end()), list.end());
+  for (size_t i = 1; i < list.size(); ++i) {
+    if ((list[i - 1] ^ 1) == list[i]) {
+      return absorbing;
+    }
+  }
+
+  // Absorption, and negated terms that contradict the list
+  auto contains = [&](Literal literal) { return binary_search(list.begin(), list.end(), literal); };
+  kept.clear();
+  for (Literal literal : list) {
+    const Term& term = terms[literal >> 1];
+    if (term.op == dual && any_of(term.operands.begin(), term.operands.end(), contains)) {
+      // A AND (A OR B) → A;  A AND NOT (A OR B) → FALSE
+      if (literal & 1) {
+        return absorbing;
+      }
+      continue;
+    }
+    if (term.op == op && (literal & 1) && all_of(term.operands.begin(), term.operands.end(), contains)) {
+      // A AND B AND NOT (A AND B) → FALSE
+      return absorbing;
+    }
+    kept.push_back(literal);
+  }
+
+  if (kept.empty()) {
+    return identity;
+  }
+  if (kept.size() == 1) {
+    return kept[0];
+  }
+
+  // De Morgan: NOT A AND NOT B → NOT (A OR B), which is emitted as one NOR
+  if (all_of(kept.begin(), kept.end(), [](Literal literal) { return (literal & 1) != 0; })) {
+    vector<Operand> positive;
+    positive.reserve(kept.size());
+    for (Literal literal : kept) {
+      positive.push_back({literal ^ 1, false});
+    }
+    return reduceAndOr(dual, positive) ^ 1;
+  }
+  return makeTerm(op, kept);
+}
+
+/**
+ * @brief XOR of some literals.
+ * Negations and TRUE operands only flip the parity, so the term itself
+ * has positive operands; pairs of equal operands cancel.
+ */
+Expression_Simplifier::Literal Expression_Simplifier::reduceXor(const vector<Operand>& operands) {
+  Literal parity = 0;
+  list.clear();
+  for (const Operand& operand : operands) {
+    const Literal literal = operand.literal & ~1u;
+    parity ^= operand.literal & 1;
+    if (literal == TRUE_LITERAL) {
+      parity ^= 1;
+      continue;
+    }
+    const Term& term = terms[literal >> 1];
+    if (operand.single_use && term.op == Opcode::XOR) {
+      list.insert(list.end(), term.operands.begin(), term.operands.end());
+    }
+    else {
+      list.push_back(literal);
+    }
+  }
+
+  sort(list.begin(), list.end());
+  kept.clear();
+  for (Literal literal : list) {
+    if (!kept.empty() && kept.back() == literal) {
+      kept.pop_back();   // A XOR A = FALSE
+    }
+    else {
+      kept.push_back(literal);
+    }
+  }
+
+  if (kept.empty()) {
+    return FALSE_LITERAL ^ parity;
+  }
+  if (kept.size() == 1) {
+    return kept[0] ^ parity;
+  }
+  return makeTerm(Opcode::XOR, kept) ^ parity;
+}
+
+/**
+ * @brief Simplify several roots at once.
+ * A node used by two parents (or by a parent and as a root) is never
+ * flattened into either, so the sharing the source graph found survives.
+ */
+vector<Expression_DAG::Node_Id> Expression_Simplifier::simplify(const vector<Expression_DAG::Node_Id>& roots) {
+  const uint32_t n = static_cast<uint32_t>(source.getVariables().size());
+  if (roots.empty()) {
+    return {};
+  }
+  const Expression_DAG::Node_Id top = *max_element(roots.begin(), roots.end());
+
+  // 1) Uses of each node the roots depend on
+  vector<uint32_t> uses(top + 1, 0);
+  for (Expression_DAG::Node_Id root : roots) {
+    ++uses[root];
+  }
+  for (Expression_DAG::Node_Id id = top + 1; id-- > n;) {
+    if (uses[id] == 0) continue;
+    const Expression_DAG::Node& node = source.getNode(id);
+    const unsigned operand_count = Expression_DAG::operandCount(node.op);
+    if (operand_count >= 1) ++uses[node.a];
+    if (operand_count == 2) ++uses[node.b];
+  }
+
+  // 2) Source node → literal; single_use follows NOTs down to the term
+  vector<Literal> literal(top + 1, TRUE_LITERAL);
+  vector<bool> single_use(top + 1, false);
+  vector<Operand> operands(2);
+  for (Expression_DAG::Node_Id id = 0; id <= top; ++id) {
+    if (uses[id] == 0) continue;
+    const Expression_DAG::Node& node = source.getNode(id);
+    single_use[id] = uses[id] == 1;
+
+    switch (node.op) {
+      case Opcode::VAR:
+        literal[id] = (node.a + 1) * 2;
+        break;
+      case Opcode::CONST_TRUE:
+        literal[id] = TRUE_LITERAL;
+        break;
+      case Opcode::CONST_FALSE:
+        literal[id] = FALSE_LITERAL;
+        break;
+      case Opcode::NOT:
+        literal[id] = literal[node.a] ^ 1;
+        single_use[id] = single_use[id] && single_use[node.a];
+        break;
+      default: {
+        operands[0] = {literal[node.a], single_use[node.a]};
+        operands[1] = {literal[node.b], single_use[node.b]};
+        switch (node.op) {
+          case Opcode::AND:  literal[id] = reduceAndOr(Opcode::AND, operands); break;
+          case Opcode::NAND: literal[id] = reduceAndOr(Opcode::AND, operands) ^ 1; break;
+          case Opcode::OR:   literal[id] = reduceAndOr(Opcode::OR, operands); break;
+          case Opcode::NOR:  literal[id] = reduceAndOr(Opcode::OR, operands) ^ 1; break;
+          default:           literal[id] = reduceXor(operands); break;
+        }
+        break;
+      }
+    }
+  }
+
+  // 3) Polarities each term is needed in: bit 0 positive, bit 1 negated.
+  // A negated XOR moves its negation into an AND/OR operand, which then
+  // becomes a NAND/NOR for free; failing that it is NOT of the positive XOR.
+  vector<uint8_t> needed(terms.size(), 0);
+  vector<uint32_t> flipped(terms.size(), UNSET);   // XOR operand carrying the negation
+  for (Expression_DAG::Node_Id root : roots) {
+    needed[literal[root] >> 1] |= 1 << (literal[root] & 1);
+  }
+  for (size_t t = terms.size(); t-- > 0;) {
+    if (!needed[t]) continue;
+    const vector<Literal>& operands = terms[t].operands;
+    if (terms[t].op == Opcode::XOR && (needed[t] & 2)) {
+      for (uint32_t i = 0; i < operands.size() && needed[t] == 2; ++i) {
+        const Opcode op = terms[operands[i] >> 1].op;
+        if (op == Opcode::AND || op == Opcode::OR) {
+          flipped[t] = i;
+          break;
+        }
+      }
+      if (flipped[t] == UNSET) {
+        needed[t] |= 1;
+      }
+    }
+    for (uint32_t i = 0; i < operands.size(); ++i) {
+      const Literal operand = operands[i] ^ (i == flipped[t] ? 1 : 0);
+      needed[operand >> 1] |= 1 << (operand & 1);
+    }
+  }
+
+  vector<Expression_DAG::Node_Id> positive(terms.size(), UNSET);
+  vector<Expression_DAG::Node_Id> negative(terms.size(), UNSET);
+  auto nodeOf = [&](Literal l) { return (l & 1) ? negative[l >> 1] : positive[l >> 1]; };
+
+  for (size_t t = 0; t < terms.size(); ++t) {
+    if (!needed[t]) continue;
+    const Term& term = terms[t];
+
+    if (term.op == Opcode::CONST_TRUE) {
+      if (needed[t] & 1) positive[t] = target.makeNode(Opcode::CONST_TRUE);
+      if (needed[t] & 2) negative[t] = target.makeNode(Opcode::CONST_FALSE);
+    }
+    else if (term.op == Opcode::VAR) {
+      positive[t] = term.slot;
+      if (needed[t] & 2) negative[t] = target.makeNode(Opcode::NOT, term.slot);
+    }
+    else if (flipped[t] != UNSET) {
+      // Negated XOR: the flipped operand goes last, negated
+      Expression_DAG::Node_Id chain = UNSET;
+      for (uint32_t i = 0; i < term.operands.size(); ++i) {
+        if (i == flipped[t]) continue;
+        const Expression_DAG::Node_Id node = nodeOf(term.operands[i]);
+        chain = chain == UNSET ? node : target.makeNode(Opcode::XOR, chain, node);
+      }
+      negative[t] = target.makeNode(Opcode::XOR, chain, nodeOf(term.operands[flipped[t]] ^ 1));
+    }
+    else {
+      // ((x0 op x1) op x2) ... op last; a negated AND/OR ends in NAND/NOR
+      Expression_DAG::Node_Id chain = nodeOf(term.operands[0]);
+      for (size_t i = 1; i + 1 < term.operands.size(); ++i) {
+        chain = target.makeNode(term.op, chain, nodeOf(term.operands[i]));
+      }
+      const Expression_DAG::Node_Id last = nodeOf(term.operands.back());
+
+      if (needed[t] & 1) {
+        positive[t] = target.makeNode(term.op, chain, last);
+      }
+      if (needed[t] & 2) {
+        switch (term.op) {
+          case Opcode::AND: negative[t] = target.makeNode(Opcode::NAND, chain, last); break;
+          case Opcode::OR:  negative[t] = target.makeNode(Opcode::NOR, chain, last); break;
+          default:          negative[t] = target.makeNode(Opcode::NOT, positive[t]); break;
+        }
+      }
+    }
+  }
+
+  vector<Expression_DAG::Node_Id> simplified;
+  simplified.reserve(roots.size());
+  for (Expression_DAG::Node_Id root : roots) {
+    simplified.push_back(nodeOf(literal[root]));
+  }
+  return simplified;
+}
+
+Expression_DAG::Node_Id Expression_Simplifier::simplify(Expression_DAG::Node_Id root) {
+  return simplify(vector<Expression_DAG::Node_Id>{root}).front();
+}
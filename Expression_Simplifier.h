@@ -0,0 +1,76 @@
+/**
+ * @class Expression_Simplifier
+ * @brief Algebraic simplification and constant folding of an expression graph.
+ *
+ * Copies the subexpressions of one Expression_DAG into another, removing
+ * redundancy on the way. Every node that disappears is one gate less on
+ * every row of a truth table and one gate less in a SAT encoding.
+ *
+ * Internally each subexpression is a term: a variable, TRUE, or an n-ary
+ * AND / OR / XOR over sorted operand literals. A literal is a term plus a
+ * negation bit, so NOT costs nothing and double negation vanishes. Rules:
+ *  - Flattening:   (A AND B) AND C           → AND(A, B, C)
+ *  - Constants:    A AND TRUE → A, A OR TRUE → TRUE, A XOR TRUE → NOT A
+ *  - Idempotence:  A AND A → A, A XOR A → FALSE
+ *  - Complement:   A AND NOT A → FALSE, A OR NOT A → TRUE
+ *  - Absorption:   A AND (A OR B) → A, A OR (A AND B) → A
+ *  - De Morgan:    NOT A AND NOT B → NOT (A OR B)
+ *  - Shared terms are flattened into only one parent, so they stay shared.
+ *
+ * Terms are written back as chains of binary nodes. A negated AND/OR ends
+ * in NAND/NOR, so NOT (x AND y) becomes one NAND node.
+ *
+ * Example: NOT NOT A AND (A OR B) AND (C OR NOT C)  →  A
+ */
+
+#ifndef EXPRESSION_SIMPLIFIER_H
+#define EXPRESSION_SIMPLIFIER_H
+
+#include "Expression_DAG.h"
+
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+class Expression_Simplifier {
+  private:
+    using Literal = uint32_t;                   // term * 2 + 1 if negated
+    static constexpr Literal TRUE_LITERAL = 0;  // term 0 is TRUE
+    static constexpr Literal FALSE_LITERAL = 1;
+
+    struct Term {
+      Opcode op;                 // VAR, CONST_TRUE, AND, OR or XOR
+      uint32_t slot;             // VAR only
+      vector<Literal> operands;  // sorted, at least two
+    };
+
+    // An operand on its way into a term; only single-use operands are
+    // flattened, so subexpressions the graph shares stay shared
+    struct Operand {
+      Literal literal;
+      bool single_use;
+    };
+
+    const Expression_DAG& source;
+    Expression_DAG& target;
+    vector<Term> terms;
+    vector<uint32_t> unique_table;        // open addressing over term ids, like Expression_DAG
+    vector<Literal> list, kept;           // scratch operand lists, reused by every reduction
+
+    Literal makeTerm(Opcode op, const vector<Literal>& operands);
+    void growUniqueTable();
+    Literal reduceAndOr(Opcode op, const vector<Operand>& operands);
+    Literal reduceXor(const vector<Operand>& operands);
+
+  public:
+    // Simplify from source into target; both must have the same variables
+    Expression_Simplifier(const Expression_DAG& source, Expression_DAG& target);
+
+    // Copy the simplified roots into the target graph and return their new
+    // ids (in target); work is shared between roots
+    vector<Expression_DAG::Node_Id> simplify(const vector<Expression_DAG::Node_Id>& roots);
+    Expression_DAG::Node_Id simplify(Expression_DAG::Node_Id root);
+};
+
+#endif //EXPRESSION_SIMPLIFIER_H
@@ -0,0 +1,408 @@
+/**
+ * @file Jit_Kernel.cpp
+ * @brief x86-64 code generation for the bit-sliced gates.
+ *
+ * Per gate k (value v = variables + k):
+ *   1) find the operands: a register still holding the value, or the
+ *      memory operand [rdi + value * stride] (rdi = the buffer)
+ *   2) compute into a free register (round-robin over the pool)
+ *   3) store the register to [rdi + v * stride] and remember that it holds v
+ *
+ * Only the encodings needed here are implemented: 64-bit GPR forms with a
+ * REX prefix, VEX (AVX2) and EVEX (AVX-512). Memory operands always use
+ * [rdi + disp32], so no SIB byte or compressed displacement is involved.
+ */
+
+#include "Jit_Kernel.h"
+
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__x86_64__) && (defined(__linux__) || defined(__FreeBSD__) || defined(__NetBSD__) || defined(__OpenBSD__))
+#define JIT_KERNEL_SUPPORTED 1
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+constexpr unsigned BUFFER_REGISTER = 7;   // rdi: first argument (System V)
+
+// A gate operand: a register, or [rdi + displacement]
+struct Operand {
+  bool in_register;
+  unsigned reg;
+  int32_t displacement;
+};
+
+// Machine code bytes plus the few encodings the kernels use
+class Emitter {
+  public:
+    vector<uint8_t> bytes;
+
+    void byte(uint8_t value) {
+      bytes.push_back(value);
+    }
+
+    void dword(uint32_t value) {
+      for (int i = 0; i < 4; ++i) {
+        byte(static_cast<uint8_t>(value >> (8 * i)));
+      }
+    }
+
+    // ModRM (and disp32) for reg and an r/m operand
+    void modrm(unsigned reg, const Operand& rm) {
+      if (rm.in_register) {
+        byte(static_cast<uint8_t>(0xC0 | (reg & 7) << 3 | (rm.reg & 7)));
+      }
+      else {
+        byte(static_cast<uint8_t>(0x80 | (reg & 7) << 3 | BUFFER_REGISTER));
+        dword(static_cast<uint32_t>(rm.displacement));
+      }
+    }
+
+    // op r64, r/m64 (REX.W)
+    void gpr(uint8_t opcode, unsigned reg, const Operand& rm) {
+      const unsigned base = rm.in_register ? rm.reg : BUFFER_REGISTER;
+      byte(static_cast<uint8_t>(0x48 | (reg >> 3) << 2 | (base >> 3)));
+      byte(opcode);
+      modrm(reg, rm);
+    }
+
+    // Three-byte VEX, 256-bit, map 0F: op reg, vvvv, r/m
+    void vex(uint8_t prefix, uint8_t opcode, unsigned reg, unsigned vvvv, const Operand& rm) {
+      const unsigned base = rm.in_register ? rm.reg : BUFFER_REGISTER;
+      byte(0xC4);
+      byte(static_cast<uint8_t>((~reg >> 3 & 1) << 7 | 1 << 6 | (~base >> 3 & 1) << 5 | 0x01));
+      byte(static_cast<uint8_t>((~vvvv & 15) << 3 | 1 << 2 | prefix));
+      byte(opcode);
+      modrm(reg, rm);
+    }
+
+    // EVEX, 512-bit, W1, no masking: op reg, vvvv, r/m (registers 0-15)
+    void evex(uint8_t prefix, uint8_t map, uint8_t opcode, unsigned reg, unsigned vvvv, const Operand& rm) {
+      const unsigned base = rm.in_register ? rm.reg : BUFFER_REGISTER;
+      byte(0x62);
+      byte(static_cast<uint8_t>((~reg >> 3 & 1) << 7 | 1 << 6 | (~base >> 3 & 1) << 5 | 1 << 4 | map));
+      byte(static_cast<uint8_t>(1 << 7 | (~vvvv & 15) << 3 | 1 << 2 | prefix));
+      byte(static_cast<uint8_t>(2 << 5 | 1 << 3));
+      byte(opcode);
+      modrm(reg, rm);
+    }
+};
+
+// SIMD prefix field values (pp) and EVEX opcode maps
+constexpr uint8_t PREFIX_66 = 1;
+constexpr uint8_t PREFIX_F3 = 2;
+constexpr uint8_t MAP_0F = 1;
+constexpr uint8_t MAP_0F3A = 3;
+
+/**
+ * @brief Which recent values are still in registers.
+ * Every value is also in the buffer, so evicting one costs nothing.
+ */
+class Register_Cache {
+  private:
+    static constexpr uint32_t EMPTY = UINT32_MAX;
+    vector<int8_t> where;       // value → register, or -1
+    vector<unsigned> pool;      // allocatable registers
+    vector<uint32_t> holder;    // pool position → value held, or EMPTY
+    size_t next = 0;
+
+  public:
+    Register_Cache(size_t values, vector<unsigned> registers)
+        : where(values, -1), pool(move(registers)), holder(pool.size(), EMPTY) {}
+
+    // Forget every register (at the start of a function)
+    void reset() {
+      for (uint32_t& value : holder) {
+        if (value != EMPTY) where[value] = -1;
+        value = EMPTY;
+      }
+      next = 0;
+    }
+
+    Operand operand(uint32_t value, size_t stride) const {
+      if (where[value] >= 0) {
+        return {true, pool[where[value]], 0};
+      }
+      return {false, 0, static_cast<int32_t>(value * stride)};
+    }
+
+    // Next register round-robin, never one of the current operands
+    unsigned allocate(const Operand& keep_a, const Operand& keep_b) {
+      for (;;) {
+        const size_t position = next;
+        next = (next + 1) % pool.size();
+        const unsigned reg = pool[position];
+        if ((keep_a.in_register && keep_a.reg == reg) || (keep_b.in_register && keep_b.reg == reg)) {
+          continue;
+        }
+        if (holder[position] != EMPTY) {
+          where[holder[position]] = -1;
+          holder[position] = EMPTY;
+        }
+        return reg;
+      }
+    }
+
+    void bind(unsigned reg, uint32_t value) {
+      for (size_t position = 0; position < pool.size(); ++position) {
+        if (pool[position] == reg) {
+          holder[position] = value;
+          where[value] = static_cast<int8_t>(position);
+          return;
+        }
+      }
+    }
+};
+
+// Binary gates are commutative: put an operand already in a register first
+static void registerFirst(Operand& a, Operand& b) {
+  if (!a.in_register && b.in_register) {
+    swap(a, b);
+  }
+}
+
+/**
+ * @brief One gate on 64-bit general registers (rax, rcx, rdx, rsi, r8-r11).
+ */
+static void emitScalarGate(Emitter& out, Opcode op, Operand a, Operand b, unsigned d) {
+  const Operand dest = {true, d, 0};
+  switch (op) {
+    case Opcode::CONST_TRUE:
+      out.byte(static_cast<uint8_t>(0x48 | (d >> 3)));                 // mov d, -1
+      out.byte(0xC7);
+      out.byte(static_cast<uint8_t>(0xC0 | (d & 7)));
+      out.dword(0xFFFFFFFFu);
+      return;
+    case Opcode::NOT:
+      out.gpr(0x8B, d, a);                                              // mov d, a
+      break;
+    case Opcode::AND: case Opcode::OR: case Opcode::XOR: case Opcode::NAND: case Opcode::NOR: {
+      registerFirst(a, b);
+      out.gpr(0x8B, d, a);                                              // mov d, a
+      const uint8_t opcode = op == Opcode::XOR ? 0x33
+                           : (op == Opcode::OR || op == Opcode::NOR) ? 0x0B : 0x23;
+      out.gpr(opcode, d, b);                                            // and/or/xor d, b
+      if (op != Opcode::NAND && op != Opcode::NOR) return;
+      break;
+    }
+    default:
+      out.gpr(0x33, d, dest);                                           // xor d, d
+      return;
+  }
+  out.byte(static_cast<uint8_t>(0x48 | (d >> 3)));                     // not d
+  out.byte(0xF7);
+  out.byte(static_cast<uint8_t>(0xC0 | 2 << 3 | (d & 7)));
+}
+
+// AVX2: ymm15 holds all ones for the whole function
+constexpr unsigned AVX2_ONES = 15;
+
+/**
+ * @brief One gate on ymm registers (vpand / vpor / vpxor; NOT is XOR with ones).
+ */
+static void emitAvx2Gate(Emitter& out, Opcode op, Operand a, Operand b, unsigned d) {
+  const Operand dest = {true, d, 0};
+  switch (op) {
+    case Opcode::CONST_TRUE:
+      out.vex(PREFIX_66, 0x76, d, d, dest);                             // vpcmpeqd d, d, d
+      return;
+    case Opcode::NOT:
+      out.vex(PREFIX_66, 0xEF, d, AVX2_ONES, a);                        // vpxor d, ones, a
+      return;
+    case Opcode::AND: case Opcode::OR: case Opcode::XOR: case Opcode::NAND: case Opcode::NOR: {
+      registerFirst(a, b);
+      if (!a.in_register) {
+        out.vex(PREFIX_F3, 0x6F, d, 0, a);                              // vmovdqu d, [a]
+        a = dest;
+      }
+      const uint8_t opcode = op == Opcode::XOR ? 0xEF
+                           : (op == Opcode::OR || op == Opcode::NOR) ? 0xEB : 0xDB;
+      out.vex(PREFIX_66, opcode, d, a.reg, b);                          // vpand/vpor/vpxor d, a, b
+      if (op == Opcode::NAND || op == Opcode::NOR) {
+        out.vex(PREFIX_66, 0xEF, d, AVX2_ONES, dest);                   // vpxor d, ones, d
+      }
+      return;
+    }
+    default:
+      out.vex(PREFIX_66, 0xEF, d, d, dest);                             // vpxor d, d, d
+      return;
+  }
+}
+
+/**
+ * @brief One gate on zmm registers: a single vpternlogq whose immediate is
+ * the gate's truth table over (B, C) = (0xCC, 0xAA).
+ */
+static void emitAvx512Gate(Emitter& out, Opcode op, Operand a, Operand b, unsigned d) {
+  const Operand dest = {true, d, 0};
+  uint8_t table;
+  switch (op) {
+    case Opcode::CONST_TRUE: table = 0xFF; a = b = dest; break;
+    case Opcode::NOT:        table = 0x55; b = a; a = dest; break;     // ~C
+    case Opcode::AND:        table = 0x88; break;
+    case Opcode::OR:         table = 0xEE; break;
+    case Opcode::XOR:        table = 0x66; break;
+    case Opcode::NAND:       table = 0x77; break;
+    case Opcode::NOR:        table = 0x11; break;
+    default:                 table = 0x00; a = b = dest; break;
+  }
+  registerFirst(a, b);
+  if (!a.in_register) {
+    out.evex(PREFIX_F3, MAP_0F, 0x6F, d, 0, a);                         // vmovdqu64 d, [a]
+    a = dest;
+  }
+  out.evex(PREFIX_66, MAP_0F3A, 0x25, d, a.reg, b);                     // vpternlogq d, a, b, table
+  out.byte(table);
+}
+
+/**
+ * @brief Emit one function running the given instructions in order.
+ */
+static void emitFunction(Emitter& out, Register_Cache& cache, const Compiled_Program& program,
+                         size_t block_words, const Jit_Kernel::Order& order) {
+  const vector<Instruction>& code = program.getCode();
+  const uint32_t variable_count = static_cast<uint32_t>(program.getVariables().size());
+  const size_t stride = block_words * 8;
+  cache.reset();
+
+  if (block_words == 4) {
+    const Operand ones = {true, AVX2_ONES, 0};
+    out.vex(PREFIX_66, 0x76, AVX2_ONES, AVX2_ONES, ones);               // vpcmpeqd ones, ones, ones
+  }
+
+  for (size_t i = 0; i < order.second; ++i) {
+    const uint32_t k = order.first ? order.first[i] : static_cast<uint32_t>(i);
+    const Instruction& ins = code[k];
+    const uint32_t value = variable_count + k;
+
+    const unsigned operands = Expression_DAG::operandCount(ins.op);
+    const Operand none = {false, 0, 0};
+    const Operand a = operands >= 1 ? cache.operand(ins.a, stride) : none;
+    const Operand b = operands == 2 ? cache.operand(ins.b, stride) : a;
+    const unsigned d = cache.allocate(a, b);
+    const Operand target = {false, 0, static_cast<int32_t>(value * stride)};
+
+    switch (block_words) {
+      case 1:
+        emitScalarGate(out, ins.op, a, b, d);
+        out.gpr(0x89, d, target);                                       // mov [v], d
+        break;
+      case 4:
+        emitAvx2Gate(out, ins.op, a, b, d);
+        out.vex(PREFIX_F3, 0x7F, d, 0, target);                         // vmovdqu [v], d
+        break;
+      default:
+        emitAvx512Gate(out, ins.op, a, b, d);
+        out.evex(PREFIX_F3, MAP_0F, 0x7F, d, 0, target);                // vmovdqu64 [v], d
+        break;
+    }
+    cache.bind(d, value);
+  }
+
+  if (block_words != 1) {
+    out.byte(0xC5);                                                     // vzeroupper
+    out.byte(0xF8);
+    out.byte(0x77);
+  }
+  out.byte(0xC3);                                                       // ret
+}
+
+} // namespace
+
+bool Jit_Kernel::isSupported() {
+#ifdef JIT_KERNEL_SUPPORTED
+  return true;
+#else
+  return false;
+#endif
+}
+
+// Constructor : generate every function, then map the code executable
+Jit_Kernel::Jit_Kernel(const Compiled_Program& program, size_t block_words, const vector<Order>& orders) {
+  if (!isSupported()) {
+    throw runtime_error("Native code generation needs x86-64 Linux or BSD");
+  }
+  if (block_words != 1 && block_words != 4 && block_words != 8) {
+    throw invalid_argument("Unsupported block width " + to_string(block_words));
+  }
+  const size_t values = program.getVariables().size() + program.getStepCount();
+  if (values * block_words * 8 > size_t(INT32_MAX)) {
+    throw invalid_argument("Program too large for 32-bit buffer offsets");
+  }
+
+  // rax, rcx, rdx, rsi, r8-r11; ymm0-14 (ymm15 is the ones register); zmm0-15
+  vector<unsigned> registers = {0, 1, 2, 6, 8, 9, 10, 11};
+  if (block_words != 1) {
+    registers.clear();
+    for (unsigned reg = 0; reg < (block_words == 4 ? AVX2_ONES : 16u); ++reg) {
+      registers.push_back(reg);
+    }
+  }
+  Register_Cache cache(values, registers);
+
+  Emitter out;
+  vector<size_t> offsets;
+  for (const Order& order : orders) {
+    // Functions start on 16-byte boundaries; the gaps are int3
+    while (out.bytes.size() % 16) {
+      out.byte(0xCC);
+    }
+    const size_t start = out.bytes.size();
+    emitFunction(out, cache, program, block_words, order);
+    if (out.bytes.size() > MAX_CODE_BYTES) {
+      out.bytes.resize(start);
+      offsets.push_back(SIZE_MAX);
+    }
+    else {
+      offsets.push_back(start);
+    }
+  }
+  code_bytes = out.bytes.size();
+  entries.assign(orders.size(), nullptr);
+  if (code_bytes == 0) {
+    return;
+  }
+
+#ifdef JIT_KERNEL_SUPPORTED
+  // Written while writable, then switched to read + execute (never both)
+  const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  mapped_bytes = (code_bytes + page - 1) / page * page;
+  void* mapped = mmap(nullptr, mapped_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (mapped == MAP_FAILED) {
+    throw runtime_error("Could not map memory for native code");
+  }
+  memory = static_cast<uint8_t*>(mapped);
+  memcpy(memory, out.bytes.data(), code_bytes);
+  if (mprotect(memory, mapped_bytes, PROT_READ | PROT_EXEC) != 0) {
+    munmap(memory, mapped_bytes);
+    memory = nullptr;
+    throw runtime_error("Could not make native code executable");
+  }
+  for (size_t i = 0; i < offsets.size(); ++i) {
+    if (offsets[i] != SIZE_MAX) {
+      entries[i] = reinterpret_cast<Entry>(memory + offsets[i]);
+    }
+  }
+#endif
+}
+
+Jit_Kernel::~Jit_Kernel() {
+#ifdef JIT_KERNEL_SUPPORTED
+  if (memory) {
+    munmap(memory, mapped_bytes);
+  }
+#endif
+}
+
+Jit_Kernel::Entry Jit_Kernel::getEntry(size_t index) const {
+  return entries[index];
+}
+
+size_t Jit_Kernel::getCodeBytes() const {
+  return code_bytes;
+}
@@ -0,0 +1,74 @@
+/**
+ * @class Jit_Kernel
+ * @brief Native x86-64 code for a Compiled_Program's bit-sliced gates.
+ *
+ * The Bitslice_Evaluator kernels interpret the program: every gate costs a
+ * switch on its opcode and loads of its operand indices. A Jit_Kernel
+ * translates an instruction order once into straight-line machine code in
+ * which each gate is one or two bitwise instructions on fixed buffer
+ * offsets, and emits it into its own mmap'd pages (written, then made
+ * read-only and executable).
+ *
+ * One function is emitted per order (the full program, or the cone of one
+ * changing variable), each taking the evaluator's buffer:
+ *
+ *   block words 1 : 64-bit general registers  (and, or, xor, not)
+ *   block words 4 : AVX2 ymm registers        (vpand, vpor, vpxor)
+ *   block words 8 : AVX-512 zmm registers     (vpternlogq)
+ *
+ * The last 8–15 results stay in registers, so an operand computed just
+ * before is not reloaded; every step is still stored, since tables read
+ * the step columns. Only x86-64 Linux and BSD with the System V calling
+ * convention are supported (isSupported()); elsewhere the evaluator keeps
+ * interpreting.
+ */
+
+#ifndef JIT_KERNEL_H
+#define JIT_KERNEL_H
+
+#include "Compiled_Program.h"
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+class Jit_Kernel {
+  public:
+    // Generated function: runs its instructions over the evaluator buffer
+    using Entry = void (*)(uint64_t* buffer);
+
+    // Instructions to translate: order[0 .. count), or 0 .. count when
+    // order is null (as in Bitslice_Evaluator::run())
+    using Order = pair<const uint32_t*, size_t>;
+
+    // Machine code emitted for one program, at most; orders past it are
+    // left to the interpreter
+    static constexpr size_t MAX_CODE_BYTES = size_t(64) << 20;
+
+  private:
+    uint8_t* memory = nullptr;    // mapped pages (executable once built)
+    size_t mapped_bytes = 0;
+    size_t code_bytes = 0;
+    vector<Entry> entries;        // one per order; null if it did not fit
+
+  public:
+    // Translate every order for block_words words per bit vector (1, 4 or
+    // 8). Throws runtime_error if the platform or the mapping fails, and
+    // invalid_argument for an unsupported width or an oversized buffer.
+    Jit_Kernel(const Compiled_Program& program, size_t block_words, const vector<Order>& orders);
+    ~Jit_Kernel();
+
+    Jit_Kernel(const Jit_Kernel&) = delete;
+    Jit_Kernel& operator=(const Jit_Kernel&) = delete;
+
+    // True when this build can generate and run native code
+    static bool isSupported();
+
+    // Function for orders[index], or null if it exceeded MAX_CODE_BYTES
+    Entry getEntry(size_t index) const;
+    size_t getCodeBytes() const;
+};
+
+#endif //JIT_KERNEL_H
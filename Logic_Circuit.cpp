@@ -0,0 +1,233 @@
+/**
+ * @file Logic_Circuit.cpp
+ * @brief Builds one expression graph for several outputs and evaluates
+ *        them together.
+ * Flow:
+ *   1) the variables of all outputs, sorted, are the shared input slots
+ *   2) every output is interned into one Expression_DAG (optionally
+ *      simplified together), so common subterms become one node
+ *   3) the graph is compiled once for all roots; a row or a bit-sliced
+ *      block then yields every output
+ */
+
+#include "Logic_Circuit.h"
+#include "Bitslice_Evaluator.h"
+#include "Expression_Simplifier.h"
+#include "Ordered_Chunk_Writer.h"
+#include "Run_Stats.h"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+using namespace std;
+
+// Set bits in a word
+static inline uint64_t popcount64(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_popcountll(word);
+#else
+  uint64_t count = 0;
+  for (; word; word &= word - 1) ++count;
+  return count;
+#endif
+}
+
+/**
+ * @brief Operator nodes reachable from root: the steps the output would
+ * compile to on its own. mark is scratch, one entry per node.
+ */
+static size_t coneSize(const Expression_DAG& dag, Expression_DAG::Node_Id root, vector<bool>& mark) {
+  const size_t n = dag.getVariables().size();
+  fill(mark.begin(), mark.end(), false);
+  mark[root] = true;
+  size_t count = 0;
+  for (size_t id = root + 1; id-- > n; ) {
+    if (!mark[id]) continue;
+    ++count;
+    const Expression_DAG::Node& node = dag.getNode(static_cast<Expression_DAG::Node_Id>(id));
+    const unsigned operands = Expression_DAG::operandCount(node.op);
+    if (operands >= 1) mark[node.a] = true;
+    if (operands == 2) mark[node.b] = true;
+  }
+  return count;
+}
+
+// Constructor : intern every output into one graph and compile it once
+Logic_Circuit::Logic_Circuit(const vector<const Boolean_Expression*>& expressions, const vector<string>& names,
+                             bool simplify)
+  : output_names(names) {
+  if (expressions.empty()) {
+    throw invalid_argument("A circuit needs at least one output");
+  }
+  if (names.size() != expressions.size()) {
+    throw invalid_argument("A circuit needs one name per output");
+  }
+
+  {
+    Run_Stats::Scope scope(Run_Stats::Phase::DETECT_VARIABLES);
+    used_variables = Truth_Table::collectVariables(expressions);
+  }
+  const size_t n = used_variables.size();
+  if (n > Truth_Table::MAX_VARIABLES) {
+    throw invalid_argument("Too many variables (" + to_string(n) + "), at most " +
+                           to_string(Truth_Table::MAX_VARIABLES) + " are supported");
+  }
+  last_row = (n == 64) ? ~0ull : (1ull << n) - 1;
+
+  Run_Stats::Scope scope(Run_Stats::Phase::COMPILE);
+  Expression_DAG dag(used_variables);
+  vector<Expression_DAG::Node_Id> roots;
+  for (const Boolean_Expression* expression : expressions) {
+    roots.push_back(expression->buildGraph(dag));
+  }
+
+  // Simplify all roots in one pass, so terms they share are reduced once
+  // and stay one node
+  Expression_DAG simplified(used_variables);
+  const Expression_DAG* graph = &dag;
+  if (simplify) {
+    Expression_Simplifier simplifier(dag, simplified);
+    roots = simplifier.simplify(roots);
+    graph = &simplified;
+  }
+
+  vector<bool> mark(graph->getNodeCount());
+  for (Expression_DAG::Node_Id root : roots) {
+    separate_steps += coneSize(*graph, root, mark);
+  }
+  program = Compiled_Program::compile(*graph, roots);
+  Run_Stats::add(Run_Stats::Counter::NODES, graph->getNodeCount() - n);
+}
+
+const vector<string>& Logic_Circuit::getVariables() const {
+  return used_variables;
+}
+
+const vector<string>& Logic_Circuit::getOutputNames() const {
+  return output_names;
+}
+
+const Compiled_Program& Logic_Circuit::getProgram() const {
+  return program;
+}
+
+uint64_t Logic_Circuit::getLastRow() const {
+  return last_row;
+}
+
+size_t Logic_Circuit::getOutputCount() const {
+  return output_names.size();
+}
+
+size_t Logic_Circuit::getStepCount() const {
+  return program.getStepCount();
+}
+
+size_t Logic_Circuit::getSeparateStepCount() const {
+  return separate_steps;
+}
+
+/**
+ * @brief Run the shared program once and read every output's value.
+ * An output may be a variable (value index below n) or any step.
+ */
+void Logic_Circuit::evaluate(const bool* inputs, bool* steps, bool* outputs) const {
+  program.evaluate(inputs, steps);
+  const uint32_t n = static_cast<uint32_t>(used_variables.size());
+  const vector<uint32_t>& indices = program.getOutputIndices();
+  for (size_t k = 0; k < indices.size(); ++k) {
+    outputs[k] = indices[k] < n ? inputs[indices[k]] : steps[indices[k] - n];
+  }
+}
+
+/**
+ * @brief Enumerate the rows once, block by block in Gray-code order (as
+ * Truth_Table::countTrue() does for one output), and popcount every
+ * output's vector in each block.
+ */
+vector<uint64_t> Logic_Circuit::countTrue() const {
+  if (used_variables.size() >= Truth_Table::MAX_VARIABLES) {
+    throw length_error("Counting needs fewer than " + to_string(Truth_Table::MAX_VARIABLES) + " variables");
+  }
+
+  Bitslice_Evaluator evaluator(program);
+  const size_t words = evaluator.getBlockWords();
+  vector<uint64_t> block(evaluator.getBufferWords());
+  const vector<uint32_t>& outputs = program.getOutputIndices();
+  const uint64_t total_words = last_row / 64 + 1;
+  const uint64_t block_count = (total_words + words - 1) / words;
+  vector<uint64_t> counts(outputs.size(), 0);
+
+  evaluator.forEachBlock(0, block_count, block.data(), [&](uint64_t index, const uint64_t* buffer) {
+    const uint64_t word = index * words;
+    const uint64_t used = min<uint64_t>(words, total_words - word);
+    for (size_t k = 0; k < outputs.size(); ++k) {
+      const uint64_t* column = buffer + outputs[k] * words;
+      for (uint64_t w = 0; w < used; ++w) {
+        uint64_t bits = column[w];
+        // Only the rows up to last_row count
+        if (word + w == total_words - 1 && last_row % 64 != 63)
+          bits &= (1ull << (last_row % 64 + 1)) - 1;
+        counts[k] += popcount64(bits);
+      }
+    }
+  });
+  Run_Stats::add(Run_Stats::Counter::ROWS, last_row + 1);
+  return counts;
+}
+
+/**
+ * @brief Print the combined table: variables, then one column per output.
+ * Chunks of ROWS_PER_CHUNK rows are evaluated block by block (each block
+ * after the first re-runs only the cones of the variables that changed)
+ * and written in row order, in parallel with threads != 1, like
+ * Truth_Table::displayTable().
+ */
+void Logic_Circuit::displayTable(const Table_Options& options) const {
+  Table_Writer output(options.format, used_variables, output_names, program.getOutputIndices());
+  if (options.sink)
+    output.open(options.sink);
+  else
+    output.open(options.output_path);
+  cout.flush(); // keep console text ahead of table rows on stdout
+  output.writeHeader();
+
+  Bitslice_Evaluator evaluator(program);
+  const uint64_t block_rows = evaluator.getBlockRows();
+
+  Ordered_Chunk_Writer writer(options.threads, Truth_Table::CHUNK_WINDOW);
+  vector<vector<uint64_t>> blocks(writer.getThreadCount(),
+                                  vector<uint64_t>(evaluator.getBufferWords()));
+  const uint64_t chunk_count = last_row / ROWS_PER_CHUNK + 1;
+
+  writer.run(chunk_count,
+    [&](unsigned worker, uint64_t chunk, string& out) {
+      const uint64_t first = chunk * ROWS_PER_CHUNK;
+      const uint64_t last = min(last_row, first + (ROWS_PER_CHUNK - 1));
+      vector<uint64_t>& block = blocks[worker];
+      Run_Stats::Scope scope(Run_Stats::Phase::FORMAT_ROWS);   // the whole chunk, not each block
+      Run_Stats::add(Run_Stats::Counter::BLOCKS, (last - first) / block_rows + 1);
+
+      // Inclusive end, so 2^64 rows cannot overflow
+      for (uint64_t block_first = first; ; block_first += block_rows) {
+        if (block_first == first)
+          evaluator.evaluateBlock(block_first, block.data());
+        else
+          evaluator.updateBlock(block_first - block_rows, block_first, block.data());
+
+        const uint64_t block_last = min(last, block_first + (block_rows - 1));
+        output.appendRows(block.data(), evaluator.getBlockWords(), 0, block_last - block_first, out);
+
+        if (block_last == last)
+          break;
+      }
+    },
+    [&](const string& data) {
+      Run_Stats::Scope scope(Run_Stats::Phase::OUTPUT);
+      output.write(data);
+      Run_Stats::add(Run_Stats::Counter::OUTPUT_BYTES, data.size());
+    });
+  output.flush();
+  Run_Stats::add(Run_Stats::Counter::ROWS, last_row + 1);
+}
@@ -0,0 +1,75 @@
+/**
+ * @class Logic_Circuit
+ * @brief Several expressions over the same variables, compiled and
+ *        evaluated together as one multi-output circuit.
+ *
+ * A separate Truth_Table per rule enumerates the input space once per rule
+ * and evaluates every shared subterm once per rule. A circuit interns all
+ * the outputs into one Expression_DAG, so a subexpression that appears in
+ * several rules (in any operand order) is one node, and compiles them into
+ * one Compiled_Program whose instructions serve every output:
+ *
+ *   F = (A AND B) OR C        steps: (A AND B), ((A AND B) OR C),
+ *   G = (B AND A) XOR D              ((A AND B) XOR D)
+ *
+ * Rows are then evaluated once for all outputs, per row (evaluate()) or
+ * per bit-sliced block (countTrue(), displayTable()). The combined table
+ * has one column per variable and one per output.
+ *
+ * With simplify, the outputs are simplified together (Expression_Simplifier
+ * over all roots at once), so the shared terms stay shared.
+ */
+
+#ifndef LOGIC_CIRCUIT_H
+#define LOGIC_CIRCUIT_H
+
+#include "Boolean_Expression.h"
+#include "Truth_Table.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class Logic_Circuit {
+  private:
+    vector<string> output_names;
+    vector<string> used_variables;    // union of the outputs' variables, sorted
+    uint64_t last_row = 0;            // index of the final row (2^n - 1)
+    Compiled_Program program;         // every output; shared steps compiled once
+    size_t separate_steps = 0;        // steps if each output were compiled alone
+
+  public:
+    // Rows per output chunk when printing (as in Truth_Table)
+    static constexpr uint64_t ROWS_PER_CHUNK = Truth_Table::ROWS_PER_CHUNK;
+
+    // expressions[i] is output i, shown as names[i]; the expressions must
+    // parse. Throws invalid_argument for no outputs, mismatched names or
+    // more than 64 variables.
+    Logic_Circuit(const vector<const Boolean_Expression*>& expressions, const vector<string>& names,
+                  bool simplify = false);
+
+    const vector<string>& getVariables() const;
+    const vector<string>& getOutputNames() const;
+    const Compiled_Program& getProgram() const;
+    uint64_t getLastRow() const;
+    size_t getOutputCount() const;
+
+    // Instructions per row for all outputs together, and what compiling
+    // each output on its own would have needed in total
+    size_t getStepCount() const;
+    size_t getSeparateStepCount() const;
+
+    // Evaluate one row for every output. inputs[i] is variable i, steps
+    // is scratch of getProgram().getStepCount() entries, outputs receives
+    // getOutputCount() values. Never allocates.
+    void evaluate(const bool* inputs, bool* steps, bool* outputs) const;
+
+    // True rows of every output, from one enumeration (fewer than 64 variables)
+    vector<uint64_t> countTrue() const;
+
+    // One table: the variables, then one column per output
+    void displayTable(const Table_Options& options = Table_Options()) const;
+};
+
+#endif //LOGIC_CIRCUIT_H
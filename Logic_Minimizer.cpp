@@ -0,0 +1,617 @@
+/**
+ * @file Logic_Minimizer.cpp
+ * @brief Quine–McCluskey (exact) and Espresso-style (heuristic) minimizers.
+ *
+ * Cube operations used throughout (bit j = variable j):
+ *   merge     : same care, values differ in one cared bit → drop that bit
+ *   a ⊆ b     : b cares only where a does, and agrees there
+ *   covers m  : ((m ^ value) & care) == 0 for a minterm m
+ */
+
+#include "Logic_Minimizer.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace std;
+
+namespace {
+
+/**
+ * @brief Open-addressing set of cubes; each cube gets a dense index so
+ * per-cube flags can live in a plain vector.
+ */
+class Cube_Table {
+  private:
+    vector<Logic_Minimizer::Cube> cubes;
+    vector<uint32_t> slots;   // cube index + 1, 0 = empty
+
+    static size_t hash(const Logic_Minimizer::Cube& cube) {
+      uint64_t h = cube.care * 0x9E3779B97F4A7C15ull ^ cube.value * 0xC2B2AE3D27D4EB4Full;
+      return static_cast<size_t>(h ^ (h >> 29));
+    }
+
+    void grow() {
+      slots.assign(max<size_t>(64, slots.size() * 2), 0);
+      for (uint32_t i = 0; i < cubes.size(); ++i) {
+        size_t slot = hash(cubes[i]) & (slots.size() - 1);
+        while (slots[slot]) slot = (slot + 1) & (slots.size() - 1);
+        slots[slot] = i + 1;
+      }
+    }
+
+  public:
+    // Index of the cube, or -1
+    long find(const Logic_Minimizer::Cube& cube) const {
+      if (slots.empty()) return -1;
+      for (size_t slot = hash(cube) & (slots.size() - 1); slots[slot]; slot = (slot + 1) & (slots.size() - 1)) {
+        const Logic_Minimizer::Cube& other = cubes[slots[slot] - 1];
+        if (other.care == cube.care && other.value == cube.value) return slots[slot] - 1;
+      }
+      return -1;
+    }
+
+    // Add the cube unless it is already present
+    void insert(const Logic_Minimizer::Cube& cube) {
+      if (find(cube) >= 0) return;
+      cubes.push_back(cube);
+      if (cubes.size() * 2 > slots.size()) {
+        grow();
+        return;
+      }
+      size_t slot = hash(cube) & (slots.size() - 1);
+      while (slots[slot]) slot = (slot + 1) & (slots.size() - 1);
+      slots[slot] = static_cast<uint32_t>(cubes.size());
+    }
+
+    const vector<Logic_Minimizer::Cube>& items() const {
+      return cubes;
+    }
+};
+
+inline unsigned bitCount(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<unsigned>(__builtin_popcountll(word));
+#else
+  unsigned count = 0;
+  for (; word; word &= word - 1) ++count;
+  return count;
+#endif
+}
+
+inline uint64_t highestBit(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+  return 1ull << (63 - __builtin_clzll(word));
+#else
+  while (word & (word - 1)) word &= word - 1;
+  return word;
+#endif
+}
+
+inline bool covers(const Logic_Minimizer::Cube& cube, uint64_t minterm) {
+  return ((minterm ^ cube.value) & cube.care) == 0;
+}
+
+inline bool contains(const Logic_Minimizer::Cube& outer, const Logic_Minimizer::Cube& inner) {
+  return (outer.care & ~inner.care) == 0 && ((outer.value ^ inner.value) & outer.care) == 0;
+}
+
+// Cost of a cover: fewer terms first, then fewer literals
+inline uint64_t coverCost(const vector<Logic_Minimizer::Cube>& cover) {
+  return cover.size() * 4096 + Logic_Minimizer::literalCount(cover);
+}
+
+/**
+ * @brief Branch-and-bound search for the cheapest set of primes covering
+ * every minterm. Branches on the uncovered minterm with the fewest covering
+ * primes; gives up (keeping the best cover so far) after a fixed budget.
+ */
+class Cover_Search {
+  private:
+    const vector<Logic_Minimizer::Cube>& primes;
+    const vector<uint64_t>& minterms;
+    vector<vector<uint32_t>> covering;   // minterm → primes covering it
+    vector<vector<uint32_t>> covered;    // prime → minterms it covers
+    vector<uint32_t> covered_count;      // how many chosen primes cover each minterm
+    size_t uncovered;
+    vector<uint32_t> chosen;
+    size_t budget = 20000;
+
+    void choose(uint32_t prime, int delta) {
+      for (uint32_t m : covered[prime]) {
+        if (delta > 0 && covered_count[m]++ == 0) --uncovered;
+        if (delta < 0 && --covered_count[m] == 0) ++uncovered;
+      }
+    }
+
+    uint64_t cost(const vector<uint32_t>& selection) const {
+      uint64_t literals = 0;
+      for (uint32_t p : selection) literals += bitCount(primes[p].care);
+      return selection.size() * 4096 + literals;
+    }
+
+    void search() {
+      if (budget == 0) return;
+      --budget;
+
+      // Bound: even one more prime cannot beat the best cover
+      if (!best.empty() && cost(chosen) >= best_cost) return;
+
+      if (uncovered == 0) {
+        best = chosen;
+        best_cost = cost(chosen);
+        return;
+      }
+
+      // Uncovered minterm with the fewest options
+      size_t pick = minterms.size();
+      for (size_t m = 0; m < minterms.size(); ++m) {
+        if (covered_count[m] == 0 && (pick == minterms.size() || covering[m].size() < covering[pick].size())) {
+          pick = m;
+          if (covering[m].size() == 1) break;
+        }
+      }
+
+      for (uint32_t prime : covering[pick]) {
+        chosen.push_back(prime);
+        choose(prime, +1);
+        search();
+        choose(prime, -1);
+        chosen.pop_back();
+      }
+    }
+
+  public:
+    vector<uint32_t> best;
+    uint64_t best_cost = 0;
+
+    Cover_Search(const vector<Logic_Minimizer::Cube>& primes, const vector<uint64_t>& minterms)
+        : primes(primes), minterms(minterms), covering(minterms.size()), covered(primes.size()),
+          covered_count(minterms.size(), 0), uncovered(minterms.size()) {
+      for (size_t m = 0; m < minterms.size(); ++m) {
+        for (uint32_t p = 0; p < primes.size(); ++p) {
+          if (covers(primes[p], minterms[m])) {
+            covering[m].push_back(p);
+            covered[p].push_back(static_cast<uint32_t>(m));
+          }
+        }
+        // Larger primes first: the first complete cover is already good
+        sort(covering[m].begin(), covering[m].end(), [&](uint32_t a, uint32_t b) {
+          return bitCount(primes[a].care) < bitCount(primes[b].care);
+        });
+      }
+    }
+
+    void run() {
+      search();
+    }
+};
+
+} // namespace
+
+size_t Logic_Minimizer::literalCount(const vector<Cube>& cover) {
+  size_t literals = 0;
+  for (const Cube& cube : cover) literals += bitCount(cube.care);
+  return literals;
+}
+
+/**
+ * @brief Exact minimization (Quine–McCluskey).
+ *  1) Minterms from the on-set bitset
+ *  2) Merge implicants level by level; those never merged are prime
+ *  3) Take the essential primes, then cover the rest by branch and bound
+ */
+vector<Logic_Minimizer::Cube> Logic_Minimizer::minimizeExact(const vector<uint64_t>& on_set, size_t n) {
+  if (n > EXACT_LIMIT_VARIABLES) {
+    throw invalid_argument("Exact minimization supports at most " + to_string(EXACT_LIMIT_VARIABLES) + " variables");
+  }
+
+  const uint64_t all = (n == 64) ? ~0ull : (1ull << n) - 1;
+  const uint64_t rows = 1ull << n;
+
+  // Step 1: minterms, re-mapped so that bit j is variable j
+  vector<uint64_t> minterms;
+  for (uint64_t row = 0; row < rows; ++row) {
+    if ((on_set[row / 64] >> (row % 64)) & 1) {
+      uint64_t value = 0;
+      for (size_t j = 0; j < n; ++j) {
+        value |= ((row >> (n - j - 1)) & 1) << j;
+      }
+      minterms.push_back(value);
+    }
+  }
+  if (minterms.empty()) return {};
+  if (minterms.size() == rows) return {Cube{0, 0}};
+
+  // Step 2: prime implicants
+  vector<Cube> primes;
+  vector<Cube> current;
+  for (uint64_t m : minterms) current.push_back(Cube{all, m});
+
+  while (!current.empty()) {
+    Cube_Table lookup;
+    for (const Cube& cube : current) lookup.insert(cube);
+    vector<bool> merged(current.size(), false);
+    Cube_Table next;
+
+    for (size_t i = 0; i < current.size(); ++i) {
+      const Cube& cube = current[i];
+      // Only look upward (value bit 0 → 1) so each pair is found once
+      for (uint64_t bits = cube.care & ~cube.value; bits; bits &= bits - 1) {
+        const uint64_t bit = bits & (~bits + 1);
+        const long partner = lookup.find(Cube{cube.care, cube.value | bit});
+        if (partner >= 0) {
+          next.insert(Cube{cube.care & ~bit, cube.value});
+          merged[i] = true;
+          merged[partner] = true;
+        }
+      }
+    }
+
+    for (size_t i = 0; i < current.size(); ++i) {
+      if (!merged[i]) primes.push_back(current[i]);
+    }
+    current = next.items();
+  }
+
+  // Step 3a: essential primes (sole cover of some minterm)
+  vector<bool> essential(primes.size(), false);
+  for (uint64_t m : minterms) {
+    size_t only = primes.size();
+    size_t count = 0;
+    for (size_t p = 0; p < primes.size() && count < 2; ++p) {
+      if (covers(primes[p], m)) {
+        only = p;
+        ++count;
+      }
+    }
+    if (count == 1) essential[only] = true;
+  }
+
+  vector<Cube> cover;
+  for (size_t p = 0; p < primes.size(); ++p) {
+    if (essential[p]) cover.push_back(primes[p]);
+  }
+
+  // Step 3b: cover what the essentials leave uncovered
+  vector<uint64_t> remaining;
+  for (uint64_t m : minterms) {
+    bool done = false;
+    for (const Cube& cube : cover) {
+      if (covers(cube, m)) { done = true; break; }
+    }
+    if (!done) remaining.push_back(m);
+  }
+
+  if (!remaining.empty()) {
+    vector<Cube> candidates;
+    for (size_t p = 0; p < primes.size(); ++p) {
+      if (!essential[p]) candidates.push_back(primes[p]);
+    }
+    Cover_Search search(candidates, remaining);
+    search.run();
+    for (uint32_t p : search.best) cover.push_back(candidates[p]);
+  }
+
+  return cover;
+}
+
+namespace {
+
+/**
+ * @brief Minato–Morreale irredundant sum of products of an interval of
+ * functions [lower, upper], computed on the BDD and memoized per pair.
+ * For the top variable x (cofactors L0, L1, U0, U1):
+ *   C0 = isop(L0 AND NOT U1, U0)   cubes that need NOT x
+ *   C1 = isop(L1 AND NOT U0, U1)   cubes that need x
+ *   Cd = isop((L0 AND NOT C0) OR (L1 AND NOT C1), U0 AND U1)   cubes without x
+ * The cover grows with the function's two-level size, not with the number
+ * of BDD paths (a plain sum of products comes back about as written).
+ */
+class Isop_Builder {
+  public:
+    struct Result {
+      vector<Logic_Minimizer::Cube> cubes;
+      BDD_Manager::Node cover;            // BDD of the cubes
+    };
+
+  private:
+    BDD_Manager& bdd;
+    size_t max_cubes;
+    unordered_map<uint64_t, Result> memo;   // (lower << 32 | upper) → result; references stay valid
+    const Result empty{{}, BDD_Manager::FALSE_NODE};
+    const Result full{{Logic_Minimizer::Cube{}}, BDD_Manager::TRUE_NODE};
+
+  public:
+    Isop_Builder(BDD_Manager& bdd, size_t max_cubes) : bdd(bdd), max_cubes(max_cubes) {}
+
+    const Result& build(BDD_Manager::Node lower, BDD_Manager::Node upper) {
+      if (lower == BDD_Manager::FALSE_NODE) return empty;
+      if (upper == BDD_Manager::TRUE_NODE) return full;
+      const uint64_t key = static_cast<uint64_t>(lower) << 32 | upper;
+      const auto found = memo.find(key);
+      if (found != memo.end()) return found->second;
+
+      // Cofactors on the top variable of the two (terminals sort last)
+      const uint32_t x = min(bdd.getVar(lower), bdd.getVar(upper));
+      auto low = [&](BDD_Manager::Node n) { return bdd.getVar(n) == x ? bdd.getLow(n) : n; };
+      auto high = [&](BDD_Manager::Node n) { return bdd.getVar(n) == x ? bdd.getHigh(n) : n; };
+      const BDD_Manager::Node l0 = low(lower), l1 = high(lower), u0 = low(upper), u1 = high(upper);
+
+      const Result& negative = build(bdd.apply_and(l0, bdd.apply_not(u1)), u0);
+      const Result& positive = build(bdd.apply_and(l1, bdd.apply_not(u0)), u1);
+      const BDD_Manager::Node rest = bdd.apply_or(bdd.apply_and(l0, bdd.apply_not(negative.cover)),
+                                                  bdd.apply_and(l1, bdd.apply_not(positive.cover)));
+      const Result& either = build(rest, bdd.apply_and(u0, u1));
+
+      if (negative.cubes.size() + positive.cubes.size() + either.cubes.size() > max_cubes) {
+        throw length_error("More than " + to_string(max_cubes) + " product terms");
+      }
+      Result result;
+      const uint64_t bit = 1ull << x;
+      for (const Logic_Minimizer::Cube& cube : negative.cubes) {
+        result.cubes.push_back({cube.care | bit, cube.value});
+      }
+      for (const Logic_Minimizer::Cube& cube : positive.cubes) {
+        result.cubes.push_back({cube.care | bit, cube.value | bit});
+      }
+      result.cubes.insert(result.cubes.end(), either.cubes.begin(), either.cubes.end());
+      result.cover = bdd.ite(bdd.literal(bdd.getVariables()[x]), bdd.apply_or(positive.cover, either.cover),
+                             bdd.apply_or(negative.cover, either.cover));
+      return memo.emplace(key, move(result)).first->second;
+    }
+};
+
+} // namespace
+
+/**
+ * @brief Irredundant cover of f straight from its BDD (see Isop_Builder);
+ * no cube is contained in the union of the others.
+ */
+vector<Logic_Minimizer::Cube> Logic_Minimizer::irredundantCover(BDD_Manager& bdd, BDD_Manager::Node f,
+                                                                size_t max_cubes) {
+  if (bdd.getVariableCount() > 64) {
+    throw invalid_argument("Cubes support at most 64 variables");
+  }
+  return Isop_Builder(bdd, max_cubes).build(f, f).cubes;
+}
+
+/**
+ * @brief cube ⊆ f, answered on the BDD of f: every path that agrees with
+ * the cube must end in TRUE. The walk builds no nodes, visits each node
+ * once and stops at the first FALSE.
+ */
+static bool cubeImplies(const BDD_Manager& bdd, BDD_Manager::Node f, const Logic_Minimizer::Cube& cube) {
+  vector<BDD_Manager::Node> pending = {f};
+  unordered_set<BDD_Manager::Node> seen;
+  while (!pending.empty()) {
+    const BDD_Manager::Node node = pending.back();
+    pending.pop_back();
+    if (node == BDD_Manager::TRUE_NODE || !seen.insert(node).second) continue;
+    if (node == BDD_Manager::FALSE_NODE) return false;
+    const uint64_t bit = 1ull << bdd.getVar(node);
+    if (!(cube.care & bit) || !(cube.value & bit)) pending.push_back(bdd.getLow(node));
+    if (!(cube.care & bit) || (cube.value & bit)) pending.push_back(bdd.getHigh(node));
+  }
+  return true;
+}
+
+/**
+ * @brief The other cubes of the cover seen from inside cover[i]: each one
+ * that meets it, minus the literals cover[i] already fixes. They cover
+ * cover[i] exactly when this list is a tautology.
+ */
+static vector<Logic_Minimizer::Cube> othersWithin(const vector<Logic_Minimizer::Cube>& cover,
+                                                  const vector<bool>& removed, size_t i) {
+  const Logic_Minimizer::Cube& cube = cover[i];
+  vector<Logic_Minimizer::Cube> others;
+  for (size_t k = 0; k < cover.size(); ++k) {
+    if (k == i || removed[k] || ((cover[k].value ^ cube.value) & cover[k].care & cube.care)) continue;
+    others.push_back({cover[k].care & ~cube.care, cover[k].value & ~cube.care});
+  }
+  return others;
+}
+
+// Cubes with the variable `bit` set to `value`; cubes needing the opposite drop out
+static vector<Logic_Minimizer::Cube> cofactor(const vector<Logic_Minimizer::Cube>& cubes, uint64_t bit, bool value) {
+  vector<Logic_Minimizer::Cube> result;
+  for (const Logic_Minimizer::Cube& cube : cubes) {
+    if ((cube.care & bit) && ((cube.value & bit) != 0) != value) continue;
+    result.push_back({cube.care & ~bit, cube.value & ~bit});
+  }
+  return result;
+}
+
+// The variable in the most cubes among candidates (the split that shrinks both halves most)
+static uint64_t splitVariable(const vector<Logic_Minimizer::Cube>& cubes, uint64_t candidates) {
+  uint64_t best = candidates & (~candidates + 1);
+  size_t best_count = 0;
+  for (uint64_t bits = candidates; bits; bits &= bits - 1) {
+    const uint64_t bit = bits & (~bits + 1);
+    size_t count = 0;
+    for (const Logic_Minimizer::Cube& cube : cubes) count += (cube.care & bit) != 0;
+    if (count > best_count) {
+      best = bit;
+      best_count = count;
+    }
+  }
+  return best;
+}
+
+/**
+ * @brief Tautology of a list of cubes (Espresso's unate recursion): a cover
+ * that is unate in every variable is a tautology only if it holds the
+ * all-don't-care cube; otherwise split on a binate variable.
+ */
+static bool isTautology(const vector<Logic_Minimizer::Cube>& cubes) {
+  uint64_t positive = 0, negative = 0;
+  for (const Logic_Minimizer::Cube& cube : cubes) {
+    if (cube.care == 0) return true;
+    positive |= cube.care & cube.value;
+    negative |= cube.care & ~cube.value;
+  }
+  const uint64_t binate = positive & negative;
+  if (binate == 0) return false;
+  const uint64_t bit = splitVariable(cubes, binate);
+  return isTautology(cofactor(cubes, bit, false)) && isTautology(cofactor(cubes, bit, true));
+}
+
+/**
+ * @brief Smallest cube holding every minterm the cubes miss; false when
+ * they miss none. Shannon recursion with the supercube of the two halves
+ * (the literals both agree on).
+ */
+static bool complementSupercube(const vector<Logic_Minimizer::Cube>& cubes, Logic_Minimizer::Cube& result) {
+  if (cubes.empty()) {
+    result = Logic_Minimizer::Cube{};
+    return true;
+  }
+  uint64_t cared = 0;
+  for (const Logic_Minimizer::Cube& cube : cubes) {
+    if (cube.care == 0) return false;
+    cared |= cube.care;
+  }
+  if (cubes.size() == 1) {
+    // NOT of one cube: its literals negated and ORed; only a single literal stays a cube
+    const Logic_Minimizer::Cube& cube = cubes[0];
+    result = bitCount(cube.care) == 1 ? Logic_Minimizer::Cube{cube.care, ~cube.value & cube.care}
+                                      : Logic_Minimizer::Cube{};
+    return true;
+  }
+
+  const uint64_t bit = splitVariable(cubes, cared);
+  Logic_Minimizer::Cube low, high;
+  const bool has_low = complementSupercube(cofactor(cubes, bit, false), low);
+  if (has_low && low.care == 0) {
+    // Nothing to narrow down: only whether the other half is empty matters
+    result = isTautology(cofactor(cubes, bit, true)) ? Logic_Minimizer::Cube{bit, 0} : Logic_Minimizer::Cube{};
+    return true;
+  }
+  const bool has_high = complementSupercube(cofactor(cubes, bit, true), high);
+  if (!has_low && !has_high) return false;
+  if (!has_high) result = {low.care | bit, low.value};
+  else if (!has_low) result = {high.care | bit, high.value | bit};
+  else {
+    result.care = low.care & high.care & ~(low.value ^ high.value);
+    result.value = low.value & result.care;
+  }
+  return true;
+}
+
+/**
+ * @brief Espresso-style loop: EXPAND → IRREDUNDANT → REDUCE, repeated while
+ * the cover gets cheaper. The BDD of f is the oracle for "cube ⊆ f"; cubes
+ * are checked against each other inside the cube at hand, so no check
+ * costs a BDD operation on the whole function.
+ */
+vector<Logic_Minimizer::Cube> Logic_Minimizer::minimizeHeuristic(BDD_Manager& bdd, BDD_Manager::Node f) {
+  if (f == BDD_Manager::FALSE_NODE) return {};
+  if (f == BDD_Manager::TRUE_NODE) return {Cube{0, 0}};
+
+  // Start from an irredundant cover; only a function with no small
+  // two-level form (parity and the like) is refused
+  vector<Cube> cover;
+  try {
+    cover = irredundantCover(bdd, f, HEURISTIC_MAX_CUBES);
+  }
+  catch (const length_error&) {
+    throw length_error("Too large for heuristic minimization: the starting cover has more than " +
+                       to_string(HEURISTIC_MAX_CUBES) + " product terms");
+  }
+
+  vector<Cube> best = cover;
+
+  for (int pass = 0; pass < 4; ++pass) {
+    // EXPAND: drop literals while the cube stays inside f (largest cubes first)
+    sort(cover.begin(), cover.end(), [](const Cube& a, const Cube& b) { return bitCount(a.care) < bitCount(b.care); });
+    for (Cube& cube : cover) {
+      uint64_t bits = cube.care;
+      while (bits) {
+        // Alternate the literal order between passes
+        const uint64_t bit = (pass % 2 == 0) ? (bits & (~bits + 1)) : highestBit(bits);
+        bits &= ~bit;
+        const Cube wider{cube.care & ~bit, cube.value & ~bit};
+        if (cubeImplies(bdd, f, wider)) cube = wider;
+      }
+    }
+
+    // Drop cubes contained in another cube (and duplicates)
+    vector<Cube> kept;
+    for (size_t i = 0; i < cover.size(); ++i) {
+      bool contained = false;
+      for (size_t k = 0; k < cover.size() && !contained; ++k) {
+        if (k == i || !contains(cover[k], cover[i])) continue;
+        contained = !contains(cover[i], cover[k]) || k < i;
+      }
+      if (!contained) kept.push_back(cover[i]);
+    }
+    cover.swap(kept);
+
+    // IRREDUNDANT: remove cubes covered by the union of the others
+    // (smallest cubes are tried first: they are the likeliest to be redundant)
+    sort(cover.begin(), cover.end(), [](const Cube& a, const Cube& b) { return bitCount(a.care) > bitCount(b.care); });
+    vector<bool> removed(cover.size(), false);
+    kept.clear();
+    for (size_t i = 0; i < cover.size(); ++i) {
+      removed[i] = isTautology(othersWithin(cover, removed, i));
+      if (!removed[i]) kept.push_back(cover[i]);
+    }
+    cover.swap(kept);
+
+    if (coverCost(cover) < coverCost(best)) {
+      best = cover;
+    }
+    else if (pass > 0) {
+      break;
+    }
+
+    // REDUCE: shrink each cube to the smallest cube holding the minterms
+    // only it covers, giving the next EXPAND room to move elsewhere
+    // (the others are the cubes reduced so far plus all later ones)
+    removed.assign(cover.size(), false);
+    for (size_t i = 0; i < cover.size(); ++i) {
+      Cube own;
+      if (!complementSupercube(othersWithin(cover, removed, i), own)) continue;
+      cover[i].care |= own.care;
+      cover[i].value |= own.value;
+    }
+  }
+
+  return best;
+}
+
+/**
+ * @brief Print a cover as "(A AND NOT B) OR C".
+ * An empty cover is FALSE and a cover holding the all-don't-care cube is
+ * TRUE, whether or not the function has variables.
+ */
+string Logic_Minimizer::toExpression(const vector<Cube>& cover, const vector<string>& variables) {
+  if (cover.empty()) {
+    return "FALSE";
+  }
+  for (const Cube& cube : cover) {
+    if (cube.care == 0) {
+      return "TRUE";
+    }
+  }
+
+  string text;
+  for (size_t t = 0; t < cover.size(); ++t) {
+    const Cube& cube = cover[t];
+
+    string term;
+    size_t literals = 0;
+    for (size_t j = 0; j < variables.size() && j < 64; ++j) {
+      if (!((cube.care >> j) & 1)) continue;
+      if (literals++ > 0) term += " AND ";
+      if (!((cube.value >> j) & 1)) term += "NOT ";
+      term += variables[j];
+    }
+
+    if (t > 0) text += " OR ";
+    text += (literals > 1 && cover.size() > 1) ? "(" + term + ")" : term;
+  }
+  return text;
+}
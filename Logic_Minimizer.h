@@ -0,0 +1,75 @@
+/**
+ * @class Logic_Minimizer
+ * @brief Two-level (sum-of-products) minimization of Boolean functions.
+ *
+ * Implicants are cubes packed into two bitmasks (bit j = variable j):
+ *   care  : 1 if variable j appears in the product term
+ *   value : its polarity (1 = plain, 0 = NOT) where care is 1
+ * Merging, containment and coverage tests are a few bitwise operations.
+ *
+ * Two methods:
+ *  - Exact Quine–McCluskey from the truth table (small n): all prime
+ *    implicants, essential primes, then a bounded branch-and-bound cover
+ *  - Espresso-style heuristic from a BDD (large n): start from an
+ *    irredundant cover computed on the BDD (Minato–Morreale), then EXPAND
+ *    each cube as far as the BDD allows, drop contained cubes and remove
+ *    redundant ones (IRREDUNDANT); containment and coverage are BDD
+ *    operations, so no path or minterm is enumerated
+ *
+ * The result is printed with the operators of Boolean_Expression.
+ */
+
+#ifndef LOGIC_MINIMIZER_H
+#define LOGIC_MINIMIZER_H
+
+#include "BDD_Manager.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class Logic_Minimizer {
+  public:
+    struct Cube {
+      uint64_t care = 0;
+      uint64_t value = 0;
+    };
+
+    enum class Method { AUTO, EXACT, HEURISTIC };
+
+    // AUTO picks EXACT up to this many variables
+    static constexpr size_t EXACT_MAX_VARIABLES = 12;
+
+    // Hard limit for EXACT (the prime table grows like 3^n)
+    static constexpr size_t EXACT_LIMIT_VARIABLES = 16;
+
+    // Safety net for HEURISTIC: product terms in the starting cover (each
+    // pass costs a few BDD operations per term); only functions without a
+    // small sum of products, such as wide parity, reach it
+    static constexpr size_t HEURISTIC_MAX_CUBES = 10000;
+
+    /**
+     * Exact minimization. on_set holds one bit per truth-table row
+     * (bit r % 64 of word r / 64); row r assigns variable j the bit
+     * (n-1-j) of r, like Truth_Table.
+     */
+    static vector<Cube> minimizeExact(const vector<uint64_t>& on_set, size_t variable_count);
+
+    // Heuristic minimization of the function f; cube bit j = BDD variable j.
+    // Throws length_error when the starting cover is over HEURISTIC_MAX_CUBES.
+    static vector<Cube> minimizeHeuristic(BDD_Manager& bdd, BDD_Manager::Node f);
+
+    // Irredundant sum of products of f built on its BDD; throws
+    // length_error (and stops) once it has more than max_cubes terms
+    static vector<Cube> irredundantCover(BDD_Manager& bdd, BDD_Manager::Node f, size_t max_cubes = SIZE_MAX);
+
+    // "(A AND NOT B) OR C"; an empty cover is written as FALSE and a
+    // cover of everything as TRUE
+    static string toExpression(const vector<Cube>& cover, const vector<string>& variables);
+
+    // Number of literals in the cover
+    static size_t literalCount(const vector<Cube>& cover);
+};
+
+#endif //LOGIC_MINIMIZER_H
@@ -0,0 +1,119 @@
+/**
+ * @file Ordered_Chunk_Writer.cpp
+ * @brief Worker pool with a bounded reorder buffer.
+ *
+ * The reorder buffer is a ring of `window` slots. Chunk c always uses slot
+ * c % window, and a worker may only start chunk c once chunk c - window
+ * has been consumed, so a slow chunk holds back at most `window` others.
+ */
+
+#include "Ordered_Chunk_Writer.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Constructor : fix the pool size and reorder window
+Ordered_Chunk_Writer::Ordered_Chunk_Writer(unsigned threads, size_t window)
+    : thread_count(resolveThreads(threads)), window(max<size_t>(window, 1)) {}
+
+unsigned Ordered_Chunk_Writer::getThreadCount() const {
+  return thread_count;
+}
+
+unsigned Ordered_Chunk_Writer::resolveThreads(unsigned requested) {
+  if (requested != 0) {
+    return requested;
+  }
+  return max(1u, thread::hardware_concurrency());
+}
+
+/**
+ * @brief Produce all chunks on the pool and consume them in order.
+ * With a single thread everything runs inline on the caller.
+ */
+void Ordered_Chunk_Writer::run(uint64_t chunk_count, const Producer& produce, const Consumer& consume) const {
+  if (chunk_count == 0) {
+    return;
+  }
+
+  if (thread_count == 1) {
+    string buffer;
+    for (uint64_t chunk = 0; chunk < chunk_count; ++chunk) {
+      buffer.clear();
+      produce(0, chunk, buffer);
+      consume(buffer);
+    }
+    return;
+  }
+
+  struct Slot {
+    string data;
+    bool ready = false;
+  };
+
+  vector<Slot> slots(window);
+  mutex lock;
+  condition_variable slot_ready;  // a chunk finished (wakes the consumer)
+  condition_variable slot_free;   // a chunk was consumed (wakes workers)
+  uint64_t next_chunk = 0;        // next chunk to hand to a worker
+  uint64_t consumed = 0;          // chunks already passed to consume()
+
+  auto worker = [&](unsigned id) {
+    while (true) {
+      uint64_t chunk;
+      {
+        unique_lock<mutex> guard(lock);
+        if (next_chunk == chunk_count) {
+          return;
+        }
+        chunk = next_chunk++;
+        // Wait until this chunk's slot has been drained
+        slot_free.wait(guard, [&] { return chunk < consumed + window; });
+      }
+
+      // The slot is owned by this worker until it is marked ready
+      Slot& slot = slots[chunk % window];
+      slot.data.clear();
+      produce(id, chunk, slot.data);
+
+      {
+        lock_guard<mutex> guard(lock);
+        slot.ready = true;
+      }
+      slot_ready.notify_one();
+    }
+  };
+
+  vector<thread> workers;
+  workers.reserve(thread_count);
+  for (unsigned id = 0; id < thread_count; ++id) {
+    workers.emplace_back(worker, id);
+  }
+
+  // Consumer: drain slots in chunk order
+  for (uint64_t chunk = 0; chunk < chunk_count; ++chunk) {
+    Slot& slot = slots[chunk % window];
+    {
+      unique_lock<mutex> guard(lock);
+      slot_ready.wait(guard, [&] { return slot.ready; });
+    }
+
+    consume(slot.data);
+
+    {
+      lock_guard<mutex> guard(lock);
+      slot.ready = false;
+      ++consumed;
+    }
+    slot_free.notify_all();
+  }
+
+  for (thread& t : workers) {
+    t.join();
+  }
+}
@@ -0,0 +1,43 @@
+/**
+ * @class Ordered_Chunk_Writer
+ * @brief Produces numbered chunks on a worker pool and consumes them in order.
+ *
+ * Workers claim chunk numbers 0, 1, 2, ... and format each one into a
+ * reusable text buffer. The calling thread hands the buffers to the
+ * consumer strictly in chunk order. At most `window` chunks are in flight,
+ * so memory stays flat no matter how many chunks there are.
+ */
+
+#ifndef ORDERED_CHUNK_WRITER_H
+#define ORDERED_CHUNK_WRITER_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+using namespace std;
+
+class Ordered_Chunk_Writer {
+  public:
+    // Fill `out` with chunk `chunk`; `worker` (0..threads-1) indexes per-thread scratch
+    using Producer = function<void(unsigned worker, uint64_t chunk, string& out)>;
+    // Receive a finished chunk (called on the calling thread, in chunk order)
+    using Consumer = function<void(const string& data)>;
+
+  private:
+    unsigned thread_count;
+    size_t window;
+
+  public:
+    // threads == 0 uses one worker per hardware thread
+    Ordered_Chunk_Writer(unsigned threads, size_t window);
+
+    unsigned getThreadCount() const;
+
+    // Workers for a requested count (0 → hardware concurrency, at least 1)
+    static unsigned resolveThreads(unsigned requested);
+
+    void run(uint64_t chunk_count, const Producer& produce, const Consumer& consume) const;
+};
+
+#endif //ORDERED_CHUNK_WRITER_H
@@ -0,0 +1,74 @@
+/**
+ * @class Parse_Error
+ * @brief invalid_argument that also records what went wrong and where in
+ *        the expression it was found, so the caller can point at it.
+ *
+ * position and length are byte offsets into the original expression.
+ * getKind() tells the failures apart without matching message text
+ * (Batch_Runner prints it as its own column).
+ */
+
+#ifndef PARSE_ERROR_H
+#define PARSE_ERROR_H
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+class Parse_Error : public std::invalid_argument {
+  public:
+    enum class Kind {
+      UNEXPECTED_CHARACTER,   // a byte that cannot start a token
+      INVALID_NAME,           // a word that is not a keyword and starts with a digit
+      MISSING_OPERAND,        // an operator, ')' or the end where an operand belongs
+      MISSING_OPERATOR,       // an operand or '(' right after an operand
+      UNMATCHED_OPEN,         // '(' never closed
+      UNMATCHED_CLOSE,        // ')' with no '(' open
+      EMPTY_EXPRESSION,
+      TOO_LONG,               // over 4 GiB (token offsets are 32-bit)
+    };
+
+    // Longest token text quoted in a message
+    static constexpr size_t MAX_QUOTED_BYTES = 40;
+
+  private:
+    Kind kind;
+    size_t position;  // first byte of the offending token
+    size_t length;    // bytes to underline (at least 1)
+
+  public:
+    Parse_Error(Kind kind, const std::string& message, size_t position, size_t length = 1)
+        : std::invalid_argument(message + " (column " + std::to_string(position + 1) + ")"),
+          kind(kind), position(position), length(length ? length : 1) {}
+
+    Kind getKind() const { return kind; }
+    size_t getPosition() const { return position; }
+    size_t getLength() const { return length; }
+
+    // "missing_operand", "unmatched_open", ...
+    static const char* kindName(Kind kind) {
+      switch (kind) {
+        case Kind::UNEXPECTED_CHARACTER: return "unexpected_character";
+        case Kind::INVALID_NAME:         return "invalid_name";
+        case Kind::MISSING_OPERAND:      return "missing_operand";
+        case Kind::MISSING_OPERATOR:     return "missing_operator";
+        case Kind::UNMATCHED_OPEN:       return "unmatched_open";
+        case Kind::UNMATCHED_CLOSE:      return "unmatched_close";
+        case Kind::EMPTY_EXPRESSION:     return "empty_expression";
+        case Kind::TOO_LONG:             return "too_long";
+      }
+      return "unknown";
+    }
+
+    // 'text' for a message; a long token keeps its first MAX_QUOTED_BYTES
+    // bytes, so a malformed multi-megabyte word does not fill the message
+    static std::string quote(std::string_view text) {
+      if (text.size() <= MAX_QUOTED_BYTES) {
+        return "'" + std::string(text) + "'";
+      }
+      return "'" + std::string(text.substr(0, MAX_QUOTED_BYTES)) + "...'";
+    }
+};
+
+#endif //PARSE_ERROR_H
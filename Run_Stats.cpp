@@ -0,0 +1,183 @@
+/**
+ * @file Run_Stats.cpp
+ * @brief Clocks, accumulation and the --stats report.
+ */
+
+#include "Run_Stats.h"
+#include "Allocation_Tracker.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <time.h>
+#define RUN_STATS_HAS_CPU_CLOCKS 1
+#endif
+
+using namespace std;
+
+bool Run_Stats::enabled_flag = false;
+atomic<uint64_t> Run_Stats::wall_ns[static_cast<size_t>(Phase::COUNT)];
+atomic<uint64_t> Run_Stats::cpu_ns[static_cast<size_t>(Phase::COUNT)];
+atomic<uint64_t> Run_Stats::counters[static_cast<size_t>(Counter::COUNT)];
+
+// Read the clocks when a phase starts (only while collecting)
+void Run_Stats::Scope::start() {
+  wall_start = wallNow();
+  cpu_start = threadCpuNow();
+}
+
+void Run_Stats::Scope::finish() {
+  const size_t index = static_cast<size_t>(phase);
+  wall_ns[index].fetch_add(wallNow() - wall_start, memory_order_relaxed);
+  cpu_ns[index].fetch_add(threadCpuNow() - cpu_start, memory_order_relaxed);
+}
+
+void Run_Stats::enable() {
+  enabled_flag = true;
+}
+
+void Run_Stats::raise(Counter counter, uint64_t value) {
+  if (!enabled_flag) {
+    return;
+  }
+  atomic<uint64_t>& slot = counters[static_cast<size_t>(counter)];
+  uint64_t current = slot.load(memory_order_relaxed);
+  while (current < value && !slot.compare_exchange_weak(current, value, memory_order_relaxed)) {
+  }
+}
+
+uint64_t Run_Stats::get(Counter counter) {
+  return counters[static_cast<size_t>(counter)].load(memory_order_relaxed);
+}
+
+uint64_t Run_Stats::getWallNs(Phase phase) {
+  return wall_ns[static_cast<size_t>(phase)].load(memory_order_relaxed);
+}
+
+uint64_t Run_Stats::getCpuNs(Phase phase) {
+  return cpu_ns[static_cast<size_t>(phase)].load(memory_order_relaxed);
+}
+
+uint64_t Run_Stats::wallNow() {
+  return static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(
+      chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+uint64_t Run_Stats::threadCpuNow() {
+#ifdef RUN_STATS_HAS_CPU_CLOCKS
+  timespec now;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+  return static_cast<uint64_t>(now.tv_sec) * 1000000000ull + static_cast<uint64_t>(now.tv_nsec);
+#else
+  return processCpuNow();
+#endif
+}
+
+uint64_t Run_Stats::processCpuNow() {
+#ifdef RUN_STATS_HAS_CPU_CLOCKS
+  timespec now;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+  return static_cast<uint64_t>(now.tv_sec) * 1000000000ull + static_cast<uint64_t>(now.tv_nsec);
+#else
+  return static_cast<uint64_t>(clock()) * (1000000000ull / CLOCKS_PER_SEC);
+#endif
+}
+
+const char* Run_Stats::phaseName(Phase phase) {
+  switch (phase) {
+    case Phase::PARSE:            return "parse";
+    case Phase::DETECT_VARIABLES: return "detect_variables";
+    case Phase::COMPILE:          return "compile";
+    case Phase::EVALUATE:         return "evaluate";
+    case Phase::FORMAT_ROWS:      return "format_rows";
+    case Phase::OUTPUT:           return "output";
+    default:                      return "?";
+  }
+}
+
+const char* Run_Stats::counterName(Counter counter) {
+  switch (counter) {
+    case Counter::TOKENS:           return "tokens";
+    case Counter::NODES:            return "dag_nodes";
+    case Counter::STEPS:            return "steps";
+    case Counter::VARIABLES:        return "variables";
+    case Counter::ROWS:             return "rows";
+    case Counter::BLOCKS:           return "blocks";
+    case Counter::OUTPUT_BYTES:     return "output_bytes";
+    case Counter::PEAK_STACK_DEPTH: return "peak_stack_depth";
+    case Counter::CACHE_HITS:       return "cache_hits";
+    case Counter::CACHE_MISSES:     return "cache_misses";
+    case Counter::NATIVE_CODE_BYTES: return "native_code_bytes";
+    default:                        return "?";
+  }
+}
+
+/**
+ * @brief Print the collected statistics.
+ * rows/s is measured against the time spent evaluating (and formatting) rows.
+ */
+void Run_Stats::report(ostream& out, bool json, uint64_t total_wall_ns, uint64_t total_cpu_ns) {
+  const size_t phase_count = static_cast<size_t>(Phase::COUNT);
+  const size_t counter_count = static_cast<size_t>(Counter::COUNT);
+
+  const uint64_t row_ns = getWallNs(Phase::EVALUATE) + getWallNs(Phase::FORMAT_ROWS);
+  const double rows_per_second = row_ns ? get(Counter::ROWS) * 1e9 / row_ns : 0.0;
+  const bool allocations = Allocation_Tracker::isHooked();
+  char line[160];
+
+  if (json) {
+    out << "{\"phases\": {";
+    for (size_t p = 0; p < phase_count; ++p) {
+      const Phase phase = static_cast<Phase>(p);
+      snprintf(line, sizeof(line), "%s\"%s\": {\"wall_ms\": %.3f, \"cpu_ms\": %.3f}", p ? ", " : "",
+               phaseName(phase), getWallNs(phase) / 1e6, getCpuNs(phase) / 1e6);
+      out << line;
+    }
+    snprintf(line, sizeof(line), "}, \"total\": {\"wall_ms\": %.3f, \"cpu_ms\": %.3f}, \"counters\": {",
+             total_wall_ns / 1e6, total_cpu_ns / 1e6);
+    out << line;
+    for (size_t c = 0; c < counter_count; ++c) {
+      const Counter counter = static_cast<Counter>(c);
+      out << (c ? ", " : "") << "\"" << counterName(counter) << "\": " << get(counter);
+    }
+    snprintf(line, sizeof(line), "}, \"rows_per_s\": %.1f", rows_per_second);
+    out << line;
+    if (allocations) {
+      out << ", \"allocations\": " << Allocation_Tracker::getCount()
+          << ", \"allocated_bytes\": " << Allocation_Tracker::getBytes();
+    }
+    out << "}" << endl;
+    return;
+  }
+
+  out << "\n--- Run statistics ---\n";
+  snprintf(line, sizeof(line), "%-18s %12s %12s\n", "phase", "wall ms", "cpu ms");
+  out << line;
+  for (size_t p = 0; p < phase_count; ++p) {
+    const Phase phase = static_cast<Phase>(p);
+    snprintf(line, sizeof(line), "%-18s %12.3f %12.3f\n", phaseName(phase),
+             getWallNs(phase) / 1e6, getCpuNs(phase) / 1e6);
+    out << line;
+  }
+  snprintf(line, sizeof(line), "%-18s %12.3f %12.3f\n\n", "total (run)", total_wall_ns / 1e6, total_cpu_ns / 1e6);
+  out << line;
+
+  for (size_t c = 0; c < counter_count; ++c) {
+    const Counter counter = static_cast<Counter>(c);
+    snprintf(line, sizeof(line), "%-18s %12llu\n", counterName(counter),
+             static_cast<unsigned long long>(get(counter)));
+    out << line;
+  }
+  snprintf(line, sizeof(line), "%-18s %12.0f\n", "rows_per_s", rows_per_second);
+  out << line;
+  if (allocations) {
+    snprintf(line, sizeof(line), "%-18s %12llu (%llu bytes)\n", "allocations",
+             static_cast<unsigned long long>(Allocation_Tracker::getCount()),
+             static_cast<unsigned long long>(Allocation_Tracker::getBytes()));
+    out << line;
+  }
+  out.flush();
+}
@@ -0,0 +1,121 @@
+/**
+ * @class Run_Stats
+ * @brief Optional per-phase timers and counters for one run (--stats).
+ *
+ * Phases are timed with a Scope object:
+ *   { Run_Stats::Scope scope(Run_Stats::Phase::COMPILE); ... }
+ * which adds its wall time and its thread's CPU time to the phase when it
+ * ends. Work done on several threads adds up, so a phase's wall time can
+ * exceed the run's.
+ *
+ * A Scope reads two clocks when it starts and again when it ends, which
+ * costs about as much as evaluating one row block. Scopes therefore wrap
+ * whole passes or table chunks, never a single block; per-block work is
+ * counted (BLOCKS) instead.
+ *
+ * Everything is off until enable() is called; while off, a Scope or a
+ * counter update is a single test of a flag.
+ */
+
+#ifndef RUN_STATS_H
+#define RUN_STATS_H
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+
+using namespace std;
+
+class Run_Stats {
+  public:
+    enum class Phase {
+      PARSE,              // tokenize + syntax check / postfix
+      DETECT_VARIABLES,
+      COMPILE,            // expression DAG + instructions + labels
+      EVALUATE,           // evaluation passes over row blocks (count, bitset, save, equivalence)
+      FORMAT_ROWS,        // evaluate and format the rows of a table chunk (interleaved per block)
+      OUTPUT,             // write rows
+      COUNT
+    };
+
+    enum class Counter {
+      TOKENS,
+      NODES,              // distinct subexpressions (DAG operator nodes)
+      STEPS,
+      VARIABLES,
+      ROWS,               // rows evaluated
+      BLOCKS,             // row blocks evaluated (a full pass or a cone update each)
+      OUTPUT_BYTES,
+      PEAK_STACK_DEPTH,   // deepest operand stack while building the expression
+      CACHE_HITS,         // Expression_Cache lookups that found an entry
+      CACHE_MISSES,
+      NATIVE_CODE_BYTES,  // machine code generated by Jit_Kernel (--jit)
+      COUNT
+    };
+
+    // Times one phase for the lifetime of the object
+    class Scope {
+      private:
+        Phase phase;
+        bool active;
+        uint64_t wall_start = 0;
+        uint64_t cpu_start = 0;
+
+        void start();
+        void finish();
+
+      public:
+        // Inline so a disabled scope costs one flag test
+        explicit Scope(Phase phase) : phase(phase), active(enabled_flag) {
+          if (active) start();
+        }
+        ~Scope() {
+          if (active) finish();
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+  private:
+    static bool enabled_flag;
+    static atomic<uint64_t> wall_ns[static_cast<size_t>(Phase::COUNT)];
+    static atomic<uint64_t> cpu_ns[static_cast<size_t>(Phase::COUNT)];
+    static atomic<uint64_t> counters[static_cast<size_t>(Counter::COUNT)];
+
+  public:
+    // Turn collection on (call before starting worker threads)
+    static void enable();
+
+    static bool enabled() {
+      return enabled_flag;
+    }
+
+    // Add to a counter / raise it to at least value (no-ops while disabled)
+    static void add(Counter counter, uint64_t value) {
+      if (enabled_flag) counters[static_cast<size_t>(counter)].fetch_add(value, memory_order_relaxed);
+    }
+    static void raise(Counter counter, uint64_t value);
+
+    static uint64_t get(Counter counter);
+    static uint64_t getWallNs(Phase phase);
+    static uint64_t getCpuNs(Phase phase);
+
+    // Clocks in nanoseconds: monotonic wall time, this thread's CPU time,
+    // and the whole process's CPU time
+    static uint64_t wallNow();
+    static uint64_t threadCpuNow();
+    static uint64_t processCpuNow();
+
+    static const char* phaseName(Phase phase);
+    static const char* counterName(Counter counter);
+
+    /**
+     * Print every phase and counter, plus the run's total wall and CPU time
+     * and the allocation totals (see Allocation_Tracker), as an aligned
+     * summary or as one JSON object.
+     */
+    static void report(ostream& out, bool json, uint64_t total_wall_ns, uint64_t total_cpu_ns);
+};
+
+#endif //RUN_STATS_H
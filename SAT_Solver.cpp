@@ -0,0 +1,616 @@
+/**
+ * @file SAT_Solver.cpp
+ * @brief CDCL search: propagation, conflict analysis, restarts, clause deletion.
+ *
+ * Watch lists follow the usual convention: a clause watching literal l is
+ * listed under ¬l, so when a literal p becomes true, watches[p] holds every
+ * clause that has just lost a watched literal. The literal a clause
+ * propagates is always kept at position 0, which conflict analysis relies
+ * on when it walks reason clauses.
+ */
+
+#include "SAT_Solver.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+
+using namespace std;
+
+static const double VARIABLE_DECAY = 0.95;
+static const float CLAUSE_DECAY = 0.999f;
+static const uint32_t UNDEFINED_LIT = UINT32_MAX;
+
+SAT_Solver::Lit SAT_Solver::toLit(int literal) {
+  return 2 * static_cast<Lit>(abs(literal) - 1) + (literal < 0 ? 1 : 0);
+}
+
+// ------------------------------ Variables -----------------------------------
+
+int SAT_Solver::newVariable() {
+  const uint32_t v = static_cast<uint32_t>(values.size());
+  values.push_back(0);
+  levels.push_back(0);
+  reasons.push_back(NO_REASON);
+  saved_phase.push_back(false);
+  activity.push_back(0.0);
+  heap_position.push_back(-1);
+  seen.push_back(0);
+  level_stamp.resize(values.size() + 1, 0);   // levels run from 0 to the variable count
+  watches.emplace_back();
+  watches.emplace_back();
+  heapInsert(v);
+  return static_cast<int>(v + 1);
+}
+
+size_t SAT_Solver::getVariableCount() const {
+  return values.size();
+}
+
+// ------------------------------- Clauses ------------------------------------
+
+/**
+ * @brief Add an original clause.
+ * Clauses are simplified against the level-0 assignment: satisfied clauses
+ * are dropped, false literals removed, and a clause that ends up with one
+ * literal is asserted (and propagated) right away.
+ */
+void SAT_Solver::addClause(const vector<int>& literals) {
+  if (!ok) {
+    return;
+  }
+  backtrack(0);
+
+  vector<Lit> lits;
+  lits.reserve(literals.size());
+  for (int literal : literals) {
+    if (literal == 0) {
+      throw invalid_argument("SAT_Solver: literal 0 is not allowed");
+    }
+    while (static_cast<size_t>(abs(literal)) > values.size()) {
+      newVariable();
+    }
+    lits.push_back(toLit(literal));
+  }
+  sort(lits.begin(), lits.end());   // x and ¬x end up next to each other
+
+  size_t kept = 0;
+  Lit previous = UNDEFINED_LIT;
+  for (Lit lit : lits) {
+    if (value(lit) == 1 || lit == (previous ^ 1)) {
+      return;   // already satisfied, or a tautology
+    }
+    if (lit == previous) {
+      continue;
+    }
+    previous = lit;
+    if (value(lit) == 0) {
+      lits[kept++] = lit;
+    }
+  }
+  lits.resize(kept);
+
+  if (lits.empty()) {
+    ok = false;
+  }
+  else if (lits.size() == 1) {
+    enqueue(lits[0], NO_REASON);
+    ok = propagate() == NO_REASON;
+  }
+  else {
+    attach(storeClause(lits, false, 0));
+  }
+}
+
+size_t SAT_Solver::getClauseCount() const {
+  return clauses.size();
+}
+
+SAT_Solver::Clause_Ref SAT_Solver::storeClause(const vector<Lit>& lits, bool is_learnt, uint32_t lbd) {
+  const Clause_Ref ref = static_cast<Clause_Ref>(clauses.size());
+  clauses.push_back({static_cast<uint32_t>(literal_pool.size()), static_cast<uint32_t>(lits.size()),
+                     lbd, 0.0f, is_learnt});
+  literal_pool.insert(literal_pool.end(), lits.begin(), lits.end());
+  if (is_learnt) {
+    ++learnt_count;
+  }
+  return ref;
+}
+
+// Watch the first two literals
+void SAT_Solver::attach(Clause_Ref ref) {
+  const Clause& clause = clauses[ref];
+  const Lit first = literal_pool[clause.start];
+  const Lit second = literal_pool[clause.start + 1];
+  watches[first ^ 1].push_back({ref, second});
+  watches[second ^ 1].push_back({ref, first});
+}
+
+// ----------------------------- Assignment -----------------------------------
+
+void SAT_Solver::enqueue(Lit lit, Clause_Ref reason) {
+  const uint32_t v = var(lit);
+  values[v] = (lit & 1) ? -1 : 1;
+  levels[v] = decisionLevel();
+  reasons[v] = reason;
+  trail.push_back(lit);
+}
+
+// Undo every assignment above level, remembering each variable's phase
+void SAT_Solver::backtrack(uint32_t level) {
+  if (decisionLevel() <= level) {
+    return;
+  }
+  const size_t keep = trail_limits[level];
+  for (size_t i = trail.size(); i-- > keep;) {
+    const uint32_t v = var(trail[i]);
+    saved_phase[v] = (trail[i] & 1) == 0;
+    values[v] = 0;
+    reasons[v] = NO_REASON;
+    heapInsert(v);
+  }
+  trail.resize(keep);
+  trail_limits.resize(level);
+  propagate_head = trail.size();
+}
+
+/**
+ * @brief Unit propagation with two watched literals.
+ * @return the conflicting clause, or NO_REASON.
+ */
+SAT_Solver::Clause_Ref SAT_Solver::propagate() {
+  Clause_Ref conflict = NO_REASON;
+
+  while (propagate_head < trail.size()) {
+    const Lit p = trail[propagate_head++];
+    const Lit false_lit = p ^ 1;
+    vector<Watcher>& list = watches[p];
+    ++statistics.propagations;
+
+    size_t i = 0;
+    size_t j = 0;
+    const size_t end = list.size();
+    while (i < end) {
+      const Watcher watcher = list[i];
+      if (value(watcher.blocker) == 1) {
+        list[j++] = list[i++];
+        continue;
+      }
+
+      // Make sure the false literal is lits[1]
+      const Clause& clause = clauses[watcher.clause];
+      Lit* lits = &literal_pool[clause.start];
+      if (lits[0] == false_lit) {
+        lits[0] = lits[1];
+        lits[1] = false_lit;
+      }
+      ++i;
+
+      const Lit first = lits[0];
+      const Watcher updated = {watcher.clause, first};
+      if (first != watcher.blocker && value(first) == 1) {
+        list[j++] = updated;
+        continue;
+      }
+
+      // Look for a new literal to watch
+      bool moved = false;
+      for (uint32_t k = 2; k < clause.size; ++k) {
+        if (value(lits[k]) != -1) {
+          lits[1] = lits[k];
+          lits[k] = false_lit;
+          watches[lits[1] ^ 1].push_back(updated);
+          moved = true;
+          break;
+        }
+      }
+      if (moved) {
+        continue;
+      }
+
+      // Clause is unit or conflicting
+      list[j++] = updated;
+      if (value(first) == -1) {
+        conflict = watcher.clause;
+        propagate_head = trail.size();
+        while (i < end) {
+          list[j++] = list[i++];
+        }
+      }
+      else {
+        enqueue(first, watcher.clause);
+      }
+    }
+    list.resize(j);
+  }
+  return conflict;
+}
+
+// --------------------------- Conflict analysis ------------------------------
+
+/**
+ * @brief First-UIP learning.
+ * Resolves the conflict clause with reasons of current-level literals,
+ * most recent first, until one current-level literal remains. The result
+ * is left in learnt with the asserting literal first and a literal of the
+ * backtrack level second.
+ */
+void SAT_Solver::analyze(Clause_Ref conflict, uint32_t& backtrack_level, uint32_t& lbd) {
+  learnt.clear();
+  learnt.push_back(UNDEFINED_LIT);   // asserting literal, filled in below
+
+  uint32_t path_count = 0;
+  Lit p = UNDEFINED_LIT;
+  size_t index = trail.size();
+  Clause_Ref ref = conflict;
+
+  do {
+    Clause& clause = clauses[ref];
+    if (clause.learnt) {
+      bumpClause(clause);
+    }
+    const Lit* lits = &literal_pool[clause.start];
+    for (uint32_t k = (p == UNDEFINED_LIT ? 0 : 1); k < clause.size; ++k) {
+      const uint32_t v = var(lits[k]);
+      if (!seen[v] && levels[v] > 0) {
+        seen[v] = 1;
+        bumpVariable(v);
+        if (levels[v] >= decisionLevel()) {
+          ++path_count;
+        }
+        else {
+          learnt.push_back(lits[k]);
+        }
+      }
+    }
+
+    // Next marked literal on the trail
+    do {
+      --index;
+    } while (!seen[var(trail[index])]);
+    p = trail[index];
+    ref = reasons[var(p)];
+    seen[var(p)] = 0;
+    --path_count;
+  } while (path_count > 0);
+  learnt[0] = p ^ 1;
+
+  // Drop literals implied by the rest of the clause
+  marked.assign(learnt.begin() + 1, learnt.end());
+  size_t kept = 1;
+  for (size_t i = 1; i < learnt.size(); ++i) {
+    if (reasons[var(learnt[i])] == NO_REASON || !isRedundant(learnt[i])) {
+      learnt[kept++] = learnt[i];
+    }
+  }
+  learnt.resize(kept);
+  for (Lit lit : marked) {
+    seen[var(lit)] = 0;
+  }
+
+  // Second watch: the literal assigned last among the rest
+  backtrack_level = 0;
+  if (learnt.size() > 1) {
+    size_t highest = 1;
+    for (size_t i = 2; i < learnt.size(); ++i) {
+      if (levels[var(learnt[i])] > levels[var(learnt[highest])]) {
+        highest = i;
+      }
+    }
+    swap(learnt[1], learnt[highest]);
+    backtrack_level = levels[var(learnt[1])];
+  }
+
+  // Literal-block distance: number of distinct decision levels
+  ++stamp;
+  lbd = 0;
+  for (Lit lit : learnt) {
+    const uint32_t level = levels[var(lit)];
+    if (level_stamp[level] != stamp) {
+      level_stamp[level] = stamp;
+      ++lbd;
+    }
+  }
+}
+
+// A learnt literal is redundant if its reason contains only marked or level-0 literals
+bool SAT_Solver::isRedundant(Lit lit) const {
+  const Clause& clause = clauses[reasons[var(lit)]];
+  const Lit* lits = &literal_pool[clause.start];
+  for (uint32_t k = 1; k < clause.size; ++k) {
+    const uint32_t v = var(lits[k]);
+    if (!seen[v] && levels[v] > 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// ---------------------------------- VSIDS -----------------------------------
+
+void SAT_Solver::bumpVariable(uint32_t v) {
+  activity[v] += variable_increment;
+  if (activity[v] > 1e100) {
+    for (double& a : activity) {
+      a *= 1e-100;
+    }
+    variable_increment *= 1e-100;
+  }
+  if (heap_position[v] >= 0) {
+    heapUp(static_cast<size_t>(heap_position[v]));
+  }
+}
+
+void SAT_Solver::bumpClause(Clause& clause) {
+  clause.activity += clause_increment;
+  if (clause.activity > 1e20f) {
+    for (Clause& c : clauses) {
+      if (c.learnt) {
+        c.activity *= 1e-20f;
+      }
+    }
+    clause_increment *= 1e-20f;
+  }
+}
+
+void SAT_Solver::heapInsert(uint32_t v) {
+  if (heap_position[v] >= 0) {
+    return;
+  }
+  heap_position[v] = static_cast<int32_t>(heap.size());
+  heap.push_back(v);
+  heapUp(heap.size() - 1);
+}
+
+void SAT_Solver::heapUp(size_t index) {
+  const uint32_t v = heap[index];
+  while (index > 0) {
+    const size_t parent = (index - 1) / 2;
+    if (!heapLess(v, heap[parent])) {
+      break;
+    }
+    heap[index] = heap[parent];
+    heap_position[heap[index]] = static_cast<int32_t>(index);
+    index = parent;
+  }
+  heap[index] = v;
+  heap_position[v] = static_cast<int32_t>(index);
+}
+
+void SAT_Solver::heapDown(size_t index) {
+  const uint32_t v = heap[index];
+  const size_t size = heap.size();
+  while (true) {
+    size_t child = 2 * index + 1;
+    if (child >= size) {
+      break;
+    }
+    if (child + 1 < size && heapLess(heap[child + 1], heap[child])) {
+      ++child;
+    }
+    if (!heapLess(heap[child], v)) {
+      break;
+    }
+    heap[index] = heap[child];
+    heap_position[heap[index]] = static_cast<int32_t>(index);
+    index = child;
+  }
+  heap[index] = v;
+  heap_position[v] = static_cast<int32_t>(index);
+}
+
+uint32_t SAT_Solver::heapPop() {
+  const uint32_t top = heap[0];
+  const uint32_t last = heap.back();
+  heap.pop_back();
+  heap_position[top] = -1;
+  if (!heap.empty()) {
+    heap[0] = last;
+    heap_position[last] = 0;
+    heapDown(0);
+  }
+  return top;
+}
+
+// ------------------------------ Clause deletion -----------------------------
+
+/**
+ * @brief Delete about half of the learnt clauses (at decision level 0).
+ * Clauses with LBD <= 2 ("glue" clauses) are always kept; the rest are
+ * ranked by LBD, then activity. Clauses satisfied at level 0 are dropped
+ * and false level-0 literals removed, then the pool is compacted and the
+ * watches rebuilt.
+ */
+void SAT_Solver::reduceLearnts() {
+  // Level-0 literals never take part in analysis, so their reasons can go
+  for (Lit lit : trail) {
+    reasons[var(lit)] = NO_REASON;
+  }
+
+  vector<Clause_Ref> candidates;
+  for (Clause_Ref ref = 0; ref < clauses.size(); ++ref) {
+    if (clauses[ref].learnt && clauses[ref].lbd > 2) {
+      candidates.push_back(ref);
+    }
+  }
+  sort(candidates.begin(), candidates.end(), [this](Clause_Ref a, Clause_Ref b) {
+    if (clauses[a].lbd != clauses[b].lbd) return clauses[a].lbd > clauses[b].lbd;
+    return clauses[a].activity < clauses[b].activity;
+  });
+  vector<bool> removed(clauses.size(), false);
+  for (size_t i = 0; i < candidates.size() / 2; ++i) {
+    removed[candidates[i]] = true;
+  }
+
+  vector<Lit> pool;
+  vector<Clause> kept;
+  pool.reserve(literal_pool.size());
+  kept.reserve(clauses.size());
+  learnt_count = 0;
+
+  for (Clause_Ref ref = 0; ref < clauses.size(); ++ref) {
+    if (removed[ref]) {
+      continue;
+    }
+    Clause clause = clauses[ref];
+    const Lit* lits = &literal_pool[clause.start];
+    bool satisfied = false;
+    for (uint32_t k = 0; k < clause.size; ++k) {
+      if (value(lits[k]) == 1) {
+        satisfied = true;
+        break;
+      }
+    }
+    if (satisfied) {
+      continue;
+    }
+
+    // Level 0 is fully propagated, so at least two literals remain
+    const uint32_t start = static_cast<uint32_t>(pool.size());
+    for (uint32_t k = 0; k < clause.size; ++k) {
+      if (value(lits[k]) == 0) {
+        pool.push_back(lits[k]);
+      }
+    }
+    clause.start = start;
+    clause.size = static_cast<uint32_t>(pool.size()) - start;
+    kept.push_back(clause);
+    if (clause.learnt) {
+      ++learnt_count;
+    }
+  }
+
+  literal_pool.swap(pool);
+  clauses.swap(kept);
+  for (vector<Watcher>& list : watches) {
+    list.clear();
+  }
+  for (Clause_Ref ref = 0; ref < clauses.size(); ++ref) {
+    attach(ref);
+  }
+}
+
+// --------------------------------- Search -----------------------------------
+
+// Luby sequence 1 1 2 1 1 2 4 1 1 2 1 1 2 4 8 ...
+uint64_t SAT_Solver::luby(uint64_t index) {
+  uint64_t size = 1;
+  uint32_t sequence = 0;
+  while (size < index + 1) {
+    ++sequence;
+    size = 2 * size + 1;
+  }
+  while (size - 1 != index) {
+    size = (size - 1) >> 1;
+    --sequence;
+    index %= size;
+  }
+  return uint64_t(1) << sequence;
+}
+
+/**
+ * @brief Search until a model, a refutation, or conflict_budget conflicts
+ * (then restart from level 0 and return UNKNOWN).
+ */
+SAT_Solver::Result SAT_Solver::search(uint64_t conflict_budget, uint64_t conflict_limit) {
+  uint64_t conflicts = 0;
+
+  while (true) {
+    const Clause_Ref conflict = propagate();
+    if (conflict != NO_REASON) {
+      ++statistics.conflicts;
+      ++conflicts;
+      if (decisionLevel() == 0) {
+        ok = false;
+        return Result::UNSATISFIABLE;
+      }
+
+      uint32_t backtrack_level;
+      uint32_t lbd;
+      analyze(conflict, backtrack_level, lbd);
+      backtrack(backtrack_level);
+
+      if (learnt.size() == 1) {
+        enqueue(learnt[0], NO_REASON);
+      }
+      else {
+        const Clause_Ref ref = storeClause(learnt, true, lbd);
+        attach(ref);
+        bumpClause(clauses[ref]);
+        enqueue(learnt[0], ref);
+      }
+      ++statistics.learnt_clauses;
+      variable_increment /= VARIABLE_DECAY;
+      clause_increment /= CLAUSE_DECAY;
+      continue;
+    }
+
+    if (conflicts >= conflict_budget || (conflict_limit && statistics.conflicts >= conflict_limit)) {
+      backtrack(0);
+      return Result::UNKNOWN;
+    }
+
+    // Decide: most active unassigned variable, in its saved phase
+    Lit next = UNDEFINED_LIT;
+    while (!heap.empty()) {
+      const uint32_t v = heapPop();
+      if (values[v] == 0) {
+        next = 2 * v + (saved_phase[v] ? 0 : 1);
+        break;
+      }
+    }
+    if (next == UNDEFINED_LIT) {
+      model.resize(values.size());
+      for (size_t v = 0; v < values.size(); ++v) {
+        model[v] = values[v] == 1;
+      }
+      backtrack(0);
+      return Result::SATISFIABLE;
+    }
+
+    ++statistics.decisions;
+    trail_limits.push_back(static_cast<uint32_t>(trail.size()));
+    enqueue(next, NO_REASON);
+  }
+}
+
+SAT_Solver::Result SAT_Solver::solve(uint64_t conflict_limit) {
+  model.clear();
+  if (!ok) {
+    return Result::UNSATISFIABLE;
+  }
+  backtrack(0);
+  if (propagate() != NO_REASON) {
+    ok = false;
+    return Result::UNSATISFIABLE;
+  }
+  if (max_learnts == 0) {
+    max_learnts = max(2000.0, (clauses.size() - learnt_count) / 3.0);
+  }
+
+  for (uint64_t restart = 0;; ++restart) {
+    const Result result = search(luby(restart) * RESTART_BASE, conflict_limit);
+    if (result != Result::UNKNOWN) {
+      return result;
+    }
+    if (conflict_limit && statistics.conflicts >= conflict_limit) {
+      return Result::UNKNOWN;
+    }
+    ++statistics.restarts;
+    if (learnt_count >= max_learnts + trail.size()) {
+      reduceLearnts();
+      max_learnts *= 1.1;
+    }
+  }
+}
+
+bool SAT_Solver::getModelValue(int variable) const {
+  if (variable < 1 || static_cast<size_t>(variable) > model.size()) {
+    throw out_of_range("SAT_Solver: no model value for variable " + to_string(variable));
+  }
+  return model[variable - 1];
+}
+
+const SAT_Solver::Statistics& SAT_Solver::getStatistics() const {
+  return statistics;
+}
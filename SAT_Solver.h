@@ -0,0 +1,154 @@
+/**
+ * @class SAT_Solver
+ * @brief Conflict-driven clause-learning SAT solver for CNF formulas.
+ *
+ * Answers "is there any assignment that makes this true?" for formulas far
+ * too large to tabulate (see Tseitin_Encoder for turning an expression
+ * into CNF). Literals use the DIMACS convention: variable v is v, its
+ * negation is -v, variables are numbered from 1.
+ *
+ * Techniques:
+ *  - Two watched literals per clause for unit propagation
+ *  - VSIDS decision heuristic (decaying variable activity in a binary heap)
+ *    with phase saving
+ *  - First-UIP conflict analysis with learnt-clause minimization
+ *  - Luby restarts; learnt clauses are periodically halved, keeping the
+ *    ones with low literal-block distance (LBD) and high activity
+ *
+ * Clauses are stored back to back in one literal pool and referred to by
+ * index, like the node arrays of BDD_Manager.
+ */
+
+#ifndef SAT_SOLVER_H
+#define SAT_SOLVER_H
+
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+class SAT_Solver {
+  public:
+    enum class Result {
+      SATISFIABLE,
+      UNSATISFIABLE,
+      UNKNOWN        // conflict limit reached
+    };
+
+    struct Statistics {
+      uint64_t decisions = 0;
+      uint64_t propagations = 0;
+      uint64_t conflicts = 0;
+      uint64_t restarts = 0;
+      uint64_t learnt_clauses = 0;   // learnt in total (some are deleted again)
+    };
+
+    static constexpr uint32_t RESTART_BASE = 100;  // conflicts per Luby unit
+
+  private:
+    using Lit = uint32_t;                    // 2 * variable + (1 if negated)
+    using Clause_Ref = uint32_t;
+    static constexpr Clause_Ref NO_REASON = UINT32_MAX;
+
+    struct Clause {
+      uint32_t start;      // first literal in literal_pool
+      uint32_t size;
+      uint32_t lbd;        // literal-block distance when learnt
+      float activity;
+      bool learnt;
+    };
+
+    struct Watcher {
+      Clause_Ref clause;
+      Lit blocker;         // some other literal of the clause; if true, skip the clause
+    };
+
+    // Clause database
+    vector<Lit> literal_pool;
+    vector<Clause> clauses;
+    size_t learnt_count = 0;
+    double max_learnts = 0;
+    vector<vector<Watcher>> watches;   // per literal: clauses to visit when it becomes true
+
+    // Assignment: per variable value (1 true, -1 false, 0 unassigned)
+    vector<int8_t> values;
+    vector<uint32_t> levels;
+    vector<Clause_Ref> reasons;
+    vector<bool> saved_phase;
+    vector<Lit> trail;
+    vector<uint32_t> trail_limits;     // trail size at the start of each decision level
+    size_t propagate_head = 0;
+
+    // VSIDS
+    vector<double> activity;
+    double variable_increment = 1.0;
+    float clause_increment = 1.0f;
+    vector<uint32_t> heap;             // variables ordered by activity
+    vector<int32_t> heap_position;     // -1 when not in the heap
+
+    // Conflict analysis scratch
+    vector<uint8_t> seen;
+    vector<Lit> learnt;
+    vector<Lit> marked;                // literals whose seen flag must be cleared
+    vector<uint64_t> level_stamp;      // for counting distinct levels (LBD)
+    uint64_t stamp = 0;
+
+    vector<bool> model;
+    bool ok = true;                    // false once the formula is known to be UNSAT
+    Statistics statistics;
+
+    static Lit toLit(int literal);
+    static uint32_t var(Lit lit) { return lit >> 1; }
+    int8_t value(Lit lit) const {
+      const int8_t v = values[lit >> 1];
+      return (lit & 1) ? -v : v;
+    }
+    uint32_t decisionLevel() const { return static_cast<uint32_t>(trail_limits.size()); }
+
+    void enqueue(Lit lit, Clause_Ref reason);
+    Clause_Ref propagate();
+    void analyze(Clause_Ref conflict, uint32_t& backtrack_level, uint32_t& lbd);
+    bool isRedundant(Lit lit) const;
+    void backtrack(uint32_t level);
+    Clause_Ref storeClause(const vector<Lit>& lits, bool is_learnt, uint32_t lbd);
+    void attach(Clause_Ref ref);
+    void reduceLearnts();
+    Result search(uint64_t conflict_budget, uint64_t conflict_limit);
+
+    // VSIDS helpers
+    void bumpVariable(uint32_t v);
+    void bumpClause(Clause& clause);
+    void heapInsert(uint32_t v);
+    void heapUp(size_t index);
+    void heapDown(size_t index);
+    uint32_t heapPop();
+    bool heapLess(uint32_t a, uint32_t b) const { return activity[a] > activity[b]; }
+
+    static uint64_t luby(uint64_t index);
+
+  public:
+    SAT_Solver() = default;
+
+    // Add a variable and return its number (1, 2, ...)
+    int newVariable();
+    size_t getVariableCount() const;
+
+    // Add a clause of DIMACS literals (an empty clause makes the formula
+    // UNSAT); variables are created as needed. Must not be called during
+    // solve(). Duplicate literals are merged and tautologies dropped.
+    void addClause(const vector<int>& literals);
+
+    // Clauses in the database, original and learnt
+    size_t getClauseCount() const;
+
+    // Search for a satisfying assignment; with conflict_limit > 0, give up
+    // with UNKNOWN after that many conflicts
+    Result solve(uint64_t conflict_limit = 0);
+
+    // Value of a variable in the last satisfying assignment
+    bool getModelValue(int variable) const;
+
+    const Statistics& getStatistics() const;
+};
+
+#endif //SAT_SOLVER_H
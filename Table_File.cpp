@@ -0,0 +1,228 @@
+/**
+ * @file Table_File.cpp
+ * @brief Opens a packed truth-table file with mmap and answers queries
+ *        straight from the mapped bitsets (nothing is decoded up front).
+ */
+
+#include "Table_File.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define TABLE_FILE_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// Set bits in a word
+static inline uint64_t popcount64(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_popcountll(word);
+#else
+  uint64_t count = 0;
+  for (; word; word &= word - 1) ++count;
+  return count;
+#endif
+}
+
+// Index of the lowest set bit (word must be non-zero)
+static inline unsigned lowestBit(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctzll(word);
+#else
+  unsigned bit = 0;
+  while (!((word >> bit) & 1)) ++bit;
+  return bit;
+#endif
+}
+
+/**
+ * @brief Read one length-prefixed string from the metadata block.
+ */
+static string readString(const unsigned char* base, size_t end, size_t& position) {
+  uint32_t length;
+  if (position + sizeof(length) > end) {
+    throw runtime_error("Truncated table file metadata");
+  }
+  memcpy(&length, base + position, sizeof(length));
+  position += sizeof(length);
+  if (position + length > end) {
+    throw runtime_error("Truncated table file metadata");
+  }
+  string text(reinterpret_cast<const char*>(base + position), length);
+  position += length;
+  return text;
+}
+
+// Constructor : map the file and validate header and metadata
+Table_File::Table_File(const string& path) {
+#ifdef TABLE_FILE_HAS_MMAP
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw runtime_error("Cannot open table file " + path);
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0) {
+    ::close(fd);
+    throw runtime_error("Cannot stat table file " + path);
+  }
+  size = static_cast<size_t>(info.st_size);
+  if (size > 0) {
+    void* address = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (address == MAP_FAILED) {
+      ::close(fd);
+      throw runtime_error("Cannot map table file " + path);
+    }
+    data = static_cast<const unsigned char*>(address);
+    mapped = true;
+  }
+  ::close(fd); // the mapping stays valid after close
+#else
+  ifstream in(path, ios::binary);
+  if (!in) {
+    throw runtime_error("Cannot open table file " + path);
+  }
+  fallback.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+  data = fallback.data();
+  size = fallback.size();
+#endif
+
+  if (size < sizeof(header)) {
+    release();
+    throw runtime_error("Not a table file: " + path);
+  }
+  memcpy(&header, data, sizeof(header));
+
+  // Sizes come from the file, so they are compared by division and
+  // subtraction: a crafted header must not wrap a product or a sum
+  if (memcmp(header.magic, "TTBL", 4) != 0 || header.version != TABLE_FILE_VERSION ||
+      header.column_count == 0 || header.words_per_column != header.last_row / 64 + 1 ||
+      header.data_offset % 8 != 0 || header.data_offset < sizeof(header) || header.data_offset > size ||
+      header.words_per_column > (size - header.data_offset) / sizeof(uint64_t) / header.column_count ||
+      header.metadata_size > header.data_offset - sizeof(header)) {
+    release();
+    throw runtime_error("Not a valid table file: " + path);
+  }
+
+  // Metadata: variables, column labels, canonical expression
+  size_t position = sizeof(header);
+  const size_t end = sizeof(header) + header.metadata_size;
+  try {
+    for (uint32_t i = 0; i < header.variable_count; ++i) {
+      variables.push_back(readString(data, end, position));
+    }
+    for (uint32_t i = 0; i < header.column_count; ++i) {
+      column_labels.push_back(readString(data, end, position));
+    }
+    expression = readString(data, end, position);
+  }
+  catch (...) {
+    release();
+    throw;
+  }
+}
+
+Table_File::~Table_File() {
+  release();
+}
+
+// Unmap the file (also used when the constructor rejects it)
+void Table_File::release() {
+#ifdef TABLE_FILE_HAS_MMAP
+  if (mapped) {
+    munmap(const_cast<unsigned char*>(data), size);
+    mapped = false;
+  }
+#endif
+  data = nullptr;
+}
+
+const uint64_t* Table_File::column(size_t index) const {
+  if (index >= header.column_count) {
+    throw out_of_range("Table file has no column " + to_string(index));
+  }
+  // data_offset is 8-byte aligned and mmap returns page-aligned memory
+  return reinterpret_cast<const uint64_t*>(data + header.data_offset) + index * header.words_per_column;
+}
+
+const vector<string>& Table_File::getVariables() const {
+  return variables;
+}
+
+const vector<string>& Table_File::getColumnLabels() const {
+  return column_labels;
+}
+
+const string& Table_File::getExpression() const {
+  return expression;
+}
+
+uint64_t Table_File::getLastRow() const {
+  return header.last_row;
+}
+
+size_t Table_File::getColumnCount() const {
+  return header.column_count;
+}
+
+size_t Table_File::getResultColumn() const {
+  return header.column_count - 1;
+}
+
+bool Table_File::value(uint64_t row) const {
+  return value(row, getResultColumn());
+}
+
+bool Table_File::value(uint64_t row, size_t index) const {
+  if (row > header.last_row) {
+    throw out_of_range("Row " + to_string(row) + " is outside the table");
+  }
+  return (column(index)[row / 64] >> (row % 64)) & 1;
+}
+
+uint64_t Table_File::countTrue() const {
+  return countTrue(getResultColumn());
+}
+
+/**
+ * @brief Popcount the bitset. Bits past the last row are written as 0.
+ */
+uint64_t Table_File::countTrue(size_t index) const {
+  const uint64_t* bits = column(index);
+  uint64_t count = 0;
+  for (uint64_t w = 0; w < header.words_per_column; ++w) {
+    count += popcount64(bits[w]);
+  }
+  return count;
+}
+
+bool Table_File::nextTrueRow(uint64_t from, uint64_t& row) const {
+  return nextTrueRow(from, getResultColumn(), row);
+}
+
+/**
+ * @brief Find the next set bit at or after `from`, skipping zero words.
+ */
+bool Table_File::nextTrueRow(uint64_t from, size_t index, uint64_t& row) const {
+  const uint64_t* bits = column(index);
+  if (from > header.last_row) {
+    return false;
+  }
+
+  uint64_t w = from / 64;
+  uint64_t word = bits[w] & (~0ull << (from % 64));
+  while (word == 0) {
+    if (++w == header.words_per_column) {
+      return false;
+    }
+    word = bits[w];
+  }
+  row = w * 64 + lowestBit(word);
+  return true;
+}
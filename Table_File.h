@@ -0,0 +1,85 @@
+/**
+ * @class Table_File
+ * @brief Memory-mapped reader for packed binary truth-table files.
+ *
+ * A table file stores one bit per row for each saved column: the result
+ * column, and optionally every step column. A 2^32-row result takes 512 MiB.
+ *
+ * Layout (little-endian):
+ *   Table_File_Header
+ *   metadata : length-prefixed strings (u32 length + bytes)
+ *              variables..., column labels..., canonical expression
+ *   padding  : up to data_offset (64-byte aligned)
+ *   columns  : column_count bitsets of words_per_column u64 words;
+ *              bit (r % 64) of word (r / 64) is the value of row r.
+ *              The last column is always the result.
+ *
+ * Files are written by Truth_Table::saveBinary().
+ */
+
+#ifndef TABLE_FILE_H
+#define TABLE_FILE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+struct Table_File_Header {
+  char magic[4];              // "TTBL"
+  uint32_t version;           // TABLE_FILE_VERSION
+  uint32_t variable_count;
+  uint32_t column_count;      // saved bitsets (result is the last one)
+  uint64_t last_row;          // rows = last_row + 1
+  uint64_t words_per_column;
+  uint64_t metadata_size;     // bytes of strings after the header
+  uint64_t data_offset;       // file offset of the first bitset
+};
+
+static const uint32_t TABLE_FILE_VERSION = 1;
+
+class Table_File {
+  private:
+    const unsigned char* data = nullptr;  // whole file, mapped read-only
+    size_t size = 0;
+    vector<unsigned char> fallback;       // used where mmap is unavailable
+    bool mapped = false;
+
+    Table_File_Header header;
+    vector<string> variables;
+    vector<string> column_labels;
+    string expression;
+
+    const uint64_t* column(size_t index) const;
+    void release();
+
+  public:
+    // Map the file; throws runtime_error if it is missing or malformed
+    explicit Table_File(const string& path);
+    ~Table_File();
+
+    Table_File(const Table_File&) = delete;
+    Table_File& operator=(const Table_File&) = delete;
+
+    const vector<string>& getVariables() const;
+    const vector<string>& getColumnLabels() const;
+    const string& getExpression() const;
+    uint64_t getLastRow() const;
+    size_t getColumnCount() const;
+    size_t getResultColumn() const;
+
+    // Value of a column (default: the result) at row r
+    bool value(uint64_t row) const;
+    bool value(uint64_t row, size_t column) const;
+
+    // Number of rows where the column is 1 (popcount over the bitset)
+    uint64_t countTrue() const;
+    uint64_t countTrue(size_t column) const;
+
+    // First row >= from where the column is 1; false if there is none
+    bool nextTrueRow(uint64_t from, uint64_t& row) const;
+    bool nextTrueRow(uint64_t from, size_t column, uint64_t& row) const;
+};
+
+#endif //TABLE_FILE_H
@@ -0,0 +1,220 @@
+/**
+ * @file Table_Rows.cpp
+ * @brief Row cursor, filters and the two row ranges.
+ *
+ * A filter is applied a word at a time: for the 64 rows of word w,
+ *   match = column(A)[w] ^ column(B)[w] ^ (value ? 0 : ~0)
+ * so nextMatch() finds the next matching row with one lowestBit() per
+ * word and countMatches() with one popcount.
+ */
+
+#include "Table_Rows.h"
+#include "Run_Stats.h"
+#include "Truth_Table.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+// Index of the lowest set bit (word must be non-zero)
+static inline unsigned lowestBit(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctzll(word);
+#else
+  unsigned bit = 0;
+  while (!((word >> bit) & 1)) ++bit;
+  return bit;
+#endif
+}
+
+// Set bits in a word
+static inline uint64_t popcount64(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_popcountll(word);
+#else
+  uint64_t count = 0;
+  for (; word; word &= word - 1) ++count;
+  return count;
+#endif
+}
+
+// Every row: 0 XOR 0 == 0
+Row_Filter Row_Filter::all() {
+  return Row_Filter();
+}
+
+Row_Filter Row_Filter::result(bool value) {
+  return compare(Operand::RESULT, 0, Operand::NONE, 0, value);
+}
+
+Row_Filter Row_Filter::variable(size_t slot, bool value) {
+  return compare(Operand::VARIABLE, slot, Operand::NONE, 0, value);
+}
+
+Row_Filter Row_Filter::step(size_t step, bool value) {
+  return compare(Operand::STEP, step, Operand::NONE, 0, value);
+}
+
+Row_Filter Row_Filter::stepDiffers(size_t step) {
+  return compare(Operand::STEP, step, Operand::RESULT, 0, true);
+}
+
+Row_Filter Row_Filter::compare(Operand first_kind, size_t first, Operand second_kind, size_t second, bool value) {
+  Row_Filter filter;
+  filter.first_kind = first_kind;
+  filter.first = first;
+  filter.second_kind = second_kind;
+  filter.second = second;
+  filter.value = value;
+  return filter;
+}
+
+// Constructor : evaluator over the table's program; no block loaded yet
+Row_Cursor::Row_Cursor(const Truth_Table& table)
+  : program(table.getProgram()), evaluator(program), block(evaluator.getBufferWords()),
+    last_row(table.getLastRow()), variable_count(table.getVariables().size()) {
+  if (variable_count >= Truth_Table::MAX_VARIABLES) {
+    throw length_error("Row ranges need fewer than " + to_string(Truth_Table::MAX_VARIABLES) + " variables");
+  }
+}
+
+/**
+ * @brief Make block_index the evaluated block. Moving from the loaded
+ * block re-runs only the cones of the variables whose vectors differ.
+ */
+const uint64_t* Row_Cursor::load(uint64_t block_index) {
+  const uint64_t rows = evaluator.getBlockRows();
+  if (loaded != block_index) {
+    Run_Stats::add(Run_Stats::Counter::BLOCKS, 1);
+  }
+  if (loaded == NO_BLOCK) {
+    evaluator.evaluateBlock(block_index * rows, block.data());
+  }
+  else if (loaded != block_index) {
+    evaluator.updateBlock(loaded * rows, block_index * rows, block.data());
+  }
+  loaded = block_index;
+  return block.data();
+}
+
+// Buffer column of a filter operand; NONE has no column
+size_t Row_Cursor::column(Row_Filter::Operand kind, size_t index) const {
+  switch (kind) {
+    case Row_Filter::Operand::RESULT:
+      return program.getResultIndex();
+    case Row_Filter::Operand::VARIABLE:
+      if (index >= variable_count) {
+        throw out_of_range("Row filter: no variable " + to_string(index));
+      }
+      return index;
+    case Row_Filter::Operand::STEP:
+      if (index >= program.getStepLabels().size()) {
+        throw out_of_range("Row filter: no step " + to_string(index));
+      }
+      return variable_count + index;
+    case Row_Filter::Operand::NONE:
+      break;
+  }
+  return SIZE_MAX;
+}
+
+Table_Row Row_Cursor::row(uint64_t index) {
+  if (index > last_row) {
+    throw out_of_range("Row " + to_string(index) + " is past the last row " + to_string(last_row));
+  }
+  const uint64_t rows = evaluator.getBlockRows();
+  const size_t words = evaluator.getBlockWords();
+  const uint64_t* buffer = load(index / rows);
+  const uint64_t offset = index % rows;
+
+  Table_Row row;
+  row.index = index;
+  row.variable_count = variable_count;
+  row.column_count = variable_count + program.getStepLabels().size();
+  row.result_column = program.getResultIndex();
+  row.values.assign((row.column_count + 63) / 64, 0);
+  for (size_t c = 0; c < row.column_count; ++c) {
+    const uint64_t bit = (buffer[c * words + offset / 64] >> (offset % 64)) & 1;
+    row.values[c / 64] |= bit << (c % 64);
+  }
+  return row;
+}
+
+/**
+ * @brief Scan forward from `from` a word at a time. Each block is loaded
+ * once; bits before `from` and after last_row are masked off.
+ */
+uint64_t Row_Cursor::nextMatch(uint64_t from, const Row_Filter& filter) {
+  const size_t first = column(filter.first_kind, filter.first);
+  const size_t second = column(filter.second_kind, filter.second);
+  const uint64_t invert = filter.value ? 0 : ~0ull;
+  const uint64_t rows = evaluator.getBlockRows();
+  const size_t words = evaluator.getBlockWords();
+
+  while (from <= last_row) {
+    const uint64_t block_index = from / rows;
+    const uint64_t* buffer = load(block_index);
+    const uint64_t* a = first != SIZE_MAX ? buffer + first * words : nullptr;
+    const uint64_t* b = second != SIZE_MAX ? buffer + second * words : nullptr;
+
+    for (size_t w = (from % rows) / 64; w < words; ++w) {
+      const uint64_t word_row = block_index * rows + 64 * w;
+      if (word_row > last_row) {
+        return last_row + 1;
+      }
+      uint64_t match = (a ? a[w] : 0) ^ (b ? b[w] : 0) ^ invert;
+      if (word_row < from) {
+        match &= ~0ull << (from - word_row);
+      }
+      if (last_row - word_row < 63) {
+        match &= (1ull << (last_row - word_row + 1)) - 1;
+      }
+      if (match) {
+        return word_row + lowestBit(match);
+      }
+    }
+    from = (block_index + 1) * rows;
+  }
+  return last_row + 1;
+}
+
+/**
+ * @brief Popcount the filter's match words over every block. The order
+ * does not matter, so blocks are visited in Gray-code order (as in
+ * Truth_Table::countTrue()); the cursor's block is reloaded afterwards.
+ */
+uint64_t Row_Cursor::countMatches(const Row_Filter& filter) {
+  const size_t first = column(filter.first_kind, filter.first);
+  const size_t second = column(filter.second_kind, filter.second);
+  const uint64_t invert = filter.value ? 0 : ~0ull;
+  const size_t words = evaluator.getBlockWords();
+  const uint64_t total_words = last_row / 64 + 1;
+  const uint64_t block_count = (total_words + words - 1) / words;
+  uint64_t count = 0;
+
+  loaded = NO_BLOCK;
+  evaluator.forEachBlock(0, block_count, block.data(), [&](uint64_t index, const uint64_t* buffer) {
+    const uint64_t* a = first != SIZE_MAX ? buffer + first * words : nullptr;
+    const uint64_t* b = second != SIZE_MAX ? buffer + second * words : nullptr;
+    const uint64_t word = index * words;
+    const uint64_t used = min<uint64_t>(words, total_words - word);
+    for (uint64_t w = 0; w < used; ++w) {
+      uint64_t match = (a ? a[w] : 0) ^ (b ? b[w] : 0) ^ invert;
+      if (word + w == total_words - 1 && last_row % 64 != 63)
+        match &= (1ull << (last_row % 64 + 1)) - 1;
+      count += popcount64(match);
+    }
+  });
+  return count;
+}
+
+// Constructor : one cursor shared by the range and its iterators
+Table_Rows::Table_Rows(const Truth_Table& table) : cursor(make_shared<Row_Cursor>(table)) {
+}
+
+// Constructor : the filter's operands are checked on first use
+Filtered_Rows::Filtered_Rows(const Truth_Table& table, const Row_Filter& filter)
+  : cursor(make_shared<Row_Cursor>(table)), filter(filter) {
+}
@@ -0,0 +1,228 @@
+/**
+ * @class Table_Rows
+ * @brief Lazy ranges over the rows of a Truth_Table, for code that needs a
+ *        few rows rather than the printed table.
+ *
+ *  - Table_Rows: every row, as a random-access range (begin/end, size,
+ *    operator[]); a row is evaluated only when it is read
+ *  - Filtered_Rows: only the rows a Row_Filter accepts, as a forward
+ *    range. Whole blocks are evaluated bit-parallel and the filter is
+ *    applied to 64 rows per word, so rows that do not match cost nothing
+ *    but the block they are in
+ *  - Table_Row: the values of one row (variables, steps, result)
+ *
+ * Both ranges read through a Row_Cursor, which keeps one evaluated block
+ * and moves it with Bitslice_Evaluator::updateBlock(), so walking the rows
+ * in order re-runs only the cones of the variables that change. Iterators
+ * of one range share its cursor: they are cheap to copy, but a range must
+ * not be used from several threads at once, and the table must outlive it.
+ *
+ * Rows are in table order (row i has the bits of i as inputs, first
+ * variable = most significant bit), so at most 63 variables are allowed.
+ *
+ * Example: the first row where step 2 disagrees with the result
+ *   auto rows = table.rows(Row_Filter::stepDiffers(2));
+ *   auto first = rows.begin();
+ *   if (first != rows.end()) cout << first->getIndex();
+ */
+
+#ifndef TABLE_ROWS_H
+#define TABLE_ROWS_H
+
+#include "Bitslice_Evaluator.h"
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+class Truth_Table;
+
+// The values of one row: one bit per variable and per step
+class Table_Row {
+  private:
+    uint64_t index = 0;
+    size_t variable_count = 0;
+    size_t column_count = 0;
+    size_t result_column = 0;
+    vector<uint64_t> values;   // bit c = column c (variables, then steps)
+
+    friend class Row_Cursor;
+
+  public:
+    uint64_t getIndex() const { return index; }
+    size_t getVariableCount() const { return variable_count; }
+    size_t getStepCount() const { return column_count - variable_count; }
+
+    bool getVariable(size_t slot) const { return getColumn(slot); }
+    bool getStep(size_t step) const { return getColumn(variable_count + step); }
+    bool getResult() const { return getColumn(result_column); }
+
+    // Column c of the table's evaluator buffer (variables, then steps)
+    bool getColumn(size_t column) const { return (values[column / 64] >> (column % 64)) & 1; }
+};
+
+/**
+ * Which rows a Filtered_Rows yields: rows where (A XOR B) == value, with
+ * A and B each the result, a variable, a step, or nothing (always 0).
+ */
+class Row_Filter {
+  public:
+    enum class Operand : uint8_t { NONE, RESULT, VARIABLE, STEP };
+
+  private:
+    Operand first_kind = Operand::NONE;
+    Operand second_kind = Operand::NONE;
+    size_t first = 0;
+    size_t second = 0;
+    bool value = false;
+
+    friend class Row_Cursor;
+
+  public:
+    static Row_Filter all();
+    static Row_Filter result(bool value = true);
+    static Row_Filter variable(size_t slot, bool value = true);
+    static Row_Filter step(size_t step, bool value = true);
+
+    // Rows where step `step` is not equal to the result
+    static Row_Filter stepDiffers(size_t step);
+
+    // Rows where the two operands differ (value = true) or agree
+    static Row_Filter compare(Operand first_kind, size_t first, Operand second_kind, size_t second, bool value);
+};
+
+// One evaluated block of a table, shared by a range and its iterators
+class Row_Cursor {
+  private:
+    static constexpr uint64_t NO_BLOCK = UINT64_MAX;
+
+    const Compiled_Program& program;
+    Bitslice_Evaluator evaluator;
+    vector<uint64_t> block;
+    uint64_t loaded = NO_BLOCK;   // block index in the buffer
+    uint64_t last_row;
+    size_t variable_count;
+
+    const uint64_t* load(uint64_t block_index);
+    size_t column(Row_Filter::Operand kind, size_t index) const;
+
+  public:
+    // Throws length_error for 64 variables (the row count would not fit)
+    explicit Row_Cursor(const Truth_Table& table);
+
+    uint64_t getRowCount() const { return last_row + 1; }
+
+    // Evaluate one row
+    Table_Row row(uint64_t index);
+
+    // First row >= from that the filter accepts, or getRowCount()
+    uint64_t nextMatch(uint64_t from, const Row_Filter& filter);
+
+    // Rows the filter accepts (blocks in Gray-code order, popcounts)
+    uint64_t countMatches(const Row_Filter& filter);
+};
+
+// Every row of a table, random access
+class Table_Rows {
+  private:
+    shared_ptr<Row_Cursor> cursor;
+
+  public:
+    class Iterator {
+      private:
+        shared_ptr<Row_Cursor> cursor;
+        uint64_t index = 0;
+
+      public:
+        using iterator_category = random_access_iterator_tag;
+        using value_type = Table_Row;
+        using difference_type = int64_t;
+        using reference = Table_Row;   // computed on access, returned by value
+        struct pointer {
+          Table_Row row;
+          const Table_Row* operator->() const { return &row; }
+        };
+
+        Iterator() = default;
+        Iterator(shared_ptr<Row_Cursor> cursor, uint64_t index) : cursor(move(cursor)), index(index) {}
+
+        Table_Row operator*() const { return cursor->row(index); }
+        pointer operator->() const { return {cursor->row(index)}; }
+        Table_Row operator[](difference_type offset) const { return cursor->row(index + offset); }
+
+        Iterator& operator++() { ++index; return *this; }
+        Iterator operator++(int) { Iterator old = *this; ++index; return old; }
+        Iterator& operator--() { --index; return *this; }
+        Iterator operator--(int) { Iterator old = *this; --index; return old; }
+        Iterator& operator+=(difference_type offset) { index += offset; return *this; }
+        Iterator& operator-=(difference_type offset) { index -= offset; return *this; }
+        Iterator operator+(difference_type offset) const { return Iterator(cursor, index + offset); }
+        Iterator operator-(difference_type offset) const { return Iterator(cursor, index - offset); }
+        friend Iterator operator+(difference_type offset, const Iterator& it) { return it + offset; }
+        difference_type operator-(const Iterator& other) const {
+          return static_cast<difference_type>(index - other.index);
+        }
+
+        bool operator==(const Iterator& other) const { return index == other.index; }
+        bool operator!=(const Iterator& other) const { return index != other.index; }
+        bool operator<(const Iterator& other) const { return index < other.index; }
+        bool operator>(const Iterator& other) const { return index > other.index; }
+        bool operator<=(const Iterator& other) const { return index <= other.index; }
+        bool operator>=(const Iterator& other) const { return index >= other.index; }
+    };
+
+    explicit Table_Rows(const Truth_Table& table);
+
+    Iterator begin() const { return Iterator(cursor, 0); }
+    Iterator end() const { return Iterator(cursor, cursor->getRowCount()); }
+    uint64_t size() const { return cursor->getRowCount(); }
+    Table_Row operator[](uint64_t index) const { return cursor->row(index); }
+};
+
+// The rows of a table that a Row_Filter accepts, in row order
+class Filtered_Rows {
+  private:
+    shared_ptr<Row_Cursor> cursor;
+    Row_Filter filter;
+
+  public:
+    class Iterator {
+      private:
+        shared_ptr<Row_Cursor> cursor;
+        Row_Filter filter;
+        uint64_t index = 0;   // a matching row, or the row count at the end
+
+      public:
+        using iterator_category = forward_iterator_tag;
+        using value_type = Table_Row;
+        using difference_type = int64_t;
+        using reference = Table_Row;
+        using pointer = Table_Rows::Iterator::pointer;
+
+        Iterator() = default;
+        Iterator(shared_ptr<Row_Cursor> cursor, const Row_Filter& filter, uint64_t index)
+          : cursor(move(cursor)), filter(filter), index(index) {}
+
+        Table_Row operator*() const { return cursor->row(index); }
+        pointer operator->() const { return {cursor->row(index)}; }
+
+        Iterator& operator++() { index = cursor->nextMatch(index + 1, filter); return *this; }
+        Iterator operator++(int) { Iterator old = *this; ++*this; return old; }
+
+        bool operator==(const Iterator& other) const { return index == other.index; }
+        bool operator!=(const Iterator& other) const { return index != other.index; }
+    };
+
+    Filtered_Rows(const Truth_Table& table, const Row_Filter& filter);
+
+    Iterator begin() const { return Iterator(cursor, filter, cursor->nextMatch(0, filter)); }
+    Iterator end() const { return Iterator(cursor, filter, cursor->getRowCount()); }
+
+    // Number of matching rows, without building any Table_Row
+    uint64_t count() const { return cursor->countMatches(filter); }
+};
+
+#endif //TABLE_ROWS_H
@@ -0,0 +1,264 @@
+/**
+ * @file Table_Writer.cpp
+ * @brief Template-based truth-table formatting for text, CSV, JSON Lines
+ *        and Markdown output.
+ *
+ * Example (variables A, B; step "(A AND B)"), row template per format:
+ *   text     : "|0    |0    |0                   |\n"
+ *   csv      : "0,0,0\n"
+ *   jsonl    : "{\"A\":0,\"B\":0,\"(A AND B)\":0}\n"
+ *   markdown : "| 0 | 0 | 0         |\n"
+ */
+
+#include "Table_Writer.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+// Constructor : precompute header and row templates for the chosen format
+Table_Writer::Table_Writer(Format format, const vector<string>& variables, const vector<string>& step_labels)
+    : format(format), variable_count(variables.size()) {
+  buildTemplates(variables, step_labels);
+  for (uint32_t column = 0; column < cell_offsets.size(); ++column) {
+    sources.push_back(column);
+  }
+}
+
+// Constructor : variables, then the chosen block columns under their labels
+Table_Writer::Table_Writer(Format format, const vector<string>& variables, const vector<string>& labels,
+                           const vector<uint32_t>& step_columns)
+    : format(format), variable_count(variables.size()) {
+  if (labels.size() != step_columns.size()) {
+    throw invalid_argument("Table_Writer: one label is needed per column");
+  }
+  buildTemplates(variables, labels);
+  for (uint32_t slot = 0; slot < variable_count; ++slot) {
+    sources.push_back(slot);
+  }
+  sources.insert(sources.end(), step_columns.begin(), step_columns.end());
+}
+
+Table_Writer::~Table_Writer() {
+  flush();
+  if (owns_file) {
+    fclose(file);
+  }
+}
+
+bool Table_Writer::parseFormat(const string& name, Format& format) {
+  if (name == "text") format = Format::TEXT;
+  else if (name == "csv") format = Format::CSV;
+  else if (name == "jsonl") format = Format::JSON_LINES;
+  else if (name == "markdown" || name == "md") format = Format::MARKDOWN;
+  else return false;
+  return true;
+}
+
+// Quote a CSV field only when it contains a delimiter or quote
+static string csvField(const string& text) {
+  if (text.find_first_of(",\"\n") == string::npos) {
+    return text;
+  }
+  string quoted = "\"";
+  for (char ch : text) {
+    if (ch == '"') quoted += '"';
+    quoted += ch;
+  }
+  return quoted + "\"";
+}
+
+// JSON string literal (labels only contain printable ASCII, but escape anyway)
+static string jsonString(const string& text) {
+  string quoted = "\"";
+  for (char ch : text) {
+    if (ch == '"' || ch == '\\') quoted += '\\';
+    quoted += ch;
+  }
+  return quoted + "\"";
+}
+
+/**
+ * @brief Build the header text and the row template for the format.
+ * Cell offsets point at the '0' placeholder of each column, in
+ * [variables][steps] order.
+ */
+void Table_Writer::buildTemplates(const vector<string>& variables, const vector<string>& step_labels) {
+  vector<string> names = variables;
+  names.insert(names.end(), step_labels.begin(), step_labels.end());
+  const size_t column_count = names.size();
+
+  header.clear();
+  row_template.clear();
+  cell_offsets.assign(column_count, 0);
+
+  // Adds a cell placeholder and records where it is
+  auto cell = [&](size_t column) {
+    cell_offsets[column] = row_template.size();
+    row_template += '0';
+  };
+
+  switch (format) {
+    case Format::TEXT: {
+      // Columns are at least 5 (variables) / 20 (steps) wide and grow to fit
+      // longer names, so identifiers such as "req_valid" stay aligned
+      vector<size_t> widths(column_count);
+      for (size_t column = 0; column < column_count; ++column) {
+        widths[column] = max<size_t>(column < variable_count ? 5 : 20, names[column].size());
+      }
+
+      string separator;
+      for (size_t column = 0; column < column_count; ++column) {
+        const size_t pad = widths[column] - names[column].size();
+        if (column < variable_count) {
+          header += "|" + names[column] + string(pad, ' ');
+          separator += "|" + string(widths[column], '-');
+          row_template += '|';
+          cell(column);
+          row_template.append(widths[column] - 1, ' ');
+        }
+        else {
+          header += names[column] + string(pad, ' ') + "|";
+          separator += string(widths[column], '-') + "|";
+          cell(column);
+          row_template.append(widths[column] - 1, ' ');
+          row_template += '|';
+        }
+        if (column + 1 == variable_count) {
+          header += '|';
+          separator += '|';
+          row_template += '|';
+        }
+      }
+      header += "\n" + separator + "\n";
+      break;
+    }
+
+    case Format::CSV:
+      for (size_t column = 0; column < column_count; ++column) {
+        if (column > 0) {
+          header += ',';
+          row_template += ',';
+        }
+        header += csvField(names[column]);
+        cell(column);
+      }
+      header += '\n';
+      break;
+
+    case Format::JSON_LINES:
+      // No header line: every row carries its keys
+      row_template += '{';
+      for (size_t column = 0; column < column_count; ++column) {
+        if (column > 0) {
+          row_template += ',';
+        }
+        row_template += jsonString(names[column]) + ":";
+        cell(column);
+      }
+      row_template += '}';
+      break;
+
+    case Format::MARKDOWN: {
+      string separator = "|";
+      header = "|";
+      for (size_t column = 0; column < column_count; ++column) {
+        header += " " + names[column] + " |";
+        separator += string(names[column].size() + 2, '-') + "|";
+        row_template += (column == 0) ? "| " : " ";
+        cell(column);
+        row_template += string(names[column].size() - 1, ' ') + " |";
+      }
+      header += "\n" + separator + "\n";
+      break;
+    }
+  }
+
+  row_template += '\n';
+}
+
+/**
+ * @brief Open the output; an empty path writes to stdout.
+ */
+void Table_Writer::open(const string& path) {
+  sink = nullptr;
+  if (owns_file) {
+    fclose(file);
+    owns_file = false;
+  }
+
+  if (path.empty()) {
+    file = stdout;
+    return;
+  }
+
+  file = fopen(path.c_str(), "wb");
+  if (!file) {
+    file = nullptr;
+    throw runtime_error("Cannot open output file " + path);
+  }
+  owns_file = true;
+}
+
+/**
+ * @brief Send the output to a function instead of a file.
+ */
+void Table_Writer::open(Sink target) {
+  open(string());
+  sink = move(target);
+}
+
+void Table_Writer::writeHeader() {
+  write(header);
+}
+
+/**
+ * @brief Format a range of rows from an evaluated block.
+ * Each row copies the template and patches one digit per column.
+ */
+void Table_Writer::appendRows(const uint64_t* block, size_t words, uint64_t first_offset, uint64_t last_offset,
+                              string& out) const {
+  const size_t column_count = cell_offsets.size();
+  const size_t row_size = row_template.size();
+
+  size_t position = out.size();
+  out.resize(position + (last_offset - first_offset + 1) * row_size);
+  char* text = &out[0];
+
+  for (uint64_t offset = first_offset; offset <= last_offset; ++offset) {
+    const size_t word = offset / 64;
+    const size_t bit = offset % 64;
+    char* row = text + position;
+
+    row_template.copy(row, row_size);
+    for (size_t column = 0; column < column_count; ++column) {
+      row[cell_offsets[column]] = static_cast<char>('0' + ((block[sources[column] * words + word] >> bit) & 1));
+    }
+    position += row_size;
+  }
+}
+
+size_t Table_Writer::getRowSize() const {
+  return row_template.size();
+}
+
+/**
+ * @brief Write a finished buffer with a single fwrite().
+ */
+void Table_Writer::write(const string& data) {
+  if (sink) {
+    sink(data);
+    return;
+  }
+  if (!file) {
+    open(string());
+  }
+  fwrite(data.data(), 1, data.size(), file);
+}
+
+void Table_Writer::flush() {
+  if (file) {
+    fflush(file);
+  }
+}
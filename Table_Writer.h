@@ -0,0 +1,87 @@
+/**
+ * @class Table_Writer
+ * @brief Formats truth-table rows into large buffers and writes them out.
+ *
+ * Every format is described by templates built once from the column names:
+ *  - a header (and separator) text
+ *  - a row template with a placeholder for every cell, plus the cell offsets
+ * Formatting a row is then one append of the template and one byte store per
+ * cell; rows are written in big chunks with a single fwrite() each.
+ *
+ * Formats: aligned text (default), CSV, JSON Lines, Markdown.
+ *
+ * Output goes to a file, or to a sink function that receives each buffer
+ * (Evaluation_Server streams tables to a socket this way).
+ */
+
+#ifndef TABLE_WRITER_H
+#define TABLE_WRITER_H
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class Table_Writer {
+  public:
+    enum class Format { TEXT, CSV, JSON_LINES, MARKDOWN };
+
+    // Receives every written buffer in order
+    using Sink = function<void(const string& data)>;
+
+  private:
+    Format format;
+    size_t variable_count;
+    string header;                // header + separator, written once
+    string row_template;          // one row with '0' in every cell
+    vector<size_t> cell_offsets;  // position of each cell inside row_template
+    vector<uint32_t> sources;     // block column each table column is read from
+    FILE* file = nullptr;
+    bool owns_file = false;
+    Sink sink;                    // replaces the file when set
+
+    void buildTemplates(const vector<string>& variables, const vector<string>& step_labels);
+
+  public:
+    Table_Writer(Format format, const vector<string>& variables, const vector<string>& step_labels);
+
+    // Show only some step columns: column i after the variables is labelled
+    // labels[i] and read from block column step_columns[i]
+    Table_Writer(Format format, const vector<string>& variables, const vector<string>& labels,
+                 const vector<uint32_t>& step_columns);
+    ~Table_Writer();
+
+    Table_Writer(const Table_Writer&) = delete;
+    Table_Writer& operator=(const Table_Writer&) = delete;
+
+    // "text", "csv", "jsonl", "markdown"; returns false for unknown names
+    static bool parseFormat(const string& name, Format& format);
+
+    // Write to a file (empty path = stdout); throws runtime_error if it cannot be opened
+    void open(const string& path);
+
+    // Send every buffer to sink instead of a file
+    void open(Sink sink);
+
+    void writeHeader();
+
+    /**
+     * Append rows [first_offset, last_offset] of an evaluated block to out.
+     * block holds one bit vector of `words` words per column, [variables][steps]
+     * (the Bitslice_Evaluator buffer layout); every step is printed unless
+     * the writer was built with step_columns.
+     */
+    void appendRows(const uint64_t* block, size_t words, uint64_t first_offset, uint64_t last_offset,
+                    string& out) const;
+
+    // Bytes per formatted row (for sizing buffers)
+    size_t getRowSize() const;
+
+    void write(const string& data);
+    void flush();
+};
+
+#endif //TABLE_WRITER_H
@@ -0,0 +1,131 @@
+/**
+ * @file Tokenizer.cpp
+ * @brief Single pass over the source; words are classified in place.
+ *
+ * Rules:
+ *  - Whitespace separates tokens but is otherwise ignored
+ *  - '(' and ')' are single-character tokens
+ *  - A word of letters, digits and '_' is an operator keyword
+ *    (AND, OR, NOT, XOR, NAND, NOR), a constant (TRUE, FALSE) or else
+ *    a variable
+ *  - Anything else is reported with its position
+ */
+
+#include "Tokenizer.h"
+#include "Parse_Error.h"
+
+#include <cstdio>
+#include <string>
+
+using namespace std;
+
+// Byte classes, looked up once per byte instead of calling the locale-aware
+// <cctype> functions (the rules are ASCII-only anyway)
+enum : uint8_t { OTHER = 0, SPACE = 1, WORD = 2, WORD_START = 4 };
+
+static const struct Byte_Classes {
+  uint8_t table[256];
+
+  Byte_Classes() : table() {
+    for (int ch = 0; ch < 256; ++ch) {
+      if (ch == ' ' || (ch >= '\t' && ch <= '\r')) table[ch] = SPACE;
+      else if (ch == '_' || (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z')) table[ch] = WORD | WORD_START;
+      else if (ch >= '0' && ch <= '9') table[ch] = WORD;
+    }
+  }
+} byte_classes;
+
+static inline uint8_t classOf(char ch) {
+  return byte_classes.table[static_cast<unsigned char>(ch)];
+}
+
+bool Tokenizer::isIdentifierStart(char ch) {
+  return classOf(ch) & WORD_START;
+}
+
+bool Tokenizer::isIdentifierChar(char ch) {
+  return classOf(ch) & WORD;
+}
+
+// Constructor : empty token list, buffers from resource
+Tokenizer::Tokenizer(pmr::memory_resource* resource)
+  : tokens(resource), names(resource), name_ids(resource) {
+}
+
+// Constructor : tokenize the whole source
+Tokenizer::Tokenizer(string_view source, pmr::memory_resource* resource) : Tokenizer(resource) {
+  tokenize(source);
+}
+
+void Tokenizer::tokenize(string_view source) {
+  tokens.clear();
+  names.clear();
+  name_ids.clear();
+
+  if (source.size() > UINT32_MAX) {
+    throw Parse_Error(Parse_Error::Kind::TOO_LONG, "Expression is too long", UINT32_MAX);
+  }
+
+  // Rough guess: one token per three bytes
+  tokens.reserve(source.size() / 3 + 1);
+
+  const size_t end = source.size();
+  size_t i = 0;
+
+  while (i < end) {
+    const char ch = source[i];
+    const uint32_t offset = static_cast<uint32_t>(i);
+
+    if (classOf(ch) == SPACE) {
+      ++i;
+    }
+    else if (ch == '(' || ch == ')') {
+      tokens.push_back({ch == '(' ? Token_Kind::LEFT_PAREN : Token_Kind::RIGHT_PAREN, Opcode::VAR, 0, offset, 1});
+      ++i;
+    }
+    else if (classOf(ch) & WORD) {
+      // Take the whole word, then classify it
+      size_t stop = i + 1;
+      while (stop < end && (classOf(source[stop]) & WORD)) {
+        ++stop;
+      }
+      const string_view word = source.substr(i, stop - i);
+      const uint32_t length = static_cast<uint32_t>(word.size());
+
+      Opcode op;
+      if (Expression_DAG::lookupOpcode(word, op)) {
+        const Token_Kind kind = Expression_DAG::operandCount(op) == 0 ? Token_Kind::CONSTANT : Token_Kind::OPERATOR;
+        tokens.push_back({kind, op, 0, offset, length});
+      }
+      else if (!(classOf(ch) & WORD_START)) {
+        throw Parse_Error(Parse_Error::Kind::INVALID_NAME, "Invalid variable name " + Parse_Error::quote(word), offset, length);
+      }
+      else {
+        // Intern the name: every occurrence gets the same id
+        auto found = name_ids.try_emplace(word, static_cast<uint32_t>(names.size()));
+        if (found.second) {
+          names.push_back(word);
+        }
+        tokens.push_back({Token_Kind::VARIABLE, Opcode::VAR, found.first->second, offset, length});
+      }
+      i = stop;
+    }
+    else {
+      // Control and non-ASCII bytes are shown by value
+      char shown[8];
+      if (ch >= ' ' && ch <= '~')
+        snprintf(shown, sizeof(shown), "'%c'", ch);
+      else
+        snprintf(shown, sizeof(shown), "0x%02X", static_cast<unsigned char>(ch));
+      throw Parse_Error(Parse_Error::Kind::UNEXPECTED_CHARACTER, string("Unexpected character ") + shown, offset);
+    }
+  }
+}
+
+const pmr::vector<Token>& Tokenizer::getTokens() const {
+  return tokens;
+}
+
+const pmr::vector<string_view>& Tokenizer::getNames() const {
+  return names;
+}
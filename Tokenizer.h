@@ -0,0 +1,72 @@
+/**
+ * @class Tokenizer
+ * @brief Splits an expression into tokens that point back into the source.
+ *
+ * No token text is copied: each token records its kind, its opcode or
+ * variable id, and the offset/length of its text in the source buffer.
+ * Variables are interned while scanning, so every occurrence of a name
+ * shares one var_id (numbered in order of first appearance).
+ *
+ * All buffers come from the memory resource given to the constructor
+ * (the default heap unless an Expression_Arena supplies one).
+ *
+ * Keywords are recognized with a switch on the word length followed by a
+ * single comparison (Expression_DAG::lookupOpcode), not a map lookup.
+ *
+ * Example: "(A AND B) XOR NOT A"
+ *   → ( var0 AND var1 ) XOR NOT var0      names = {A, B}
+ */
+
+#ifndef TOKENIZER_H
+#define TOKENIZER_H
+
+#include "Expression_DAG.h"
+#include <cstdint>
+#include <memory_resource>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+enum class Token_Kind : uint8_t {
+  VARIABLE,
+  CONSTANT,     // TRUE or FALSE
+  OPERATOR,
+  LEFT_PAREN,
+  RIGHT_PAREN,
+};
+
+struct Token {
+  Token_Kind kind;
+  Opcode op;        // OPERATOR and CONSTANT only
+  uint32_t var_id;  // VARIABLE only: index into the tokenizer's names
+  uint32_t offset;  // first byte in the source
+  uint32_t length;  // bytes of source text
+};
+
+class Tokenizer {
+  private:
+    pmr::vector<Token> tokens;
+    pmr::vector<string_view> names;                     // var_id → name (views into the source)
+    pmr::unordered_map<string_view, uint32_t> name_ids;
+
+  public:
+    explicit Tokenizer(pmr::memory_resource* resource = pmr::get_default_resource());
+
+    // Scan the whole source; throws Parse_Error at the first character
+    // that cannot start a token. source must outlive the tokenizer.
+    explicit Tokenizer(string_view source, pmr::memory_resource* resource = pmr::get_default_resource());
+
+    // Replace the tokens with those of another source (buffers are reused)
+    void tokenize(string_view source);
+
+    const pmr::vector<Token>& getTokens() const;
+    const pmr::vector<string_view>& getNames() const;
+
+    // Identifier rules: letter or '_' first, then letters, digits or '_'
+    static bool isIdentifierStart(char ch);
+    static bool isIdentifierChar(char ch);
+};
+
+#endif //TOKENIZER_H
@@ -1,126 +1,440 @@
 
 #include "Truth_Table.h"
+#include "Ordered_Chunk_Writer.h"
+#include "Table_File.h"
+#include "Run_Stats.h"
 
 /**
  * @file Truth_Table.cpp
  * @brief Builds and prints the truth table for a Boolean_Expression.
  * Flow:
- *   1) detectVariables(): find which of A/B/C actually appear
- *   2) generateCombinations(): create all 2^n input rows
+ *   1) detectVariables(): find which variables actually appear
+ *   2) decodeRow(): rows are never stored; row i's inputs are the bits of i
  *   3) displayTable(): evaluate each row and print a formatted table
+ *      (or saveBinary(): store the result bits as a packed Table_File)
+ *
+ * The expression is compiled once in the constructor; rows are evaluated
+ * in bit-sliced blocks instead of re-reading the postfix strings.
  */
 
 #include <iostream>
-#include <cmath>
 #include <algorithm>
 #include <set>
-#include <iomanip>   // required for std::setw
+#include <stdexcept>
+#include <fstream>
+#include <cstring>
 
 
 using namespace std;
 
+// Set bits in a word
+static inline uint64_t popcount64(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_popcountll(word);
+#else
+  uint64_t count = 0;
+  for (; word; word &= word - 1) ++count;
+  return count;
+#endif
+}
+
+// Tokens of the expression separated by single spaces; the compiled
+// program's steps and labels depend on nothing else
+static string tokenSpelling(const Boolean_Expression& expression) {
+  string spelling;
+  for (const Token& token : expression.getTokens()) {
+    if (!spelling.empty()) spelling += ' ';
+    spelling += expression.tokenText(token);
+  }
+  return spelling;
+}
+
 // Constructor : stores the expression and prepares the table
-Truth_Table::Truth_Table(Boolean_Expression& expr): expression(expr) {
-  detectVariables();
-  generateCombinations();
+Truth_Table::Truth_Table(Boolean_Expression& expr, bool simplify, Expression_Cache* cache)
+  : expression(expr), cache(cache) {
+  {
+    Run_Stats::Scope scope(Run_Stats::Phase::DETECT_VARIABLES);
+    detectVariables();
+  }
+  {
+    Run_Stats::Scope scope(Run_Stats::Phase::COMPILE);
+    // The variables are the names in the canonical form, so the key
+    // determines the count and the result bits. The program's steps and
+    // labels follow the spelling: another spelling compiles its own.
+    string spelling;
+    if (cache) {
+      cache_key = (simplify ? "S " : "P ") + expression.getCanonicalForm();
+      spelling = tokenSpelling(expression);
+      cached = cache->find(cache_key);
+    }
+    if (cached && cached->spelling == spelling) {
+      program = cached->program;
+    }
+    else {
+      program = make_shared<const Compiled_Program>(expression.compile(used_variables, simplify));
+      if (cache && !cached) {
+        Expression_Cache::Entry entry;
+        entry.program = program;
+        entry.spelling = move(spelling);
+        cached = cache->insert(cache_key, move(entry));
+      }
+    }
+  }
+  Run_Stats::add(Run_Stats::Counter::VARIABLES, used_variables.size());
+  Run_Stats::add(Run_Stats::Counter::STEPS, program->getStepCount());
 }
 
 /**
- * @brief Step 1 — Detect which variables (A, B, C) appear in the expression.
+ * @brief Step 1 — Detect which variables appear in the expression.
  * Implementation note:
- *  - We examine the postfix tokens because they’re already normalized.
- *  - A std::set<char> avoids duplicates and keeps A<B<C ordering.
+ *  - The tokenizer has already interned each distinct name once.
+ *  - A std::set<string> keeps names sorted (A<B<C).
  */
 void Truth_Table::detectVariables() {
 
-  used_variables.clear();
+  used_variables = collectVariables({&expression});
 
-  // Use postfix for a reliable scan (tokens are already clean)
-  vector<string> parts = expression.convertToPostfix();
+  if (used_variables.size() > MAX_VARIABLES) {
+    throw invalid_argument("Too many variables (" + to_string(used_variables.size()) +
+                           "), at most " + to_string(MAX_VARIABLES) + " are supported");
+  }
 
-  set<char> found; // Set to avoid duplicate entries
+  // 2^n rows; computed as a mask so n = 64 does not overflow
+  const size_t n = used_variables.size();
+  last_row = (n == 64) ? ~0ull : (1ull << n) - 1;
+}
 
-  for (const string& part : parts) {
-    if (part == "A" || part == "B" || part == "C") {
-      found.insert(part[0]); // 'A' / 'B' / 'C'
+/**
+ * @brief Sorted, duplicate-free variable names of several expressions, so
+ * that they can be compared over one shared row order.
+ */
+vector<string> Truth_Table::collectVariables(const vector<const Boolean_Expression*>& expressions) {
+  set<string> found; // Sorted, duplicate-free names
+
+  for (const Boolean_Expression* expression : expressions) {
+    for (string_view name : expression->getVariableNames()) {
+      found.emplace(name);
     }
   }
 
-  // Copy into vector in sorted order (A → C)
-  used_variables.assign(found.begin(), found.end());
+  // Copy into vector in sorted order
+  return vector<string>(found.begin(), found.end());
+}
 
+const vector<string>& Truth_Table::getVariables() const {
+  return used_variables;
 }
 
+const Compiled_Program& Truth_Table::getProgram() const {
+  return *program;
+}
 
+uint64_t Truth_Table::getLastRow() const {
+  return last_row;
+}
 
 /**
- * @brief Step 2 — Generate all input combinations for detected variables.
+ * @brief Step 2 — Decode the inputs of one row from its index.
  *  - If n variables are used, there are 2^n rows.
  *  - We map bits of the row index i onto variables left→right (MSB→LSB).
  *    Example (A,B,C): i=5 (101b) → A=1, B=0, C=1.
+ *  - Nothing is precomputed, so memory stays constant as n grows.
  */
-void Truth_Table::generateCombinations() {
-  input_combinations.clear();
-  const int n = used_variables.size();
-  const int total = 1 << n; // 2^n combinations
-
-  for (int i = 0; i < total; ++i) {
-    map<char, bool> row;
-
-    // Fill left→right: j=0 reads MSB, j=n-1 reads LSB
-    for (int j = 0; j < n; ++j) {
-      const bool value = (i >> (n - j - 1)) & 1;
-      row[used_variables[j]] = value;
-    }
+void Truth_Table::decodeRow(uint64_t row, bool* values) const {
+  const size_t n = used_variables.size();
+
+  // Fill left→right: j=0 reads MSB, j=n-1 reads LSB
+  for (size_t j = 0; j < n; ++j) {
+    values[j] = (row >> (n - j - 1)) & 1;
+  }
+}
+
+/**
+ * @brief Evaluate rows [first, last] and append them to `out` in the
+ * writer's format. `first` must be a multiple of the evaluator's block size;
+ * `block` is the caller's scratch buffer (one per thread).
+ */
+void Truth_Table::formatRows(const Bitslice_Evaluator& evaluator, const Table_Writer& writer,
+                             uint64_t first, uint64_t last, vector<uint64_t>& block, string& out) const {
+  const uint64_t block_rows = evaluator.getBlockRows();
+  Run_Stats::Scope scope(Run_Stats::Phase::FORMAT_ROWS);   // the whole chunk, not each block
+  Run_Stats::add(Run_Stats::Counter::BLOCKS, (last - first) / block_rows + 1);
+
+  // Rows are printed in order, so blocks are too; after the first block
+  // only the cones of the variables that changed are re-evaluated.
+  // Blocks are walked with an inclusive end so 2^64 rows cannot overflow
+  for (uint64_t block_first = first; ; block_first += block_rows) {
+    if (block_first == first)
+      evaluator.evaluateBlock(block_first, block.data());
+    else
+      evaluator.updateBlock(block_first - block_rows, block_first, block.data());
+
+    const uint64_t block_last = min(last, block_first + (block_rows - 1));
+    writer.appendRows(block.data(), evaluator.getBlockWords(), 0, block_last - block_first, out);
 
-    input_combinations.push_back(row);
+    if (block_last == last)
+      break;
   }
 }
 
 /**
  * @brief Step 3 — Print the truth table.
  * Columns:
- *   - One column per variable (A/B/C)
- *   - One column per intermediate step (labels from evaluateWithSteps())
+ *   - One column per variable
+ *   - One column per intermediate step (labels from the compiled program)
+ * Values are computed block-wise by the bit-sliced evaluator, so each gate
+ * costs one bitwise instruction per 64–512 rows instead of one per row.
+ * Table_Writer turns each chunk of rows into one buffer in the requested
+ * format (text, CSV, JSON Lines, Markdown), written with a single call.
+ *
+ * Rows are split into chunks of ROWS_PER_CHUNK. With threads != 1 the chunks
+ * are evaluated and formatted on a worker pool and written in row order
+ * (threads == 0 sizes the pool to the hardware).
  */
-void Truth_Table::displayTable() {
-
-  vector<string> postfixForm = expression.convertToPostfix();
-
-  // Header: variable names
-  for (char var : used_variables)
-    cout << "|" << left << setw(5) << var;
-  cout << "|";
-
-  // Header: step labels (use the first row just to get the label names)
-  auto testSteps = expression.evaluateWithSteps(postfixForm, input_combinations[0]).first;
-  for (const auto& step : testSteps) {
-    cout << left << setw(20) << step.first << "|";
-  }
-  cout << endl;
-
-  // Separator row (simple fixed widths matching above)
-  for (int i = 0; i < used_variables.size(); ++i)
-    cout << "|-----";
-  cout << "|";
-  for (int i = 0; i < testSteps.size(); ++i)
-    cout << "--------------------|";
-  cout << endl;
-
-  // Body: one row per input assignment
-  for (const auto& values : input_combinations) {
-    // Print A/B/C values
-    for (char var : used_variables)
-      cout << "|" << left << setw(5) << values.at(var);
-    cout << "|";
-
-    // Evaluate all steps for this row and print boolean results
-    auto resultPair = expression.evaluateWithSteps(postfixForm, values);
-    for (const auto& step : resultPair.first) {
-      cout << left << setw(20) << step.second << "|";
+void Truth_Table::displayTable(const Table_Options& options) {
+
+  // Header, separator and row templates are built once here
+  Table_Writer output(options.format, used_variables, program->getStepLabels());
+  if (options.sink)
+    output.open(options.sink);
+  else
+    output.open(options.output_path);
+  cout.flush(); // keep console text ahead of table rows on stdout
+  output.writeHeader();
+
+  // Evaluate a whole block of rows per pass: every variable and every step
+  // is a bit vector, one bit per row (see Bitslice_Evaluator)
+  Bitslice_Evaluator evaluator(*program);
+
+  // One scratch block per worker; chunks are whole blocks, so every chunk
+  // starts on a block boundary
+  Ordered_Chunk_Writer writer(options.threads, CHUNK_WINDOW);
+  vector<vector<uint64_t>> blocks(writer.getThreadCount(),
+                                  vector<uint64_t>(evaluator.getBufferWords()));
+  const uint64_t chunk_count = last_row / ROWS_PER_CHUNK + 1;
+
+  writer.run(chunk_count,
+    [&](unsigned worker, uint64_t chunk, string& out) {
+      const uint64_t first = chunk * ROWS_PER_CHUNK;
+      const uint64_t last = min(last_row, first + (ROWS_PER_CHUNK - 1));
+      formatRows(evaluator, output, first, last, blocks[worker], out);
+    },
+    [&](const string& data) {
+      Run_Stats::Scope scope(Run_Stats::Phase::OUTPUT);
+      output.write(data);
+      Run_Stats::add(Run_Stats::Counter::OUTPUT_BYTES, data.size());
+    });
+  output.flush();
+  Run_Stats::add(Run_Stats::Counter::ROWS, last_row + 1);
+}
+
+/**
+ * @brief Evaluate every row block by block and popcount the result vector.
+ * Nothing but one evaluator block is kept in memory. The order does not
+ * matter for a count, so blocks are visited in Gray-code order and each
+ * re-evaluates only the cone of the one variable that changed.
+ */
+uint64_t Truth_Table::countTrue() const {
+  if (used_variables.size() >= MAX_VARIABLES) {
+    throw length_error("Counting needs fewer than " + to_string(MAX_VARIABLES) + " variables");
+  }
+  if (cached && cached->counted) {
+    return cached->true_rows;
+  }
+
+  Bitslice_Evaluator evaluator(*program);
+  const size_t words = evaluator.getBlockWords();
+  vector<uint64_t> block(evaluator.getBufferWords());
+  const uint64_t* result = block.data() + program->getResultIndex() * words;
+  const uint64_t total_words = last_row / 64 + 1;
+  const uint64_t block_count = (total_words + words - 1) / words;
+  uint64_t count = 0;
+
+  evaluator.forEachBlock(0, block_count, block.data(), [&](uint64_t index, const uint64_t*) {
+    const uint64_t word = index * words;
+    const uint64_t used = min<uint64_t>(words, total_words - word);
+    for (uint64_t w = 0; w < used; ++w) {
+      uint64_t bits = result[w];
+      // Only the rows up to last_row count
+      if (word + w == total_words - 1 && last_row % 64 != 63)
+        bits &= (1ull << (last_row % 64 + 1)) - 1;
+      count += popcount64(bits);
     }
-    cout << endl;
+  });
+  Run_Stats::add(Run_Stats::Counter::ROWS, last_row + 1);
+
+  if (cache) {
+    Expression_Cache::Entry entry = *cached;
+    entry.true_rows = count;
+    entry.counted = true;
+    cached = cache->insert(cache_key, move(entry));
+  }
+  return count;
+}
+
+Table_Rows Truth_Table::rows() const {
+  return Table_Rows(*this);
+}
+
+Filtered_Rows Truth_Table::rows(const Row_Filter& filter) const {
+  return Filtered_Rows(*this, filter);
+}
+
+/**
+ * @brief Evaluate every row and keep only the result bit of each.
+ * Blocks are evaluated in Gray-code order (see countTrue()) and each
+ * block's words are copied to their place in row order.
+ */
+vector<uint64_t> Truth_Table::resultBits() const {
+  if (used_variables.size() > MAX_BITSET_VARIABLES) {
+    throw length_error("Result bitset needs at most " + to_string(MAX_BITSET_VARIABLES) + " variables");
+  }
+  if (cached && cached->result_bits) {
+    return *cached->result_bits;
+  }
+
+  Bitslice_Evaluator evaluator(*program);
+  const size_t words = evaluator.getBlockWords();
+  const size_t result = program->getResultIndex();
+  vector<uint64_t> block(evaluator.getBufferWords());
+  vector<uint64_t> bits(last_row / 64 + 1);
+  const uint64_t block_count = (bits.size() + words - 1) / words;
+
+  evaluator.forEachBlock(0, block_count, block.data(), [&](uint64_t index, const uint64_t*) {
+    const uint64_t word = index * words;
+    const uint64_t count = min<uint64_t>(words, bits.size() - word);
+    copy(block.begin() + result * words, block.begin() + result * words + count, bits.begin() + word);
+  });
+
+  // Clear the bits past the last row
+  if (last_row % 64 != 63)
+    bits.back() &= (1ull << (last_row % 64 + 1)) - 1;
+  Run_Stats::add(Run_Stats::Counter::ROWS, last_row + 1);
+
+  // Only a bitset the cache would keep is copied into it
+  if (cache && bits.size() * sizeof(uint64_t) <= cache->getMaxBytes() / 4) {
+    Expression_Cache::Entry entry = *cached;
+    entry.result_bits = make_shared<const vector<uint64_t>>(bits);
+    cached = cache->insert(cache_key, move(entry));
   }
+  return bits;
 }
 
+/**
+ * @brief Save the table as a packed bitset file (see Table_File).
+ * Only the result column is stored unless include_steps is set. Rows are
+ * evaluated in chunks of BINARY_ROWS_PER_CHUNK; each chunk's words are
+ * written straight to their place in every column.
+ */
+void Truth_Table::saveBinary(const string& path, bool include_steps, unsigned threads) {
+  const vector<string>& step_labels = program->getStepLabels();
+  const size_t variable_count = used_variables.size();
+
+  // Saved columns, as evaluator buffer columns (variables first, then steps);
+  // the result is the last step, or the lone variable of an expression
+  // without operators
+  vector<size_t> saved;
+  vector<string> saved_labels;
+  const size_t first_saved = (include_steps || step_labels.empty()) ? 0 : step_labels.size() - 1;
+  for (size_t step = first_saved; step < step_labels.size(); ++step) {
+    saved.push_back(variable_count + step);
+  }
+  if (step_labels.empty()) {
+    saved.push_back(program->getResultIndex());
+  }
+  // The file records the whole expression: labels are written unshortened
+  for (size_t column : saved) {
+    saved_labels.push_back(program->fullLabel(static_cast<uint32_t>(column)));
+  }
+
+  // Metadata: variables, column labels, canonical (fully parenthesised) expression
+  string metadata;
+  auto addString = [&metadata](const string& text) {
+    const uint32_t length = static_cast<uint32_t>(text.size());
+    metadata.append(reinterpret_cast<const char*>(&length), sizeof(length));
+    metadata += text;
+  };
+  for (const string& var : used_variables)
+    addString(var);
+  for (const string& label : saved_labels)
+    addString(label);
+  addString(program->fullLabel(program->getResultIndex()));
+
+  Table_File_Header header = {};
+  memcpy(header.magic, "TTBL", 4);
+  header.version = TABLE_FILE_VERSION;
+  header.variable_count = static_cast<uint32_t>(variable_count);
+  header.column_count = static_cast<uint32_t>(saved.size());
+  header.last_row = last_row;
+  header.words_per_column = last_row / 64 + 1;
+  header.metadata_size = metadata.size();
+  header.data_offset = (sizeof(header) + metadata.size() + 63) / 64 * 64;
 
+  ofstream file(path, ios::binary | ios::trunc);
+  if (!file) {
+    throw runtime_error("Cannot open output file " + path);
+  }
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file.write(metadata.data(), metadata.size());
+  file.write(string(header.data_offset - sizeof(header) - metadata.size(), '\0').data(),
+             header.data_offset - sizeof(header) - metadata.size());
+
+  Bitslice_Evaluator evaluator(*program);
+  const size_t words = evaluator.getBlockWords();
+  Ordered_Chunk_Writer writer(threads, CHUNK_WINDOW);
+  vector<vector<uint64_t>> blocks(writer.getThreadCount(),
+                                  vector<uint64_t>(evaluator.getBufferWords()));
+  const uint64_t chunk_words = BINARY_ROWS_PER_CHUNK / 64;
+  const uint64_t chunk_count = last_row / BINARY_ROWS_PER_CHUNK + 1;
+
+  // Words of a chunk (the last chunk may be short)
+  auto wordsInChunk = [&](uint64_t chunk) {
+    return min(chunk_words, header.words_per_column - chunk * chunk_words);
+  };
+
+  uint64_t written = 0; // chunks already written, in order
+  writer.run(chunk_count,
+    [&](unsigned worker, uint64_t chunk, string& out) {
+      // out holds this chunk's words for every saved column, column by column
+      const uint64_t chunk_size = wordsInChunk(chunk);
+      out.assign(saved.size() * chunk_size * sizeof(uint64_t), '\0');
+      uint64_t* packed = reinterpret_cast<uint64_t*>(&out[0]);
+      vector<uint64_t>& block = blocks[worker];
+
+      // Blocks of a whole chunk are visited in Gray-code order; each one's
+      // words still go to their place in row order
+      const uint64_t first_block = chunk * (chunk_words / words);
+      const uint64_t block_count = (chunk_size + words - 1) / words;
+      evaluator.forEachBlock(first_block, block_count, block.data(), [&](uint64_t index, const uint64_t* values) {
+        const uint64_t word = (index - first_block) * words;
+        const uint64_t count = min<uint64_t>(words, chunk_size - word);
+        for (size_t column = 0; column < saved.size(); ++column) {
+          memcpy(packed + column * chunk_size + word, values + saved[column] * words, count * sizeof(uint64_t));
+        }
+      });
+
+      // Clear the bits past the last row so popcounts stay exact
+      if (chunk + 1 == chunk_count && (last_row % 64) != 63) {
+        const uint64_t mask = (1ull << (last_row % 64 + 1)) - 1;
+        for (size_t column = 0; column < saved.size(); ++column)
+          packed[column * chunk_size + chunk_size - 1] &= mask;
+      }
+    },
+    [&](const string& data) {
+      Run_Stats::Scope scope(Run_Stats::Phase::OUTPUT);
+      const uint64_t chunk = written++;
+      const uint64_t chunk_size = wordsInChunk(chunk);
+      for (size_t column = 0; column < saved.size(); ++column) {
+        const uint64_t word = column * header.words_per_column + chunk * chunk_words;
+        file.seekp(static_cast<streamoff>(header.data_offset + word * sizeof(uint64_t)));
+        file.write(data.data() + column * chunk_size * sizeof(uint64_t),
+                   static_cast<streamsize>(chunk_size * sizeof(uint64_t)));
+      }
+      Run_Stats::add(Run_Stats::Counter::OUTPUT_BYTES, data.size());
+    });
+
+  Run_Stats::add(Run_Stats::Counter::ROWS, last_row + 1);
+  if (!file.flush()) {
+    throw runtime_error("Failed writing table file " + path);
+  }
+}
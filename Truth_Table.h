@@ -3,34 +3,103 @@
  * @brief Generates and displays a truth table for a given Boolean_Expression.
  *
  * Automatically:
- *  - Detects which variables (A, B, C) appear in the expression
- *  - Generates all possible True/False combinations (2^n)
+ *  - Detects which variables (any identifier, up to 64) appear in the expression
+ *  - Streams all possible True/False combinations (2^n), decoding each row
+ *    from its index instead of storing the rows
  *  - Evaluates each combination and prints the results in tabular form
+ *
+ * With an Expression_Cache, a table whose expression has been seen before
+ * (in any spelling with the same canonical form) reuses its true-row count
+ * and result bitset. The compiled program, whose steps and labels follow
+ * the spelling, is reused only for the same tokens; "B AND A" after
+ * "A AND B" compiles its own and shows its own step columns.
  */
 
 #ifndef TRUTH_TABLE_H
 #define TRUTH_TABLE_H
 
 #include "Boolean_Expression.h"
+#include "Bitslice_Evaluator.h"
+#include "Expression_Cache.h"
+#include "Table_Rows.h"
+#include "Table_Writer.h"
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
-#include <map>
 using namespace std;
 
+// How displayTable() renders the table
+struct Table_Options {
+  unsigned threads = 1;                                  // 0 = one worker per hardware thread
+  Table_Writer::Format format = Table_Writer::Format::TEXT;
+  string output_path;                                    // empty = stdout
+  Table_Writer::Sink sink;                               // when set, receives the output instead
+};
 
 class Truth_Table {
   private:
     Boolean_Expression& expression;
-    vector<char> used_variables;
-    vector<map<char, bool>> input_combinations;
+    vector<string> used_variables;
+    uint64_t last_row = 0;      // index of the final row (2^n - 1)
+    shared_ptr<const Compiled_Program> program;   // opcodes and step labels, built once; evaluated per row
+    Expression_Cache* cache = nullptr;
+    string cache_key;                             // canonical form, prefixed by the compile mode
+    mutable shared_ptr<const Expression_Cache::Entry> cached;   // this table's entry, replaced as results are added
 
     void detectVariables();
-    void generateCombinations();
+    void formatRows(const Bitslice_Evaluator& evaluator, const Table_Writer& writer,
+                    uint64_t first, uint64_t last, vector<uint64_t>& block, string& out) const;
 
   public:
-    explicit Truth_Table(Boolean_Expression& expression);
+    // Row indices are 64-bit, so at most 64 variables can be enumerated
+    static constexpr size_t MAX_VARIABLES = 64;
+
+    // Rows per output chunk (a multiple of every evaluator block size)
+    static constexpr uint64_t ROWS_PER_CHUNK = 1 << 14;
+
+    // Chunks that may be in flight at once when printing in parallel
+    static constexpr size_t CHUNK_WINDOW = 64;
+
+    // Rows per chunk when saving a binary table file (128 KiB per column)
+    static constexpr uint64_t BINARY_ROWS_PER_CHUNK = 1 << 20;
+
+    // With simplify, the rows evaluate (and the step columns show) the
+    // simplified expression; the result column is the same either way.
+    // With a cache, the program and later results are looked up and stored
+    // there (the cache must outlive the table).
+    explicit Truth_Table(Boolean_Expression& expression, bool simplify = false, Expression_Cache* cache = nullptr);
+
+    const vector<string>& getVariables() const;
+    const Compiled_Program& getProgram() const;
+
+    // Variables of all the expressions in table order (sorted by name)
+    static vector<string> collectVariables(const vector<const Boolean_Expression*>& expressions);
+    uint64_t getLastRow() const;
+
+    // Decode a row index into one value per variable (MSB = first variable)
+    void decodeRow(uint64_t row, bool* values) const;
+
+    // Display the truth table in the chosen format; threads != 1 evaluates
+    // chunks in parallel
+    void displayTable(const Table_Options& options = Table_Options());
+
+    // Number of rows where the expression is true (fewer than 64 variables)
+    uint64_t countTrue() const;
+
+    // Rows evaluated on demand, all or only those a filter accepts (fewer
+    // than 64 variables; the table must outlive the range)
+    Table_Rows rows() const;
+    Filtered_Rows rows(const Row_Filter& filter) const;
+
+    // Result column as a bitset: bit r % 64 of word r / 64 is row r
+    // (at most MAX_BITSET_VARIABLES variables)
+    vector<uint64_t> resultBits() const;
+    static constexpr size_t MAX_BITSET_VARIABLES = 32;
 
-    void displayTable(); // Display the truth table
+    // Save the result (and optionally every step column) as a packed
+    // binary file readable with Table_File
+    void saveBinary(const string& path, bool include_steps = false, unsigned threads = 1);
 };
 
 #endif //TRUTH_TABLE_H
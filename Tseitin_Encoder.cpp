@@ -0,0 +1,175 @@
+/**
+ * @file Tseitin_Encoder.cpp
+ * @brief Gate clauses for each operator and DIMACS output.
+ *
+ * Gate clauses for x <-> (a op b):
+ *   AND : (¬x ∨ a) (¬x ∨ b) (x ∨ ¬a ∨ ¬b)
+ *   OR  : (x ∨ ¬a) (x ∨ ¬b) (¬x ∨ a ∨ b)
+ *   XOR : (¬x ∨ a ∨ b) (¬x ∨ ¬a ∨ ¬b) (x ∨ ¬a ∨ b) (x ∨ a ∨ ¬b)
+ * TRUE and FALSE share one gate variable asserted by the unit clause (x).
+ */
+
+#include "Tseitin_Encoder.h"
+#include "SAT_Solver.h"
+
+using namespace std;
+
+// Append one clause of two or three literals
+void Tseitin_Encoder::addClause(int a, int b, int c) {
+  clause_literals.push_back(a);
+  clause_literals.push_back(b);
+  if (c != 0) {
+    clause_literals.push_back(c);
+  }
+  clause_literals.push_back(0);
+  ++clause_count;
+}
+
+/**
+ * @brief Encode the nodes that root depends on, in id (topological) order.
+ * literal[node] is the CNF literal equal to that node's value.
+ */
+Tseitin_Encoder::Tseitin_Encoder(const Expression_DAG& dag, Expression_DAG::Node_Id root, bool value)
+  : variables(dag.getVariables()) {
+  const size_t n = variables.size();
+  variable_count = static_cast<uint32_t>(n);
+
+  // Only the nodes root depends on (a DAG can hold several expressions)
+  vector<bool> needed(root + 1, false);
+  needed[root] = true;
+  for (Expression_DAG::Node_Id id = root + 1; id-- > n;) {
+    if (needed[id]) {
+      const Expression_DAG::Node& node = dag.getNode(id);
+      const unsigned operands = Expression_DAG::operandCount(node.op);
+      if (operands >= 1) {
+        needed[node.a] = true;
+      }
+      if (operands == 2) {
+        needed[node.b] = true;
+      }
+    }
+  }
+
+  vector<int> literal(root + 1, 0);
+  int true_literal = 0;
+  for (Expression_DAG::Node_Id id = 0; id <= root; ++id) {
+    if (!needed[id]) {
+      continue;
+    }
+    const Expression_DAG::Node& node = dag.getNode(id);
+    if (node.op == Opcode::VAR) {
+      literal[id] = static_cast<int>(node.a) + 1;
+      continue;
+    }
+    if (node.op == Opcode::NOT) {
+      literal[id] = -literal[node.a];
+      continue;
+    }
+    if (node.op == Opcode::CONST_TRUE || node.op == Opcode::CONST_FALSE) {
+      // One gate variable forced true by a unit clause serves both constants
+      if (true_literal == 0) {
+        true_literal = static_cast<int>(++variable_count);
+        clause_literals.push_back(true_literal);
+        clause_literals.push_back(0);
+        ++clause_count;
+      }
+      literal[id] = node.op == Opcode::CONST_TRUE ? true_literal : -true_literal;
+      continue;
+    }
+
+    const int a = literal[node.a];
+    const int b = literal[node.b];
+    const int x = static_cast<int>(++variable_count);
+
+    switch (node.op) {
+      case Opcode::AND:
+      case Opcode::NAND:
+        addClause(-x, a);
+        addClause(-x, b);
+        addClause(x, -a, -b);
+        literal[id] = node.op == Opcode::AND ? x : -x;
+        break;
+      case Opcode::OR:
+      case Opcode::NOR:
+        addClause(x, -a);
+        addClause(x, -b);
+        addClause(-x, a, b);
+        literal[id] = node.op == Opcode::OR ? x : -x;
+        break;
+      case Opcode::XOR:
+        addClause(-x, a, b);
+        addClause(-x, -a, -b);
+        addClause(x, -a, b);
+        addClause(x, a, -b);
+        literal[id] = x;
+        break;
+      default:
+        break;
+    }
+  }
+
+  // Assert the root
+  clause_literals.push_back(value ? literal[root] : -literal[root]);
+  clause_literals.push_back(0);
+  ++clause_count;
+}
+
+void Tseitin_Encoder::addTo(SAT_Solver& solver) const {
+  while (solver.getVariableCount() < variable_count) {
+    solver.newVariable();
+  }
+  vector<int> clause;
+  for (int lit : clause_literals) {
+    if (lit == 0) {
+      solver.addClause(clause);
+      clause.clear();
+    }
+    else {
+      clause.push_back(lit);
+    }
+  }
+}
+
+/**
+ * @brief Write the formula in DIMACS CNF format.
+ * Example:
+ *   c x1 = A
+ *   c x2 = B
+ *   p cnf 3 4
+ *   -3 1 0
+ *   ...
+ */
+void Tseitin_Encoder::writeDimacs(ostream& out) const {
+  out << "c Tseitin encoding; variables " << variables.size() + 1 << ".." << variable_count
+      << " are gates\n";
+  for (size_t i = 0; i < variables.size(); ++i) {
+    out << "c x" << i + 1 << " = " << variables[i] << "\n";
+  }
+  out << "p cnf " << variable_count << " " << clause_count << "\n";
+
+  string line;
+  for (int lit : clause_literals) {
+    line += to_string(lit);
+    if (lit == 0) {
+      line += '\n';
+      out << line;
+      line.clear();
+    }
+    else {
+      line += ' ';
+    }
+  }
+  out.flush();
+}
+
+uint32_t Tseitin_Encoder::getVariableCount() const {
+  return variable_count;
+}
+
+size_t Tseitin_Encoder::getClauseCount() const {
+  return clause_count;
+}
+
+const vector<string>& Tseitin_Encoder::getVariables() const {
+  return variables;
+}
@@ -0,0 +1,56 @@
+/**
+ * @class Tseitin_Encoder
+ * @brief Turns an expression graph into an equisatisfiable CNF formula.
+ *
+ * Every AND/OR/XOR node gets a fresh CNF variable x with clauses stating
+ * x <-> (a op b); NAND and NOR reuse the AND/OR clauses with x negated,
+ * and NOT is just a negated literal, so it costs nothing. Shared
+ * subexpressions (Expression_DAG) are encoded once. A final unit clause
+ * asserts the value asked for at the root.
+ *
+ * CNF variables 1 .. n are the expression's variables in
+ * dag.getVariables() order; gate variables follow.
+ *
+ * Example: A AND NOT B  →  x3 <-> (x1 AND ¬x2), assert x3
+ *   (¬x3 ∨ x1) (¬x3 ∨ ¬x2) (x3 ∨ ¬x1 ∨ x2) (x3)
+ */
+
+#ifndef TSEITIN_ENCODER_H
+#define TSEITIN_ENCODER_H
+
+#include "Expression_DAG.h"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class SAT_Solver;
+
+class Tseitin_Encoder {
+  private:
+    vector<string> variables;      // CNF variable i + 1 is variables[i]
+    uint32_t variable_count = 0;   // inputs + gates
+    vector<int> clause_literals;   // clauses back to back, each ended by 0 (as in DIMACS)
+    size_t clause_count = 0;
+
+    void addClause(int a, int b, int c = 0);
+
+  public:
+    // Encode the subexpression at root and assert that it equals value
+    Tseitin_Encoder(const Expression_DAG& dag, Expression_DAG::Node_Id root, bool value = true);
+
+    // Load every clause into a solver (variables are numbered as above)
+    void addTo(SAT_Solver& solver) const;
+
+    // DIMACS CNF, with comment lines naming the input variables
+    void writeDimacs(ostream& out) const;
+
+    uint32_t getVariableCount() const;
+    size_t getClauseCount() const;
+    const vector<string>& getVariables() const;
+};
+
+#endif //TSEITIN_ENCODER_H
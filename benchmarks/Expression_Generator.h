@@ -0,0 +1,104 @@
+/**
+ * @class Expression_Generator
+ * @brief Seeded random Boolean expressions for the benchmarks.
+ *
+ * Expressions are random trees over the variables x0 .. x{n-1}:
+ *  - depth limits the nesting; a subtree below the root stops early with
+ *    probability leaf_probability
+ *  - binary operators are drawn with the weights of the operator mix
+ *  - each subtree is negated with probability not_probability
+ *
+ * The same seed and settings always give the same expressions.
+ */
+
+#ifndef EXPRESSION_GENERATOR_H
+#define EXPRESSION_GENERATOR_H
+
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class Expression_Generator {
+  public:
+    struct Settings {
+      size_t variables = 12;
+      size_t depth = 8;
+      double leaf_probability = 0.15;
+      double not_probability = 0.2;
+      // Relative weights of AND, OR, XOR, NAND, NOR
+      vector<double> operator_mix = {3, 3, 1, 1, 1};
+      uint64_t seed = 1;
+    };
+
+  private:
+    Settings settings;
+    mt19937_64 rng;
+    discrete_distribution<size_t> pick_operator;
+    uniform_real_distribution<double> chance;
+
+    void append(string& text, size_t depth) {
+      const bool root = depth == settings.depth;
+      if (depth == 0 || (!root && chance(rng) < settings.leaf_probability)) {
+        text += "x" + to_string(rng() % settings.variables);
+        return;
+      }
+      if (chance(rng) < settings.not_probability) {
+        text += "NOT ";
+      }
+
+      static const char* const names[] = {" AND ", " OR ", " XOR ", " NAND ", " NOR "};
+      text += '(';
+      append(text, depth - 1);
+      text += names[pick_operator(rng)];
+      append(text, depth - 1);
+      text += ')';
+    }
+
+  public:
+    explicit Expression_Generator(const Settings& settings)
+        : settings(settings), rng(settings.seed),
+          pick_operator(settings.operator_mix.begin(), settings.operator_mix.end()),
+          chance(0.0, 1.0) {
+      if (settings.variables == 0 || settings.operator_mix.size() != 5) {
+        throw invalid_argument("Generator needs at least one variable and five operator weights");
+      }
+    }
+
+    // Next random expression
+    string next() {
+      string text;
+      append(text, settings.depth);
+      return text;
+    }
+
+    // Parse "AND:3,OR:3,XOR:1,NAND:1,NOR:1" (missing operators get weight 0)
+    static vector<double> parseMix(const string& text) {
+      static const char* const names[] = {"AND", "OR", "XOR", "NAND", "NOR"};
+      vector<double> mix(5, 0.0);
+      size_t start = 0;
+      while (start < text.size()) {
+        size_t end = text.find(',', start);
+        if (end == string::npos) end = text.size();
+        const string item = text.substr(start, end - start);
+        const size_t colon = item.find(':');
+        if (colon == string::npos) {
+          throw invalid_argument("Operator mix entries look like AND:3");
+        }
+        const string name = item.substr(0, colon);
+        size_t index = 0;
+        while (index < 5 && name != names[index]) ++index;
+        if (index == 5) {
+          throw invalid_argument("Unknown operator in mix: " + name);
+        }
+        mix[index] = stod(item.substr(colon + 1));
+        start = end + 1;
+      }
+      return mix;
+    }
+};
+
+#endif //EXPRESSION_GENERATOR_H
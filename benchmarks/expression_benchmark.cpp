@@ -0,0 +1,317 @@
+/**
+ * @file expression_benchmark.cpp
+ * @brief Times each stage of the simulator on seeded random expressions and
+ *        prints the results as JSON.
+ *
+ * Stages: parse (construct + postfixTokens, on the heap and in an
+ * Expression_Arena released every ARENA_BATCH expressions),
+ * splitExpression, convertToPostfix, compile (as parsed and after
+ * Expression_Simplifier), evaluateWithSteps (one row per op) and
+ * Truth_Table::countTrue (whole table per op, as parsed and simplified,
+ * and with native code from Jit_Kernel, its generation included),
+ * Truth_Table::rows (the first true row through a filtered view, and a
+ * full walk of Table_Rows), CIRCUIT_OUTPUTS related rules (one shared
+ * term XOR a rule of their own) counted as separate tables vs. as the
+ * outputs of one Logic_Circuit,
+ * a batch line's work (Truth_Table + countTrue from a fresh parse) without
+ * and with an Expression_Cache, where every expression repeats,
+ * Equivalence_Checker::check (each expression against its simplified
+ * text, which is always equivalent: the worst case) and displayTable
+ * (whole table per op, written to the null device). For each stage it reports ns/op, rows/s
+ * (where rows are evaluated) and heap allocations/bytes per op, counted
+ * by Allocation_Tracker.
+ *
+ * Build (from the repository root, linking every source except main.cpp):
+ *   g++ -std=c++17 -O2 -I. -Ibenchmarks benchmarks/expression_benchmark.cpp \
+ *       $(ls *.cpp | grep -v '^main.cpp$') -pthread -o expression_benchmark
+ *
+ * Usage: expression_benchmark [--vars N] [--depth D] [--mix AND:3,OR:3,XOR:1,NAND:1,NOR:1]
+ *                             [--not P] [--seed S] [--pool K] [--min-time SECONDS]
+ */
+
+#include "Allocation_Tracker.h"
+#include "Bitslice_Evaluator.h"
+#include "Boolean_Expression.h"
+#include "Equivalence_Checker.h"
+#include "Expression_Arena.h"
+#include "Expression_Cache.h"
+#include "Expression_Generator.h"
+#include "Logic_Circuit.h"
+#include "Truth_Table.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+#ifdef _WIN32
+static const char* const NULL_DEVICE = "NUL";
+#else
+static const char* const NULL_DEVICE = "/dev/null";
+#endif
+
+static const uint64_t ARENA_BATCH = 256;   // expressions per arena release
+static const size_t CIRCUIT_OUTPUTS = 8;    // outputs per Logic_Circuit
+
+struct Measurement {
+  string name;
+  uint64_t iterations = 0;
+  double ns_per_op = 0;
+  double rows_per_second = 0;   // 0 when the stage evaluates no rows
+  double allocations_per_op = 0;
+  double bytes_per_op = 0;
+};
+
+/**
+ * @brief Run op(i) in doubling batches until min_seconds have passed.
+ * rows_per_op(i) is the number of rows evaluated by call i (may be 0).
+ */
+template <typename Op, typename Rows>
+static Measurement measure(const string& name, double min_seconds, Op op, Rows rows_per_op) {
+  op(0); // warm-up (first-touch allocations, caches)
+
+  Measurement result;
+  result.name = name;
+  uint64_t batch = 1;
+  double rows = 0;
+  double seconds = 0;
+  const uint64_t count_before = Allocation_Tracker::getCount();
+  const uint64_t bytes_before = Allocation_Tracker::getBytes();
+
+  while (seconds < min_seconds) {
+    const auto start = chrono::steady_clock::now();
+    for (uint64_t i = 0; i < batch; ++i) {
+      op(result.iterations + i);
+    }
+    seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    for (uint64_t i = 0; i < batch; ++i) {
+      rows += rows_per_op(result.iterations + i);
+    }
+    result.iterations += batch;
+    batch *= 2;
+  }
+
+  result.ns_per_op = seconds * 1e9 / result.iterations;
+  result.rows_per_second = rows / seconds;
+  result.allocations_per_op = double(Allocation_Tracker::getCount() - count_before) / result.iterations;
+  result.bytes_per_op = double(Allocation_Tracker::getBytes() - bytes_before) / result.iterations;
+  return result;
+}
+
+// Escape a string for a JSON value
+static string jsonString(const string& text) {
+  string out = "\"";
+  for (char ch : text) {
+    if (ch == '"' || ch == '\\') out += '\\';
+    out += ch;
+  }
+  return out + "\"";
+}
+
+int main(int argc, char* argv[]) {
+  Expression_Generator::Settings settings;
+  size_t pool_size = 64;
+  double min_seconds = 0.5;
+
+  try {
+    for (int i = 1; i + 1 < argc; i += 2) {
+      const string arg = argv[i];
+      const string value = argv[i + 1];
+      if (arg == "--vars") settings.variables = stoul(value);
+      else if (arg == "--depth") settings.depth = stoul(value);
+      else if (arg == "--mix") settings.operator_mix = Expression_Generator::parseMix(value);
+      else if (arg == "--not") settings.not_probability = stod(value);
+      else if (arg == "--seed") settings.seed = stoull(value);
+      else if (arg == "--pool") pool_size = max<size_t>(1, stoul(value));
+      else if (arg == "--min-time") min_seconds = stod(value);
+      else throw invalid_argument("Unknown option " + arg);
+    }
+  }
+  catch (const exception& error) {
+    fprintf(stderr, "%s\n", error.what());
+    return 2;
+  }
+
+  Allocation_Tracker::enable();
+
+  // Pool of expressions, and everything each stage needs prepared up front
+  Expression_Generator generator(settings);
+  vector<string> texts;
+  vector<unique_ptr<Boolean_Expression>> expressions;
+  vector<vector<string>> postfixes;
+  vector<vector<string>> variables;
+  vector<map<string, bool>> inputs;
+  vector<unique_ptr<Truth_Table>> tables;
+  vector<unique_ptr<Truth_Table>> simplified_tables;
+  vector<unique_ptr<Boolean_Expression>> simplified_expressions;
+
+  for (size_t i = 0; i < pool_size; ++i) {
+    texts.push_back(generator.next());
+    expressions.push_back(make_unique<Boolean_Expression>(texts.back()));
+    postfixes.push_back(expressions.back()->convertToPostfix());
+    tables.push_back(make_unique<Truth_Table>(*expressions.back()));
+    simplified_tables.push_back(make_unique<Truth_Table>(*expressions.back(), true));
+    simplified_expressions.push_back(make_unique<Boolean_Expression>(expressions.back()->getSimplifiedExpression()));
+    variables.push_back(tables.back()->getVariables());
+    map<string, bool> row;
+    for (const string& name : variables.back()) row[name] = false;
+    inputs.push_back(row);
+  }
+
+  auto noRows = [](uint64_t) { return 0.0; };
+  vector<Measurement> results;
+
+  results.push_back(measure("parse (heap)", min_seconds,
+    [&](uint64_t i) {
+      Boolean_Expression expression(texts[i % pool_size]);
+      expression.postfixTokens();
+    }, noRows));
+
+  Expression_Arena arena;
+  results.push_back(measure("parse (arena)", min_seconds,
+    [&](uint64_t i) {
+      if (arena.getExpressionCount() == ARENA_BATCH) arena.release();
+      arena.parse(texts[i % pool_size]).postfixTokens();
+    }, noRows));
+
+  results.push_back(measure("splitExpression", min_seconds,
+    [&](uint64_t i) { expressions[i % pool_size]->splitExpression(); }, noRows));
+
+  results.push_back(measure("convertToPostfix", min_seconds,
+    [&](uint64_t i) { expressions[i % pool_size]->convertToPostfix(); }, noRows));
+
+  results.push_back(measure("compile", min_seconds,
+    [&](uint64_t i) { expressions[i % pool_size]->compile(variables[i % pool_size]); }, noRows));
+
+  results.push_back(measure("compile (simplified)", min_seconds,
+    [&](uint64_t i) { expressions[i % pool_size]->compile(variables[i % pool_size], true); }, noRows));
+
+  results.push_back(measure("evaluateWithSteps", min_seconds,
+    [&](uint64_t i) {
+      const size_t k = i % pool_size;
+      // Walk the rows of the table: row i / pool_size
+      size_t bit = 0;
+      for (auto& input : inputs[k]) input.second = ((i / pool_size) >> bit++) & 1;
+      expressions[k]->evaluateWithSteps(postfixes[k], inputs[k]);
+    },
+    [](uint64_t) { return 1.0; }));
+
+  auto tableRows = [&](uint64_t i) { return double(tables[i % pool_size]->getLastRow()) + 1; };
+  results.push_back(measure("countTrue", min_seconds,
+    [&](uint64_t i) { tables[i % pool_size]->countTrue(); }, tableRows));
+
+  results.push_back(measure("countTrue (simplified)", min_seconds,
+    [&](uint64_t i) { simplified_tables[i % pool_size]->countTrue(); }, tableRows));
+
+  // Every evaluator built during this stage generates native code
+  Bitslice_Evaluator::enableJit(true);
+  results.push_back(measure("countTrue (jit)", min_seconds,
+    [&](uint64_t i) { tables[i % pool_size]->countTrue(); }, tableRows));
+  Bitslice_Evaluator::enableJit(false);
+
+  results.push_back(measure("first true row", min_seconds,
+    [&](uint64_t i) {
+      Filtered_Rows rows = tables[i % pool_size]->rows(Row_Filter::result());
+      rows.begin();
+    }, noRows));
+
+  results.push_back(measure("Table_Rows walk", min_seconds,
+    [&](uint64_t i) {
+      uint64_t true_rows = 0;
+      for (const Table_Row& row : tables[i % pool_size]->rows()) true_rows += row.getResult();
+      if (true_rows > tables[i % pool_size]->getLastRow() + 1) abort();
+    }, tableRows));
+
+  // Related rules: output k of a group is (shared term) XOR (its own
+  // expression), the shared term being the group's first pool expression.
+  // Counted as separate tables, then as the outputs of one circuit.
+  vector<unique_ptr<Boolean_Expression>> rule_expressions;
+  vector<unique_ptr<Truth_Table>> rule_tables;
+  vector<unique_ptr<Logic_Circuit>> circuits;
+  for (size_t first = 0; first + CIRCUIT_OUTPUTS < pool_size; first += CIRCUIT_OUTPUTS + 1) {
+    vector<const Boolean_Expression*> outputs;
+    vector<string> names;
+    for (size_t k = 1; k <= CIRCUIT_OUTPUTS; ++k) {
+      rule_expressions.push_back(make_unique<Boolean_Expression>(
+        "(" + texts[first] + ") XOR (" + texts[first + k] + ")"));
+      rule_tables.push_back(make_unique<Truth_Table>(*rule_expressions.back()));
+      outputs.push_back(rule_expressions.back().get());
+      names.push_back("F" + to_string(k));
+    }
+    circuits.push_back(make_unique<Logic_Circuit>(outputs, names));
+  }
+  if (!circuits.empty()) {
+    auto circuitRows = [&](uint64_t i) {
+      return double(circuits[i % circuits.size()]->getLastRow() + 1) * CIRCUIT_OUTPUTS;
+    };
+    // Today's way: one table (and one enumeration) per expression
+    results.push_back(measure("countTrue x" + to_string(CIRCUIT_OUTPUTS) + " (separate)", min_seconds,
+      [&](uint64_t i) {
+        const size_t first = (i % circuits.size()) * CIRCUIT_OUTPUTS;
+        for (size_t k = 0; k < CIRCUIT_OUTPUTS; ++k) rule_tables[first + k]->countTrue();
+      },
+      [&](uint64_t i) {
+        const size_t first = (i % circuits.size()) * CIRCUIT_OUTPUTS;
+        double rows = 0;
+        for (size_t k = 0; k < CIRCUIT_OUTPUTS; ++k) rows += double(rule_tables[first + k]->getLastRow()) + 1;
+        return rows;
+      }));
+    results.push_back(measure("Logic_Circuit countTrue x" + to_string(CIRCUIT_OUTPUTS), min_seconds,
+      [&](uint64_t i) { circuits[i % circuits.size()]->countTrue(); }, circuitRows));
+  }
+
+  // What Batch_Runner does per line; the pool repeats, so after the
+  // warm-up every cached lookup hits
+  results.push_back(measure("batch line", min_seconds,
+    [&](uint64_t i) {
+      Boolean_Expression expression(texts[i % pool_size]);
+      Truth_Table(expression, true).countTrue();
+    }, tableRows));
+
+  Expression_Cache cache;
+  for (const string& text : texts) {
+    Boolean_Expression expression(text);
+    Truth_Table(expression, true, &cache).countTrue();
+  }
+  results.push_back(measure("batch line (cached)", min_seconds,
+    [&](uint64_t i) {
+      Boolean_Expression expression(texts[i % pool_size]);
+      Truth_Table(expression, true, &cache).countTrue();
+    }, noRows));
+
+  const Equivalence_Checker checker;
+  results.push_back(measure("equivalence", min_seconds,
+    [&](uint64_t i) { checker.check(*expressions[i % pool_size], *simplified_expressions[i % pool_size]); },
+    noRows));
+
+  Table_Options table_options;
+  table_options.output_path = NULL_DEVICE;
+  results.push_back(measure("displayTable", min_seconds,
+    [&](uint64_t i) { tables[i % pool_size]->displayTable(table_options); }, tableRows));
+
+  // JSON report
+  printf("{\n");
+  printf("  \"benchmark\": \"expression\",\n");
+  printf("  \"config\": {\"vars\": %zu, \"depth\": %zu, \"not\": %g, \"seed\": %llu, \"pool\": %zu, "
+         "\"mix\": [%g, %g, %g, %g, %g]},\n",
+         settings.variables, settings.depth, settings.not_probability,
+         static_cast<unsigned long long>(settings.seed), pool_size,
+         settings.operator_mix[0], settings.operator_mix[1], settings.operator_mix[2],
+         settings.operator_mix[3], settings.operator_mix[4]);
+  printf("  \"sample\": %s,\n", jsonString(texts[0]).c_str());
+  printf("  \"results\": [\n");
+  for (size_t i = 0; i < results.size(); ++i) {
+    const Measurement& m = results[i];
+    printf("    {\"name\": %s, \"iterations\": %llu, \"ns_per_op\": %.1f, \"rows_per_s\": %.1f, "
+           "\"allocs_per_op\": %.2f, \"bytes_per_op\": %.1f}%s\n",
+           jsonString(m.name).c_str(), static_cast<unsigned long long>(m.iterations), m.ns_per_op,
+           m.rows_per_second, m.allocations_per_op, m.bytes_per_op, i + 1 < results.size() ? "," : "");
+  }
+  printf("  ]\n}\n");
+  return 0;
+}
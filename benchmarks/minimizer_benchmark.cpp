@@ -0,0 +1,153 @@
+/**
+ * @file minimizer_benchmark.cpp
+ * @brief Times the exact (Quine–McCluskey) and heuristic (Espresso-style)
+ *        minimizers on seeded random expressions from 4 to 24 variables,
+ *        then the heuristic alone on ever denser expressions over
+ *        dense_vars variables, up to a tautology.
+ *
+ * Build (from the repository root, linking every source except main.cpp):
+ *   g++ -std=c++17 -O2 -I. benchmarks/minimizer_benchmark.cpp \
+ *       $(ls *.cpp | grep -v '^main.cpp$') -pthread -o minimizer_benchmark
+ *
+ * Usage: minimizer_benchmark [min_vars] [max_vars] [seed] [dense_vars]
+ * Exact mode is skipped above Logic_Minimizer::EXACT_LIMIT_VARIABLES variables.
+ * Dense rows report the BDD size and the size of the starting cover
+ * (Logic_Minimizer::irredundantCover); "over budget" rows, past
+ * HEURISTIC_MAX_CUBES, show how long the minimizer took to refuse the input.
+ */
+
+#include "Boolean_Expression.h"
+#include "Truth_Table.h"
+#include "BDD_Manager.h"
+#include "Logic_Minimizer.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Sum of random product terms over n variables, with some NAND/NOR
+ *        groups so the input is not already in two-level form.
+ */
+static string randomExpression(size_t n, size_t terms, mt19937_64& rng) {
+  auto name = [](size_t j) { return "x" + to_string(j); };
+  string text;
+
+  for (size_t t = 0; t < terms; ++t) {
+    const size_t width = 2 + rng() % 3;
+    string term;
+    for (size_t k = 0; k < width; ++k) {
+      string literal = name(rng() % n);
+      if (rng() % 3 == 0) literal = "NOT " + literal;
+      if (k > 0) term += (rng() % 5 == 0) ? " NAND " : " AND ";
+      term += literal;
+    }
+    if (t > 0) text += (rng() % 6 == 0) ? " NOR " : " OR ";
+    text += "(" + term + ")";
+  }
+
+  // Make sure every variable appears, so the table really has n columns
+  for (size_t j = 0; j < n; ++j) {
+    text = "(" + text + ") OR (" + name(j) + " AND NOT " + name(j) + ")";
+  }
+  return text;
+}
+
+/**
+ * @brief Plain sum of `terms` random product terms (3 to 5 literals each) over
+ *        n variables; its BDD grows quickly with terms.
+ */
+static string denseExpression(size_t n, size_t terms, mt19937_64& rng) {
+  string text;
+
+  for (size_t t = 0; t < terms; ++t) {
+    const size_t width = 3 + rng() % 3;
+    string term;
+    for (size_t k = 0; k < width; ++k) {
+      string literal = "x" + to_string(rng() % n);
+      if (rng() % 2 == 0) literal = "NOT " + literal;
+      if (k > 0) term += " AND ";
+      term += literal;
+    }
+    if (t > 0) text += " OR ";
+    text += "(" + term + ")";
+  }
+  return text;
+}
+
+static double millisecondsSince(chrono::steady_clock::time_point start) {
+  return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+  const size_t min_vars = argc > 1 ? strtoul(argv[1], nullptr, 10) : 4;
+  const size_t max_vars = argc > 2 ? strtoul(argv[2], nullptr, 10) : 24;
+  const uint64_t seed = argc > 3 ? strtoull(argv[3], nullptr, 10) : 1;
+  const size_t dense_vars = argc > 4 ? strtoul(argv[4], nullptr, 10) : 34;
+  mt19937_64 rng(seed);
+
+  printf("%5s  %14s  %8s  %14s  %8s\n", "vars", "exact ms", "terms", "heuristic ms", "terms");
+
+  for (size_t n = min_vars; n <= max_vars; ++n) {
+    Boolean_Expression expr(randomExpression(n, n / 2 + 2, rng));
+
+    // Exact: truth table → Quine–McCluskey
+    string exact_ms = "skipped", exact_terms = "-";
+    if (n <= Logic_Minimizer::EXACT_LIMIT_VARIABLES) {
+      const auto start = chrono::steady_clock::now();
+      Truth_Table table(expr);
+      const auto cover = Logic_Minimizer::minimizeExact(table.resultBits(), table.getVariables().size());
+      exact_ms = to_string(millisecondsSince(start));
+      exact_terms = to_string(cover.size());
+    }
+
+    // Heuristic: BDD → Espresso-style loop
+    const auto start = chrono::steady_clock::now();
+    BDD_Manager bdd;
+    const BDD_Manager::Node root = bdd.build(expr.convertToPostfix());
+    const auto cover = Logic_Minimizer::minimizeHeuristic(bdd, root);
+    const double heuristic_ms = millisecondsSince(start);
+
+    printf("%5zu  %14s  %8s  %14.3f  %8zu\n", n, exact_ms.c_str(), exact_terms.c_str(), heuristic_ms, cover.size());
+    fflush(stdout);
+  }
+
+  // Dense inputs: half as many terms again on each row, until a tautology
+  printf("\n%5s  %8s  %10s  %12s  %14s  %12s\n", "vars", "terms in", "BDD nodes", "start terms", "heuristic ms", "terms");
+
+  for (size_t terms = 4; terms <= 1024; terms = terms * 3 / 2) {
+    Boolean_Expression expr(denseExpression(dense_vars, terms, rng));
+    BDD_Manager bdd;
+    const BDD_Manager::Node root = bdd.build(expr.convertToPostfix());
+    const size_t nodes = bdd.size(root);
+
+    string start_terms = "> " + to_string(Logic_Minimizer::HEURISTIC_MAX_CUBES);
+    try {
+      start_terms = to_string(Logic_Minimizer::irredundantCover(bdd, root, Logic_Minimizer::HEURISTIC_MAX_CUBES).size());
+    }
+    catch (const length_error&) {
+    }
+
+    string result;
+    const auto start = chrono::steady_clock::now();
+    try {
+      result = to_string(Logic_Minimizer::minimizeHeuristic(bdd, root).size());
+    }
+    catch (const length_error&) {
+      result = "over budget";
+    }
+    const double heuristic_ms = millisecondsSince(start);
+
+    printf("%5zu  %8zu  %10zu  %12s  %14.3f  %12s\n", dense_vars, terms, nodes, start_terms.c_str(), heuristic_ms,
+           result.c_str());
+    fflush(stdout);
+    if (root == BDD_Manager::TRUE_NODE) break;   // more terms stay a tautology
+  }
+  return 0;
+}
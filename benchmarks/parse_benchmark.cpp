@@ -0,0 +1,219 @@
+/**
+ * @file parse_benchmark.cpp
+ * @brief Times parsing against input size, from 1 KB to 100 MB, and prints
+ *        the results as JSON.
+ *
+ * Three input shapes, each grown to the target size:
+ *  - random : seeded random expressions (Expression_Generator) joined by OR
+ *  - left   : "((((x0 AND x1) OR x2) XOR x3) ..." nested one level per operator
+ *  - right  : "x0 AND (x1 OR (x2 XOR (x3 ...)))", whose operators all wait on
+ *             the operator stack until the end
+ * The nested shapes reach hundreds of thousands of levels per megabyte.
+ *
+ * Stages per input: split (Boolean_Expression construction: tokenize and
+ * list operators), postfixTokens (shunting-yard on token records) and
+ * convertToPostfix (the same, copied out as strings). For each it reports
+ * ns/byte, MB/s and heap allocations/bytes per byte of input; ns/byte
+ * staying flat as the size grows 100 000-fold is the linear-time check,
+ * and allocated bytes per input byte staying flat is the bounded-memory one.
+ *
+ * Build (from the repository root, linking every source except main.cpp):
+ *   g++ -std=c++17 -O2 -I. -Ibenchmarks benchmarks/parse_benchmark.cpp \
+ *       $(ls *.cpp | grep -v '^main.cpp$') -pthread -o parse_benchmark
+ *
+ * Usage: parse_benchmark [--min-kb N] [--max-mb N] [--shape random|left|right|all]
+ *                        [--seed S] [--min-time SECONDS]
+ * The 100 MB inputs need about 2 GB of memory (token records and strings).
+ */
+
+#include "Allocation_Tracker.h"
+#include "Boolean_Expression.h"
+#include "Expression_Generator.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+static const char* const OPERATORS[] = {"AND", "OR", "XOR"};
+
+struct Measurement {
+  string shape;
+  string stage;
+  size_t bytes = 0;
+  size_t tokens = 0;
+  uint64_t iterations = 0;
+  double ns_per_byte = 0;
+  double megabytes_per_second = 0;
+  double allocations_per_op = 0;
+  double allocated_bytes_per_byte = 0;
+};
+
+/**
+ * @brief Random expressions, parenthesized and joined by OR, until the
+ * text is at least `bytes` long.
+ */
+static string randomInput(size_t bytes, uint64_t seed) {
+  Expression_Generator::Settings settings;
+  settings.variables = 32;
+  settings.depth = 8;
+  settings.seed = seed;
+  Expression_Generator generator(settings);
+
+  string text;
+  text.reserve(bytes + 4096);
+  while (text.size() < bytes) {
+    if (!text.empty()) text += " OR ";
+    text += '(';
+    text += generator.next();
+    text += ')';
+  }
+  return text;
+}
+
+/**
+ * @brief "((((x0 AND x1) OR x2) ..." with as many levels as fit in `bytes`.
+ * Every operator closes one parenthesis, so the nesting depth is the
+ * operator count.
+ */
+static string leftInput(size_t bytes) {
+  string tail;
+  size_t levels = 0;
+  while (tail.size() + levels + 2 < bytes) {
+    tail += " ";
+    tail += OPERATORS[levels % 3];
+    tail += " x" + to_string((levels + 1) % 32) + ")";
+    ++levels;
+  }
+  return string(levels, '(') + "x0" + tail;
+}
+
+// "x0 AND (x1 OR (x2 XOR (... x_k)))" with as many levels as fit in `bytes`
+static string rightInput(size_t bytes) {
+  string head;
+  size_t levels = 0;
+  while (head.size() + levels + 4 < bytes) {
+    head += "x" + to_string(levels % 32) + " " + OPERATORS[levels % 3] + " (";
+    ++levels;
+  }
+  return head + "x" + to_string(levels % 32) + string(levels, ')');
+}
+
+/**
+ * @brief Run op() until min_seconds have passed (at least once) and
+ * report it per input byte.
+ */
+template <typename Op>
+static Measurement measure(const string& shape, const string& stage, const string& input, size_t tokens,
+                           double min_seconds, Op op) {
+  Measurement result;
+  result.shape = shape;
+  result.stage = stage;
+  result.bytes = input.size();
+  result.tokens = tokens;
+
+  double seconds = 0;
+  const uint64_t count_before = Allocation_Tracker::getCount();
+  const uint64_t bytes_before = Allocation_Tracker::getBytes();
+  while (result.iterations == 0 || seconds < min_seconds) {
+    const auto start = chrono::steady_clock::now();
+    op();
+    seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    ++result.iterations;
+  }
+
+  const double processed = double(input.size()) * result.iterations;
+  result.ns_per_byte = seconds * 1e9 / processed;
+  result.megabytes_per_second = processed / seconds / 1e6;
+  result.allocations_per_op = double(Allocation_Tracker::getCount() - count_before) / result.iterations;
+  result.allocated_bytes_per_byte = double(Allocation_Tracker::getBytes() - bytes_before) / processed;
+  return result;
+}
+
+int main(int argc, char* argv[]) {
+  size_t min_kb = 1;
+  size_t max_mb = 100;
+  string shape_option = "all";
+  uint64_t seed = 1;
+  double min_seconds = 0.2;
+
+  try {
+    for (int i = 1; i + 1 < argc; i += 2) {
+      const string arg = argv[i];
+      const string value = argv[i + 1];
+      if (arg == "--min-kb") min_kb = max<size_t>(1, stoul(value));
+      else if (arg == "--max-mb") max_mb = stoul(value);
+      else if (arg == "--shape") shape_option = value;
+      else if (arg == "--seed") seed = stoull(value);
+      else if (arg == "--min-time") min_seconds = stod(value);
+      else throw invalid_argument("Unknown option " + arg);
+    }
+    if (shape_option != "all" && shape_option != "random" && shape_option != "left" && shape_option != "right") {
+      throw invalid_argument("Unknown shape " + shape_option);
+    }
+  }
+  catch (const exception& error) {
+    fprintf(stderr, "%s\n", error.what());
+    fprintf(stderr, "Usage: %s [--min-kb N] [--max-mb N] [--shape random|left|right|all] [--seed S] "
+                    "[--min-time SECONDS]\n", argv[0]);
+    return 2;
+  }
+
+  Allocation_Tracker::enable();
+
+  // 1 KB, 10 KB, ... up to max_mb
+  vector<size_t> sizes;
+  for (size_t bytes = min_kb * 1000; bytes <= max_mb * 1000000; bytes *= 10) {
+    sizes.push_back(bytes);
+  }
+
+  vector<Measurement> results;
+  for (const char* shape : {"random", "left", "right"}) {
+    if (shape_option != "all" && shape_option != shape) continue;
+
+    for (size_t bytes : sizes) {
+      const string input = string(shape) == "random" ? randomInput(bytes, seed)
+                         : string(shape) == "left"   ? leftInput(bytes)
+                                                     : rightInput(bytes);
+      size_t tokens = 0;
+      {
+        Boolean_Expression expression(input);
+        tokens = expression.getTokens().size();
+      }
+
+      results.push_back(measure(shape, "split", input, tokens, min_seconds,
+        [&] { Boolean_Expression expression(input); }));
+
+      // Tokens stay in place; only the conversion is timed
+      Boolean_Expression expression(input);
+      results.push_back(measure(shape, "postfixTokens", input, tokens, min_seconds,
+        [&] { expression.postfixTokens(); }));
+
+      results.push_back(measure(shape, "convertToPostfix", input, tokens, min_seconds,
+        [&] { expression.convertToPostfix(); }));
+
+      fprintf(stderr, "%s %zu bytes done\n", shape, input.size());
+    }
+  }
+
+  // JSON report
+  printf("{\n");
+  printf("  \"benchmark\": \"parse\",\n");
+  printf("  \"config\": {\"min_kb\": %zu, \"max_mb\": %zu, \"seed\": %llu},\n",
+         min_kb, max_mb, static_cast<unsigned long long>(seed));
+  printf("  \"results\": [\n");
+  for (size_t i = 0; i < results.size(); ++i) {
+    const Measurement& m = results[i];
+    printf("    {\"shape\": \"%s\", \"stage\": \"%s\", \"bytes\": %zu, \"tokens\": %zu, \"iterations\": %llu, "
+           "\"ns_per_byte\": %.2f, \"mb_per_s\": %.1f, \"allocs_per_op\": %.1f, \"alloc_bytes_per_byte\": %.2f}%s\n",
+           m.shape.c_str(), m.stage.c_str(), m.bytes, m.tokens, static_cast<unsigned long long>(m.iterations),
+           m.ns_per_byte, m.megabytes_per_second, m.allocations_per_op, m.allocated_bytes_per_byte,
+           i + 1 < results.size() ? "," : "");
+  }
+  printf("  ]\n}\n");
+  return 0;
+}
@@ -3,44 +3,821 @@
  * @brief Entry point for the Boolean Truth Table Simulator.
  *
  * Steps:
- *  1. Ask user for a Boolean expression (A, B, C and operators).
+ *  1. Ask user for a Boolean expression (named variables and operators).
  *  2. Parse and analyze it using Boolean_Expression.
  *  3. Display detected operators with their meanings.
  *  4. Generate and print the corresponding truth table.
+ *
+ * Options:
+ *  --threads N   split the table into chunks evaluated on N workers
+ *                (0 = one per hardware thread); output keeps row order.
+ *  --format F    text (default), csv, jsonl or markdown
+ *  --output PATH write the table to a file instead of the console
+ *  --save PATH   save the result bits as a packed binary table (Table_File)
+ *  --load PATH   summarise a saved binary table without re-evaluating
+ *  --count       count true rows / test tautology with a BDD (no enumeration)
+ *  --minimize    print a minimized sum-of-products form
+ *  --batch PATH  evaluate one expression per line of PATH (- = stdin)
+ *  --circuit PATH tabulate every line of PATH ("NAME = EXPR" or EXPR) as
+ *                one output of a circuit: one table, shared subterms
+ *  --cache-mb N  with --batch or --serve, cache compiled expressions and
+ *                counts in up to N MiB, keyed by canonical form (0 = off)
+ *  --serve PATH  answer evaluate / count / table / equiv requests on the
+ *                Unix domain socket PATH until interrupted
+ *  --sat         find a satisfying assignment with a CDCL SAT solver
+ *  --dimacs PATH write the expression's CNF (Tseitin encoding) to PATH
+ *  --simplify    show the simplified expression and tabulate it instead
+ *  --equiv E1 E2 check whether two expressions are equivalent (no prompt)
+ *  --jit         evaluate bit-sliced blocks with generated x86-64 code
+ *                (interpreted kernels elsewhere)
+ *  --stats       print per-phase timings and counters to stderr
+ *                (--stats-json prints them as one JSON object)
  */
 
+#include <algorithm>
+#include <csignal>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <exception>
+#include <fstream>
+#include <stdexcept>
+#include "Batch_Runner.h"
+#include "Bitslice_Evaluator.h"
 #include "Boolean_Expression.h"
+#include "Expression_Cache.h"
+#include "Parse_Error.h"
+#include "Run_Stats.h"
+#include "Allocation_Tracker.h"
 #include "Truth_Table.h"
+#include "Table_File.h"
+#include "BDD_Manager.h"
+#include "Logic_Minimizer.h"
+#include "SAT_Solver.h"
+#include "Tseitin_Encoder.h"
+#include "Equivalence_Checker.h"
+#include "Evaluation_Server.h"
+#include "Logic_Circuit.h"
 
 using namespace std;
 
-int main()
+// Command-line options (all optional; the expression is read from stdin)
+struct Options
+{
+    Table_Options table;    // --threads N, --format F, --output PATH
+    string save_path;       // --save PATH : write a packed binary table instead of text
+    bool save_steps = false;// --save-steps : also store every step column
+    string load_path;       // --load PATH : inspect a saved binary table
+    bool has_row = false;   // --row R : with --load, print one row
+    uint64_t row = 0;
+    bool count = false;     // --count : count true rows with a BDD instead of printing
+    bool minimize = false;  // --minimize [--method M] : print a minimal sum of products
+    Logic_Minimizer::Method method = Logic_Minimizer::Method::AUTO;
+    string batch_path;      // --batch PATH : one expression per line (- = stdin)
+    string circuit_path;    // --circuit PATH : one output per line, evaluated together
+    uint64_t cache_mb = Expression_Cache::DEFAULT_MAX_BYTES >> 20;  // --cache-mb N : batch / server cache (0 = off)
+    string serve_path;      // --serve PATH : run as a server on a Unix domain socket
+    bool sat = false;       // --sat : search for a satisfying assignment (no table)
+    string dimacs_path;     // --dimacs PATH : write the CNF encoding
+    bool simplify = false;  // --simplify : print and tabulate the simplified expression
+    bool equiv = false;     // --equiv E1 E2 : compare two expressions given on the command line
+    string equiv_first;
+    string equiv_second;
+    bool jit = false;       // --jit : native code for the bit-sliced kernels
+    bool stats = false;     // --stats / --stats-json : report timings and counters on stderr
+    bool stats_json = false;
+};
+
+static void printUsage(const char* program)
+{
+    cerr << "Usage: " << program << " [--threads N] [--format F] [--output PATH]\n"
+         << "       " << program << " --save PATH [--save-steps] [--threads N]\n"
+         << "       " << program << " --load PATH [--row R]\n"
+         << "       " << program << " --count\n"
+         << "       " << program << " --minimize [--method auto|exact|heuristic]\n"
+         << "       " << program << " --batch PATH|- [--threads N] [--output PATH] [--cache-mb N]\n"
+         << "       " << program << " --serve SOCKET [--threads N] [--cache-mb N]\n"
+         << "       " << program << " --circuit PATH|- [--count] [--simplify] [table options]\n"
+         << "       " << program << " --sat [--dimacs PATH]\n"
+         << "       " << program << " --simplify [table options]\n"
+         << "       " << program << " --equiv \"EXPR1\" \"EXPR2\"\n"
+         << "  --threads N     evaluate and format the table on N threads (0 = all cores)\n"
+         << "  --format F      table format: text (default), csv, jsonl, markdown\n"
+         << "  --output PATH   write the table to PATH instead of the console\n"
+         << "  --save PATH     save the result column as a packed binary table file\n"
+         << "  --save-steps    with --save, also store every step column\n"
+         << "  --load PATH     print a summary of a saved binary table\n"
+         << "  --row R         with --load, print the values at row R\n"
+         << "  --count         count true rows and test tautology with a BDD (no table)\n"
+         << "  --minimize      print a minimized sum-of-products form (no table)\n"
+         << "  --method M      minimizer: auto (default), exact (Quine-McCluskey), heuristic (Espresso-style)\n"
+         << "  --batch PATH    evaluate each line of PATH (- = stdin); prints line, status, true rows, rows\n"
+         << "  --circuit PATH  treat each line of PATH (- = stdin), \"NAME = EXPR\" or EXPR, as one output;\n"
+         << "                  print one table with a column per output (--count: true rows per output)\n"
+         << "  --cache-mb N    with --batch or --serve, reuse results of repeated expressions (N MiB, default 64, 0 = off)\n"
+         << "  --serve SOCKET  serve evaluate/count/table/equiv requests on a Unix domain socket until interrupted\n"
+         << "  --sat           find an assignment that makes the expression true (CDCL SAT solver)\n"
+         << "  --dimacs PATH   write the expression's CNF encoding to PATH in DIMACS format\n"
+         << "  --simplify      print the simplified expression; the table shows its steps\n"
+         << "  --equiv E1 E2   check that two expressions have the same truth table, or print a row where they differ\n"
+         << "  --jit           run row blocks as generated x86-64 code (falls back to the interpreter elsewhere)\n"
+         << "  --stats         print per-phase timings, counters and allocations to stderr\n"
+         << "  --stats-json    same as --stats, as one JSON object\n";
+}
+
+// Parse a non-negative integer argument
+static bool parseNumber(const char* text, uint64_t& value)
+{
+    try
+    {
+        size_t used = 0;
+        const string arg = text;
+        if (arg.empty() || arg[0] == '-')
+            return false;
+        value = stoull(arg, &used);
+        return used == arg.size();
+    }
+    catch (const exception&)
+    {
+        return false;
+    }
+}
+
+// Parse argv into options; returns false on a malformed command line
+static bool parseOptions(int argc, char* argv[], Options& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const string arg = argv[i];
+
+        if (arg == "--threads" && i + 1 < argc)
+        {
+            uint64_t value;
+            if (!parseNumber(argv[++i], value) || value > 4096)
+                return false;
+            options.table.threads = static_cast<unsigned>(value);
+        }
+        else if (arg == "--format" && i + 1 < argc)
+        {
+            if (!Table_Writer::parseFormat(argv[++i], options.table.format))
+                return false;
+        }
+        else if (arg == "--output" && i + 1 < argc)
+        {
+            options.table.output_path = argv[++i];
+        }
+        else if (arg == "--save" && i + 1 < argc)
+        {
+            options.save_path = argv[++i];
+        }
+        else if (arg == "--save-steps")
+        {
+            options.save_steps = true;
+        }
+        else if (arg == "--load" && i + 1 < argc)
+        {
+            options.load_path = argv[++i];
+        }
+        else if (arg == "--count")
+        {
+            options.count = true;
+        }
+        else if (arg == "--minimize")
+        {
+            options.minimize = true;
+        }
+        else if (arg == "--method" && i + 1 < argc)
+        {
+            const string method = argv[++i];
+            if (method == "auto")
+                options.method = Logic_Minimizer::Method::AUTO;
+            else if (method == "exact")
+                options.method = Logic_Minimizer::Method::EXACT;
+            else if (method == "heuristic")
+                options.method = Logic_Minimizer::Method::HEURISTIC;
+            else
+                return false;
+        }
+        else if (arg == "--batch" && i + 1 < argc)
+        {
+            options.batch_path = argv[++i];
+        }
+        else if (arg == "--circuit" && i + 1 < argc)
+        {
+            options.circuit_path = argv[++i];
+        }
+        else if (arg == "--cache-mb" && i + 1 < argc)
+        {
+            if (!parseNumber(argv[++i], options.cache_mb) || options.cache_mb > (uint64_t(1) << 20))
+                return false;
+        }
+        else if (arg == "--serve" && i + 1 < argc)
+        {
+            options.serve_path = argv[++i];
+        }
+        else if (arg == "--sat")
+        {
+            options.sat = true;
+        }
+        else if (arg == "--dimacs" && i + 1 < argc)
+        {
+            options.dimacs_path = argv[++i];
+        }
+        else if (arg == "--equiv" && i + 2 < argc)
+        {
+            options.equiv = true;
+            options.equiv_first = argv[++i];
+            options.equiv_second = argv[++i];
+        }
+        else if (arg == "--simplify")
+        {
+            options.simplify = true;
+        }
+        else if (arg == "--jit")
+        {
+            options.jit = true;
+        }
+        else if (arg == "--stats")
+        {
+            options.stats = true;
+        }
+        else if (arg == "--stats-json")
+        {
+            options.stats = true;
+            options.stats_json = true;
+        }
+        else if (arg == "--row" && i + 1 < argc)
+        {
+            if (!parseNumber(argv[++i], options.row))
+                return false;
+            options.has_row = true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Report a syntax error and underline where it is
+static void printParseError(const string& expression, const Parse_Error& error)
+{
+    cout << "Invalid expression: " << error.what() << "\n";
+    cout << "  " << expression << "\n";
+    cout << "  " << string(min(error.getPosition(), expression.size()), ' ')
+         << string(error.getLength(), '^') << endl;
+}
+
+// Print a summary of a saved binary table (and optionally one row)
+static int showTableFile(const Options& options)
+{
+    try
+    {
+        Table_File file(options.load_path);
+        const vector<string>& variables = file.getVariables();
+
+        cout << "Expression : " << file.getExpression() << "\n";
+        cout << "Variables  : " << variables.size() << " (";
+        for (size_t i = 0; i < variables.size(); ++i)
+            cout << (i ? ", " : "") << variables[i];
+        cout << ")\n";
+        if (variables.size() < 64)
+            cout << "Rows       : " << file.getLastRow() + 1 << "\n";
+        else
+            cout << "Rows       : 2^64\n";
+        cout << "True rows  : " << file.countTrue() << "\n";
+
+        uint64_t first_true;
+        if (file.nextTrueRow(0, first_true))
+            cout << "First true : row " << first_true << "\n";
+
+        if (options.has_row)
+        {
+            cout << "\nRow " << options.row << ":\n";
+            for (size_t i = 0; i < variables.size(); ++i)
+                cout << "  " << variables[i] << " = "
+                     << ((options.row >> (variables.size() - i - 1)) & 1) << "\n";
+            for (size_t column = 0; column < file.getColumnCount(); ++column)
+                cout << "  " << file.getColumnLabels()[column] << " = "
+                     << file.value(options.row, column) << "\n";
+        }
+    }
+    catch (const exception& error)
+    {
+        cout << "Error: " << error.what() << endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Evaluate every line of the batch input; errors are reported per line
+static int runBatch(const Options& options)
+{
+    ifstream file;
+    if (options.batch_path != "-")
+    {
+        file.open(options.batch_path);
+        if (!file)
+        {
+            cout << "Error: Cannot open batch file " << options.batch_path << endl;
+            return 1;
+        }
+    }
+    istream& input = options.batch_path == "-" ? cin : file;
+
+    ofstream output_file;
+    if (!options.table.output_path.empty())
+    {
+        output_file.open(options.table.output_path);
+        if (!output_file)
+        {
+            cout << "Error: Cannot open output file " << options.table.output_path << endl;
+            return 1;
+        }
+    }
+    ostream& output = options.table.output_path.empty() ? cout : output_file;
+
+    Batch_Runner runner(options.table.threads, static_cast<size_t>(options.cache_mb) << 20);
+    const Batch_Runner::Summary summary = runner.run(input, output);
+
+    cerr << "Evaluated " << summary.expressions << " expressions, "
+         << summary.errors << " with errors" << endl;
+    if (options.cache_mb > 0)
+    {
+        const Expression_Cache::Statistics& cache = summary.cache;
+        cerr << "Cache: " << cache.hits << " hits, " << cache.misses << " misses, "
+             << cache.evictions << " evictions, " << cache.entries << " entries ("
+             << cache.bytes << " bytes)" << endl;
+    }
+    return summary.errors == 0 ? 0 : 1;
+}
+
+// Read the outputs of a circuit ("NAME = EXPR", or EXPR named F1, F2, ...;
+// blank lines and '#' comments are skipped) and print one combined table
+static int runCircuit(const Options& options)
+{
+    ifstream file;
+    if (options.circuit_path != "-")
+    {
+        file.open(options.circuit_path);
+        if (!file)
+        {
+            cout << "Error: Cannot open circuit file " << options.circuit_path << endl;
+            return 1;
+        }
+    }
+    istream& input = options.circuit_path == "-" ? cin : file;
+
+    auto trim = [](const string& text) {
+        const size_t first = text.find_first_not_of(" \t\r\n");
+        if (first == string::npos)
+            return string();
+        return text.substr(first, text.find_last_not_of(" \t\r\n") - first + 1);
+    };
+
+    vector<unique_ptr<Boolean_Expression>> expressions;
+    vector<string> names;
+    string line;
+    size_t line_number = 0;
+    while (getline(input, line))
+    {
+        ++line_number;
+        string text = trim(line);
+        if (text.empty() || text[0] == '#')
+            continue;
+
+        string name = "F" + to_string(names.size() + 1);
+        const size_t equals = text.find('=');
+        if (equals != string::npos)
+        {
+            name = trim(text.substr(0, equals));
+            text = trim(text.substr(equals + 1));
+            if (!Boolean_Expression::isVariable(name))
+            {
+                cout << "Line " << line_number << ": invalid output name \"" << name << "\"" << endl;
+                return 1;
+            }
+        }
+        if (find(names.begin(), names.end(), name) != names.end())
+        {
+            cout << "Line " << line_number << ": output " << name << " is defined twice" << endl;
+            return 1;
+        }
+
+        try
+        {
+            Run_Stats::Scope scope(Run_Stats::Phase::PARSE);
+            expressions.push_back(make_unique<Boolean_Expression>(text));
+            expressions.back()->postfixTokens();
+            Run_Stats::add(Run_Stats::Counter::TOKENS, expressions.back()->getTokens().size());
+        }
+        catch (const Parse_Error& error)
+        {
+            cout << "Line " << line_number << ": ";
+            printParseError(text, error);
+            return 1;
+        }
+        names.push_back(name);
+    }
+
+    try
+    {
+        vector<const Boolean_Expression*> outputs;
+        for (const auto& expression : expressions)
+            outputs.push_back(expression.get());
+        const Logic_Circuit circuit(outputs, names, options.simplify);
+
+        cout << "Outputs    : " << circuit.getOutputCount() << "\n";
+        cout << "Variables  : " << circuit.getVariables().size() << "\n";
+        cout << "Gates/row  : " << circuit.getStepCount() << " shared ("
+             << circuit.getSeparateStepCount() << " if each output were evaluated alone)\n" << endl;
+
+        if (options.count)
+        {
+            const vector<uint64_t> counts = circuit.countTrue();
+            for (size_t k = 0; k < counts.size(); ++k)
+                cout << names[k] << "\t" << counts[k] << "\t" << circuit.getLastRow() + 1 << "\n";
+            cout.flush();
+        }
+        else
+        {
+            circuit.displayTable(options.table);
+        }
+    }
+    catch (const exception& error)
+    {
+        cout << "Error: " << error.what() << endl;
+        return 1;
+    }
+    return 0;
+}
+
+// The running server, for the signal handler
+static Evaluation_Server* active_server = nullptr;
+
+static void stopServer(int)
+{
+    if (active_server)
+        active_server->stop();
+}
+
+// Serve requests on a Unix domain socket until SIGINT / SIGTERM
+static int runServer(const Options& options)
+{
+    Evaluation_Server server(options.serve_path, options.table.threads,
+                             static_cast<size_t>(options.cache_mb) << 20);
+    active_server = &server;
+    signal(SIGINT, stopServer);
+    signal(SIGTERM, stopServer);
+
+    cerr << "Listening on " << options.serve_path << endl;
+    int status = 0;
+    try
+    {
+        server.run();
+    }
+    catch (const exception& error)
+    {
+        cerr << "Error: " << error.what() << endl;
+        status = 1;
+    }
+    signal(SIGINT, SIG_DFL);
+    signal(SIGTERM, SIG_DFL);
+    active_server = nullptr;
+
+    const Expression_Cache::Statistics cache = server.getCacheStatistics();
+    cerr << "Served " << server.getRequestsServed() << " requests (cache: " << cache.hits
+         << " hits, " << cache.misses << " misses)" << endl;
+    return status;
+}
+
+// Answer count / tautology questions from a BDD instead of enumerating rows
+static int showCount(Boolean_Expression& expr)
+{
+    try
+    {
+        BDD_Manager bdd;
+        const BDD_Manager::Node root = bdd.build(expr.convertToPostfix());
+        const size_t n = bdd.getVariableCount();
+
+        cout << "Variables    : " << n << "\n";
+        cout << "BDD nodes    : " << bdd.size(root) << "\n";
+        cout << "Rows         : " << BDD_Manager::rowCountText(n) << "\n";
+        cout << "True rows    : " << bdd.satCountText(root) << "\n";
+        cout << "Satisfiable  : " << (bdd.isSatisfiable(root) ? "yes" : "no") << "\n";
+        cout << "Tautology    : " << (bdd.isTautology(root) ? "yes" : "no") << endl;
+    }
+    catch (const invalid_argument& error)
+    {
+        cout << "Invalid expression: " << error.what() << endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Print a minimized sum-of-products form of the expression
+static int showMinimized(Boolean_Expression& expr, Logic_Minimizer::Method method)
+{
+    try
+    {
+        vector<Logic_Minimizer::Cube> cover;
+        vector<string> variables;
+
+        BDD_Manager bdd;
+        const BDD_Manager::Node root = bdd.build(expr.convertToPostfix());
+
+        const bool exact = method == Logic_Minimizer::Method::EXACT ||
+            (method == Logic_Minimizer::Method::AUTO &&
+             bdd.getVariableCount() <= Logic_Minimizer::EXACT_MAX_VARIABLES);
+
+        if (exact)
+        {
+            // Quine-McCluskey works from the truth table's result column
+            Truth_Table table(expr, true);
+            variables = table.getVariables();
+            cover = Logic_Minimizer::minimizeExact(table.resultBits(), variables.size());
+        }
+        else
+        {
+            variables = bdd.getVariables();
+            cover = Logic_Minimizer::minimizeHeuristic(bdd, root);
+        }
+
+        cout << "Method     : " << (exact ? "exact (Quine-McCluskey)" : "heuristic (Espresso-style)") << "\n";
+        cout << "Terms      : " << cover.size() << "\n";
+        cout << "Literals   : " << Logic_Minimizer::literalCount(cover) << "\n";
+        cout << "Minimized  : " << Logic_Minimizer::toExpression(cover, variables) << endl;
+    }
+    catch (const exception& error)
+    {
+        cout << "Error: " << error.what() << endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Answer "can this ever be true?" with a SAT solver on the Tseitin encoding;
+// also writes the CNF when --dimacs is given
+static int showSat(Boolean_Expression& expr, const Options& options)
+{
+    try
+    {
+        vector<string> variables;
+        for (string_view name : expr.getVariableNames())
+            variables.emplace_back(name);
+
+        Expression_DAG dag(variables);
+        const Expression_DAG::Node_Id root = expr.buildGraph(dag, true);
+        const Tseitin_Encoder cnf(dag, root);
+
+        if (!options.dimacs_path.empty())
+        {
+            ofstream file(options.dimacs_path);
+            if (!file)
+            {
+                cout << "Error: Cannot open DIMACS file " << options.dimacs_path << endl;
+                return 1;
+            }
+            cnf.writeDimacs(file);
+            cout << "Wrote CNF (" << cnf.getVariableCount() << " variables, " << cnf.getClauseCount()
+                 << " clauses) to " << options.dimacs_path << endl;
+        }
+        if (!options.sat)
+            return 0;
+
+        const uint64_t start = Run_Stats::wallNow();
+        SAT_Solver solver;
+        cnf.addTo(solver);
+        const SAT_Solver::Result result = solver.solve();
+        const double milliseconds = (Run_Stats::wallNow() - start) / 1e6;
+        const SAT_Solver::Statistics& statistics = solver.getStatistics();
+
+        cout << "Variables    : " << variables.size() << " (" << cnf.getVariableCount() << " in CNF)\n";
+        cout << "Clauses      : " << cnf.getClauseCount() << "\n";
+        cout << "Conflicts    : " << statistics.conflicts << " (" << statistics.decisions << " decisions, "
+             << statistics.restarts << " restarts)\n";
+        cout << "Time         : " << milliseconds << " ms\n";
+        if (result == SAT_Solver::Result::SATISFIABLE)
+        {
+            cout << "Satisfiable  : yes\n";
+            cout << "Assignment   :";
+            for (size_t i = 0; i < variables.size(); ++i)
+                cout << " " << variables[i] << "=" << solver.getModelValue(static_cast<int>(i + 1));
+            cout << endl;
+        }
+        else
+        {
+            cout << "Satisfiable  : no (the expression is never true)" << endl;
+        }
+    }
+    catch (const exception& error)
+    {
+        cout << "Error: " << error.what() << endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Compare two expressions: random simulation first, then an exact method
+static int showEquivalence(const Options& options)
 {
+    unique_ptr<Boolean_Expression> first, second;
+    try
+    {
+        Run_Stats::Scope scope(Run_Stats::Phase::PARSE);
+        first = make_unique<Boolean_Expression>(options.equiv_first);
+        first->postfixTokens();
+    }
+    catch (const Parse_Error& error)
+    {
+        printParseError(options.equiv_first, error);
+        return 1;
+    }
+    try
+    {
+        Run_Stats::Scope scope(Run_Stats::Phase::PARSE);
+        second = make_unique<Boolean_Expression>(options.equiv_second);
+        second->postfixTokens();
+    }
+    catch (const Parse_Error& error)
+    {
+        printParseError(options.equiv_second, error);
+        return 1;
+    }
+
+    try
+    {
+        const uint64_t start = Run_Stats::wallNow();
+        const Equivalence_Checker checker;
+        const Equivalence_Checker::Result result = checker.check(*first, *second);
+        const double milliseconds = (Run_Stats::wallNow() - start) / 1e6;
+
+        cout << "Variables      : " << result.variables.size() << "\n";
+        cout << "Method         : " << Equivalence_Checker::methodName(result.method);
+        if (result.simulated_vectors > 0)
+            cout << " (after " << result.simulated_vectors << " random vectors)";
+        cout << "\n";
+        cout << "Time           : " << milliseconds << " ms\n";
+        if (result.equivalent)
+        {
+            cout << "Equivalent     : yes" << endl;
+        }
+        else
+        {
+            cout << "Equivalent     : no\n";
+            cout << "Counterexample :";
+            for (size_t i = 0; i < result.variables.size(); ++i)
+                cout << " " << result.variables[i] << "=" << result.counterexample[i];
+            cout << "\n";
+            cout << "  first  = " << result.first_value << "\n";
+            cout << "  second = " << result.second_value << endl;
+        }
+    }
+    catch (const exception& error)
+    {
+        cout << "Error: " << error.what() << endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Everything after option parsing; main() wraps it with --stats
+static int run(const Options& options)
+{
+    if (!options.load_path.empty())
+        return showTableFile(options);
+
+    if (!options.batch_path.empty())
+        return runBatch(options);
+
+    if (!options.circuit_path.empty())
+        return runCircuit(options);
+
+    if (options.equiv)
+        return showEquivalence(options);
+
+    if (!options.serve_path.empty())
+        return runServer(options);
+
     cout << "*** BOOLEAN TRUTH TABLE SIMULATOR ***\n" << endl;
 
     // Step 1 : Get user input
-    cout << "Enter Boolean Expression (max 3 operators with 3 variables: A, B, C): \n> ";
+    cout << "Enter Boolean Expression (variables are names such as A, B, req_valid; up to 64): \n> ";
     string user_expression;
     getline(cin, user_expression);
 
-    // Step 2 : Create a Boolean_Expression object
-    Boolean_Expression expr(user_expression);
+    // Step 2 : Create a Boolean_Expression object; syntax errors are
+    // reported here, pointing at the offending token
+    unique_ptr<Boolean_Expression> parsed;
+    try
+    {
+        Run_Stats::Scope scope(Run_Stats::Phase::PARSE);
+        parsed = make_unique<Boolean_Expression>(user_expression);
+        parsed->postfixTokens();
+        Run_Stats::add(Run_Stats::Counter::TOKENS, parsed->getTokens().size());
+    }
+    catch (const Parse_Error& error)
+    {
+        printParseError(user_expression, error);
+        return 1;
+    }
+    Boolean_Expression& expr = *parsed;
 
     // Step 3 : Show detected operators and their explanations
     cout << "\nOperators Detected and Explained:\n";
     const auto& operators = expr.getOperators();   // NOTE: const reference, no copying
 
-    for (const auto& op : operators) // op is a unique_ptr<...>&
+    for (const auto& op : operators) // op is a const Boolean_Operator*
     {
         cout << "- " << op->getName() << ": " << op->getExplanation() << endl;
     }
 
+    if (options.simplify)
+    {
+        try
+        {
+            cout << "\nOriginal   : " << expr.getOriginalExpression() << "\n";
+            cout << "Simplified : " << expr.getSimplifiedExpression() << endl;
+        }
+        catch (const exception& error)
+        {
+            cout << "Error: " << error.what() << endl;
+            return 1;
+        }
+    }
+
+    // Counting only needs the BDD, not the 2^n rows
+    if (options.count)
+    {
+        cout << "\nCounting with a BDD...\n" << endl;
+        return showCount(expr);
+    }
+
+    if (options.sat || !options.dimacs_path.empty())
+    {
+        cout << "\nEncoding to CNF" << (options.sat ? " and solving" : "") << "...\n" << endl;
+        return showSat(expr, options);
+    }
+
+    if (options.minimize)
+    {
+        cout << "\nMinimizing...\n" << endl;
+        return showMinimized(expr, options.method);
+    }
+
     // Step 4 : Generate and Display the truth table
     cout << "\nGenerating Truth Table...\n" << endl;
-    Truth_Table table(expr);
-    table.displayTable();
+    try
+    {
+        Truth_Table table(expr, options.simplify);   // compiles the expression once
+        if (!options.save_path.empty())
+        {
+            table.saveBinary(options.save_path, options.save_steps, options.table.threads);
+            cout << "Saved " << table.getVariables().size() << "-variable table to "
+                 << options.save_path << endl;
+        }
+        else
+        {
+            table.displayTable(options.table);
+        }
+    }
+    catch (const invalid_argument& error)
+    {
+        cout << "Invalid expression: " << error.what() << endl;
+        return 1;
+    }
+    catch (const exception& error)
+    {
+        cout << "Error: " << error.what() << endl;
+        return 1;
+    }
 
     return 0;
-}
\ No newline at end of file
+}
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        printUsage(argv[0]);
+        return 2;
+    }
+    Bitslice_Evaluator::enableJit(options.jit);
+
+    if (!options.stats)
+        return run(options);
+
+    Run_Stats::enable();
+    Allocation_Tracker::enable();
+    const uint64_t wall_start = Run_Stats::wallNow();
+    const uint64_t cpu_start = Run_Stats::processCpuNow();
+
+    const int status = run(options);
+
+    cout.flush();
+    Run_Stats::report(cerr, options.stats_json, Run_Stats::wallNow() - wall_start,
+                      Run_Stats::processCpuNow() - cpu_start);
+    return status;
+}
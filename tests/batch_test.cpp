@@ -0,0 +1,102 @@
+/**
+ * @file batch_test.cpp
+ * @brief Regression checks for Batch_Runner and the row counts it shares
+ * with --serve (BDD_Manager::countRows).
+ *
+ * Result lines must come out in input order with the right status and
+ * counts, whatever the thread count; malformed lines are reported by
+ * kind and blank or comment lines skipped. Counting by enumeration and by
+ * BDD must agree, and wide expressions must be counted without a table.
+ *
+ * Built and run like every test (see test_harness.h).
+ */
+
+#include "BDD_Manager.h"
+#include "Batch_Runner.h"
+#include "Boolean_Expression.h"
+#include "Truth_Table.h"
+#include "test_harness.h"
+
+#include <memory>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+static string runBatch(const string& input, unsigned threads, size_t cache_bytes, Batch_Runner::Summary& summary) {
+  istringstream in(input);
+  ostringstream out;
+  summary = Batch_Runner(threads, cache_bytes).run(in, out);
+  return out.str();
+}
+
+// "v0 AND v1 AND ... AND v<count-1>"
+static string wideAnd(size_t count) {
+  string text;
+  for (size_t i = 0; i < count; ++i) {
+    text += (i ? " AND v" : "v") + to_string(i);
+  }
+  return text;
+}
+
+int main() {
+  {
+    const string input = "A AND B\n"
+                         "\n"
+                         "A AND (B\n"
+                         "# comment\n"
+                         "  B AND A  \n"
+                         "X OR NOT X\n"
+                         "Y AND NOT Y\n";
+    Batch_Runner::Summary summary;
+    const string output = runBatch(input, 1, Expression_Cache::DEFAULT_MAX_BYTES, summary);
+    check(output == "1\tsatisfiable\t1\t4\tA AND B\n"
+                    "3\terror\tunmatched_open\tUnmatched '(' (column 7)\n"
+                    "5\tsatisfiable\t1\t4\tB AND A\n"
+                    "6\ttautology\t2\t2\tX OR NOT X\n"
+                    "7\tcontradiction\t0\t2\tY AND NOT Y\n",
+          "result lines for a small batch");
+    check(summary.expressions == 5 && summary.errors == 1, "the summary counts lines and errors");
+    check(summary.cache.hits == 1, "B AND A reuses the entry of A AND B");
+
+    runBatch(input, 1, 0, summary);
+    check(summary.cache.hits == 0 && summary.cache.entries == 0, "cache_bytes 0 disables the cache");
+  }
+
+  {
+    // Many lines through several workers come out in input order
+    string input;
+    for (int i = 0; i < 3000; ++i) {
+      input += (i % 7 == 0) ? "A AND AND B\n" : "v" + to_string(i % 13) + " XOR (a OR NOT b" + to_string(i) + ")\n";
+    }
+    Batch_Runner::Summary serial_summary, parallel_summary;
+    const string serial = runBatch(input, 1, 0, serial_summary);
+    const string parallel = runBatch(input, 4, Expression_Cache::DEFAULT_MAX_BYTES, parallel_summary);
+    check(serial == parallel, "4 threads with a cache write what 1 thread writes");
+    check(parallel_summary.expressions == 3000 && parallel_summary.errors == 429, "3000 lines, 429 errors");
+  }
+
+  {
+    // Enumeration and BDD agree; past ENUMERATE_MAX_VARIABLES only the BDD counts
+    for (const char* text : {"A AND B OR C", "A XOR B XOR C XOR D", "A OR NOT A", "A AND NOT A"}) {
+      Boolean_Expression expression(text);
+      const unique_ptr<Truth_Table> table = BDD_Manager::countingTable(expression, nullptr);
+      const BDD_Manager::Row_Count enumerated = BDD_Manager::countRows(expression, table.get());
+      const BDD_Manager::Row_Count symbolic = BDD_Manager::countRows(expression, nullptr);
+      check(table && enumerated.true_rows == symbolic.true_rows && enumerated.rows == symbolic.rows &&
+            enumerated.status == symbolic.status, string("table and BDD count ") + text + " alike");
+    }
+
+    Boolean_Expression wide(wideAnd(BDD_Manager::ENUMERATE_MAX_VARIABLES + 1));
+    check(!BDD_Manager::countingTable(wide, nullptr), "no table past ENUMERATE_MAX_VARIABLES");
+    const BDD_Manager::Row_Count count = BDD_Manager::countRows(wide, nullptr);
+    check(count.true_rows == "1" && count.rows == "33554432" && count.status == "satisfiable",
+          "AND of 25 variables has 1 of 2^25 rows");
+
+    Boolean_Expression huge("(" + wideAnd(100) + ") OR NOT v0");
+    const BDD_Manager::Row_Count huge_count = BDD_Manager::countRows(huge, nullptr);
+    check(huge_count.rows == "2^100" && huge_count.status == "satisfiable", "100 variables count as 2^100 rows");
+  }
+
+  return finish("batch_test");
+}
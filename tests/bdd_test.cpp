@@ -0,0 +1,69 @@
+/**
+ * @file bdd_test.cpp
+ * @brief Regression checks for BDD_Manager counting.
+ *
+ * Wide conjunctions and contradictions are built after other BDDs in the
+ * same manager, so the node table holds nodes the root cannot reach
+ * (including lone literals whose counts would overflow 64 bits).
+ *
+ * Built and run like every test (see test_harness.h).
+ */
+
+#include "BDD_Manager.h"
+#include "Boolean_Expression.h"
+#include "test_harness.h"
+
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+static BDD_Manager::Node build(BDD_Manager& bdd, const string& text) {
+  Boolean_Expression expression(text);
+  return bdd.build(expression.convertToPostfix());
+}
+
+// "v0 AND v1 AND ... AND v<count-1>"
+static string wideAnd(size_t count) {
+  string text;
+  for (size_t i = 0; i < count; ++i) {
+    text += (i ? " AND v" : "v") + to_string(i);
+  }
+  return text;
+}
+
+int main() {
+  {
+    BDD_Manager bdd;
+    const BDD_Manager::Node root = build(bdd, wideAnd(100));
+    check(bdd.satCount(root) == 1, "AND of 100 variables has one true row");
+  }
+  {
+    // Earlier BDDs in the same manager leave unreachable nodes behind
+    BDD_Manager bdd;
+    build(bdd, "v0 OR v1");
+    build(bdd, "v2 XOR v3");
+    const BDD_Manager::Node root = build(bdd, wideAnd(100));
+    check(bdd.satCount(root) == 1, "AND of 100 variables after other BDDs");
+
+    const BDD_Manager::Node contradiction = build(bdd, "(" + wideAnd(100) + ") AND NOT v5");
+    check(contradiction == BDD_Manager::FALSE_NODE, "contradiction is the FALSE node");
+    check(bdd.satCount(contradiction) == 0, "contradiction over 100 variables has no true rows");
+    check(bdd.satFraction(contradiction) == 0.0, "contradiction has fraction 0");
+
+    const BDD_Manager::Node one_free = build(bdd, wideAnd(99));
+    check(bdd.satCount(one_free) == 2, "AND of 99 of 100 variables has two true rows");
+  }
+  {
+    // A count that really needs more than 64 bits still reports it
+    BDD_Manager bdd;
+    const BDD_Manager::Node tautology = build(bdd, "(" + wideAnd(100) + ") OR v7 OR NOT v7");
+    check(throws<overflow_error>([&] { bdd.satCount(tautology); }), "tautology over 100 variables overflows satCount");
+  }
+  {
+    BDD_Manager bdd;
+    check(bdd.satCount(build(bdd, "A AND B OR C")) == 5, "A AND B OR C has five true rows");
+  }
+
+  return finish("bdd_test");
+}
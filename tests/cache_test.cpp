@@ -0,0 +1,76 @@
+/**
+ * @file cache_test.cpp
+ * @brief Regression checks for Truth_Table with a shared Expression_Cache.
+ *
+ * Spellings with one canonical form share the count, but each must show
+ * the step labels of its own spelling, whichever spelling came first.
+ * Past its byte budget the cache evicts the least recently used entry.
+ *
+ * Built and run like every test (see test_harness.h).
+ */
+
+#include "Boolean_Expression.h"
+#include "Expression_Cache.h"
+#include "Truth_Table.h"
+#include "test_harness.h"
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Step labels of the expression's table, compiled through the cache
+static vector<string> labels(const string& text, Expression_Cache& cache, uint64_t* true_rows = nullptr) {
+  Boolean_Expression expression(text);
+  Truth_Table table(expression, false, &cache);
+  if (true_rows) *true_rows = table.countTrue();
+  return table.getProgram().getStepLabels();
+}
+
+int main() {
+  Expression_Cache cache;
+  uint64_t first_count = 0, second_count = 0;
+
+  const vector<string> first = labels("A AND B", cache, &first_count);
+  const vector<string> second = labels("B AND A", cache, &second_count);
+  check(first == vector<string>{"(A AND B)"}, "A AND B is labelled (A AND B)");
+  check(second == vector<string>{"(B AND A)"}, "B AND A after A AND B is labelled (B AND A)");
+  check(first_count == 1 && second_count == 1, "both spellings count one true row");
+  check(cache.getStatistics().hits == 1, "the second spelling is a cache hit");
+
+  const vector<string> doubled = labels("NOT NOT A AND B", cache);
+  check(doubled.size() == 3 && doubled.back() == "(NOT NOT A AND B)",
+        "NOT NOT A AND B keeps its own steps");
+
+  check(labels("A  AND  B", cache) == first, "spacing alone reuses the labels");
+
+  {
+    // Fill a small cache while k0 stays recently used: k1 goes first
+    Expression_Cache small(4096);
+    auto entry = [](size_t bytes) {
+      Expression_Cache::Entry entry;
+      entry.spelling = string(bytes, 'x');
+      return entry;
+    };
+    small.insert("k0", entry(100));
+    small.insert("k1", entry(100));
+    size_t next = 2;
+    while (small.getStatistics().evictions == 0) {
+      check(small.find("k0") != nullptr, "k0 stays while it is used");
+      small.insert("k" + to_string(next++), entry(100));
+    }
+    check(small.find("k1") == nullptr, "the least recently used entry is evicted");
+    check(small.find("k0") != nullptr && small.find("k" + to_string(next - 1)) != nullptr,
+          "recent entries stay");
+    check(small.getStatistics().bytes <= small.getMaxBytes(), "the cache stays within its budget");
+
+    const auto large = small.insert("large", entry(2048));
+    check(large && large->spelling.size() == 2048 && small.find("large") == nullptr,
+          "an entry over a quarter of the budget is returned but not kept");
+
+    small.clear();
+    check(small.getStatistics().entries == 0 && small.find("k0") == nullptr, "clear() empties the cache");
+  }
+
+  return finish("cache_test");
+}
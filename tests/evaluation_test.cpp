@@ -0,0 +1,209 @@
+/**
+ * @file evaluation_test.cpp
+ * @brief Regression checks for table evaluation.
+ *
+ * The compiled program, evaluated row by row, is the reference. Every
+ * bit-sliced kernel the CPU runs (and the JIT kernels where available)
+ * must give the same result bits, whether a block is evaluated afresh or
+ * updated from another block; counting, the result bitset, parallel
+ * output, row views and a multi-output circuit must agree with it.
+ *
+ * Built and run like every test (see test_harness.h).
+ */
+
+#include "Bitslice_Evaluator.h"
+#include "Boolean_Expression.h"
+#include "Logic_Circuit.h"
+#include "Truth_Table.h"
+#include "test_harness.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Result of every row from the compiled program, one row at a time;
+// row r gives variable j the bit (n-1-j) of r
+static vector<bool> referenceRows(const Compiled_Program& program) {
+  const size_t n = program.getVariables().size();
+  vector<bool> results(size_t(1) << n);
+  bool inputs[64];
+  unique_ptr<bool[]> steps(new bool[program.getStepCount() + 1]);
+  for (uint64_t row = 0; row < results.size(); ++row) {
+    for (size_t j = 0; j < n; ++j) inputs[j] = (row >> (n - 1 - j)) & 1;
+    results[row] = program.evaluate(inputs, steps.get());
+  }
+  return results;
+}
+
+// Does the block in buffer (rows from first_row) hold the reference results?
+static bool blockMatches(const Bitslice_Evaluator& evaluator, const Compiled_Program& program, const uint64_t* buffer,
+                         uint64_t first_row, const vector<bool>& reference) {
+  const size_t words = evaluator.getBlockWords();
+  const uint64_t* column = buffer + size_t(program.getResultIndex()) * words;
+  for (uint64_t offset = 0; offset < evaluator.getBlockRows() && first_row + offset < reference.size(); ++offset) {
+    if (((column[offset / 64] >> (offset % 64)) & 1) != reference[first_row + offset]) return false;
+  }
+  return true;
+}
+
+// Every kernel, fresh and updated blocks, against the reference
+static void checkKernels(const string& text) {
+  Boolean_Expression expression(text);
+  Truth_Table table(expression);
+  const Compiled_Program& program = table.getProgram();
+  const vector<bool> reference = referenceRows(program);
+
+  for (Bitslice_Evaluator::Kernel kernel : {Bitslice_Evaluator::Kernel::SCALAR, Bitslice_Evaluator::Kernel::AVX2,
+                                            Bitslice_Evaluator::Kernel::AVX512}) {
+    const Bitslice_Evaluator evaluator(program, kernel);
+    const string name = Bitslice_Evaluator::kernelName(evaluator.getKernel()) + " kernel: " + text;
+    const uint64_t rows = evaluator.getBlockRows();
+    const uint64_t blocks = (reference.size() + rows - 1) / rows;
+    vector<uint64_t> fresh(evaluator.getBufferWords()), updated(evaluator.getBufferWords());
+
+    bool all_fresh = true, all_updated = true;
+    evaluator.evaluateBlock(0, updated.data());
+    for (uint64_t block = 0; block < blocks; ++block) {
+      evaluator.evaluateBlock(block * rows, fresh.data());
+      all_fresh = all_fresh && blockMatches(evaluator, program, fresh.data(), block * rows, reference);
+      if (block > 0) {
+        evaluator.updateBlock((block - 1) * rows, block * rows, updated.data());
+        all_updated = all_updated && blockMatches(evaluator, program, updated.data(), block * rows, reference);
+      }
+    }
+    check(all_fresh, name + " (evaluateBlock)");
+    check(all_updated, name + " (updateBlock)");
+
+    // Gray-code order visits every block once and each buffer is right
+    uint64_t visited = 0;
+    bool all_visited = true;
+    evaluator.forEachBlock(0, blocks, fresh.data(), [&](uint64_t block, const uint64_t* buffer) {
+      ++visited;
+      all_visited = all_visited && blockMatches(evaluator, program, buffer, block * rows, reference);
+    });
+    check(all_visited && visited == blocks, name + " (forEachBlock)");
+  }
+
+  uint64_t true_rows = 0;
+  for (bool value : reference) true_rows += value;
+  check(table.countTrue() == true_rows, "countTrue: " + text);
+
+  if (program.getVariables().size() <= Truth_Table::MAX_BITSET_VARIABLES) {
+    const vector<uint64_t> bits = table.resultBits();
+    bool same = true;
+    for (uint64_t row = 0; row < reference.size(); ++row) {
+      same = same && (((bits[row / 64] >> (row % 64)) & 1) == reference[row]);
+    }
+    check(same, "resultBits: " + text);
+  }
+}
+
+// Table text printed through a sink
+static string printed(Truth_Table& table, Table_Writer::Format format, unsigned threads) {
+  string text;
+  Table_Options options;
+  options.format = format;
+  options.threads = threads;
+  options.sink = [&](const string& data) { text += data; };
+  table.displayTable(options);
+  return text;
+}
+
+// "v0 XOR (v1 AND v2) XOR ..." over count variables
+static string mixed(size_t count) {
+  string text = "v0";
+  for (size_t i = 1; i + 1 < count; i += 2) {
+    text += " XOR (v" + to_string(i) + (i % 4 == 1 ? " AND v" : " OR NOT v") + to_string(i + 1) + ")";
+  }
+  return text;
+}
+
+int main() {
+  checkKernels("A");
+  checkKernels("A AND NOT B");
+  checkKernels("(A OR B) NAND (C NOR D) XOR E");
+  checkKernels("TRUE AND A OR FALSE");
+  checkKernels(mixed(12));
+  checkKernels(mixed(20));
+
+  // JIT kernels (where unsupported, the interpreter keeps running)
+  Bitslice_Evaluator::enableJit(true);
+  {
+    Boolean_Expression expression(mixed(Bitslice_Evaluator::JIT_MIN_VARIABLES + 1));
+    Truth_Table table(expression);
+    const Bitslice_Evaluator evaluator(table.getProgram());
+    check(evaluator.usesJit() == Jit_Kernel::isSupported(), "--jit compiles native code where supported");
+  }
+  checkKernels(mixed(Bitslice_Evaluator::JIT_MIN_VARIABLES + 1));
+  Bitslice_Evaluator::enableJit(false);
+
+  {
+    // Parallel output is identical to serial output, in every format
+    Boolean_Expression expression(mixed(16));
+    Truth_Table table(expression);
+    for (Table_Writer::Format format : {Table_Writer::Format::TEXT, Table_Writer::Format::CSV,
+                                        Table_Writer::Format::JSON_LINES, Table_Writer::Format::MARKDOWN}) {
+      const string serial = printed(table, format, 1);
+      check(!serial.empty() && serial == printed(table, format, 3), "3 threads print what 1 thread prints");
+    }
+
+    const string csv = printed(table, Table_Writer::Format::CSV, 1);
+    size_t lines = 0;
+    for (char ch : csv) lines += ch == '\n';
+    check(lines == table.getLastRow() + 2, "CSV has a header and one line per row");
+  }
+
+  {
+    // Row views read the same values as the reference
+    Boolean_Expression expression("(A AND B) OR (C XOR D)");
+    Truth_Table table(expression);
+    const vector<bool> reference = referenceRows(table.getProgram());
+    const Table_Rows rows = table.rows();
+    check(rows.size() == 16, "rows() has 16 rows");
+    bool same = true;
+    for (const Table_Row& row : rows) {
+      same = same && row.getResult() == reference[row.getIndex()];
+    }
+    check(same, "rows() results match the reference");
+    check(rows[5].getVariable(1) && !rows[5].getVariable(0) && rows[5].getVariable(3), "row 5 is 0101");
+
+    const Filtered_Rows true_rows = table.rows(Row_Filter::result());
+    check(true_rows.count() == table.countTrue(), "the result filter counts the true rows");
+    bool ascending = true, all_true = true;
+    uint64_t previous = 0, seen = 0;
+    for (const Table_Row& row : true_rows) {
+      ascending = ascending && (seen == 0 || row.getIndex() > previous);
+      all_true = all_true && row.getResult();
+      previous = row.getIndex();
+      ++seen;
+    }
+    check(ascending && all_true && seen == true_rows.count(), "the result filter visits true rows in order");
+    check(table.rows(Row_Filter::variable(2, false)).count() == 8, "C = 0 holds on half the rows");
+  }
+
+  {
+    // A circuit counts each output like its own table, with shared steps
+    const vector<string> texts = {"A AND B", "(A AND B) OR C", "NOT (A AND B) XOR C"};
+    vector<unique_ptr<Boolean_Expression>> expressions;
+    vector<const Boolean_Expression*> outputs;
+    for (const string& text : texts) {
+      expressions.push_back(make_unique<Boolean_Expression>(text));
+      outputs.push_back(expressions.back().get());
+    }
+    const Logic_Circuit circuit(outputs, {"F1", "F2", "F3"});
+    const vector<uint64_t> counts = circuit.countTrue();
+    for (size_t k = 0; k < texts.size(); ++k) {
+      Boolean_Expression expression(texts[k]);
+      Truth_Table table(expression);
+      // Rows of the circuit span all three variables; a narrower output repeats
+      const uint64_t repeat = (circuit.getLastRow() + 1) / (table.getLastRow() + 1);
+      check(counts[k] == table.countTrue() * repeat, "circuit output " + texts[k] + " counts like its table");
+    }
+    check(circuit.getStepCount() < circuit.getSeparateStepCount(), "the circuit shares (A AND B)");
+  }
+
+  return finish("evaluation_test");
+}
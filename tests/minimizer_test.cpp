@@ -0,0 +1,99 @@
+/**
+ * @file minimizer_test.cpp
+ * @brief Regression checks for Logic_Minimizer.
+ *
+ * Constant functions, with and without variables, must print as TRUE or
+ * FALSE from both the exact and the heuristic method. A function with a
+ * small BDD but no small cover (parity) must be refused by the heuristic
+ * budget instead of being enumerated, while a plain sum of products over
+ * 34 variables (many BDD paths) must minimize to an equivalent cover.
+ *
+ * Built and run like every test (see test_harness.h).
+ */
+
+#include "BDD_Manager.h"
+#include "Boolean_Expression.h"
+#include "Logic_Minimizer.h"
+#include "Truth_Table.h"
+#include "test_harness.h"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Minimized text of an expression by one method
+static string minimized(const string& text, bool exact) {
+  Boolean_Expression expression(text);
+  if (exact) {
+    Truth_Table table(expression, true);
+    const vector<string> variables = table.getVariables();
+    return Logic_Minimizer::toExpression(
+        Logic_Minimizer::minimizeExact(table.resultBits(), variables.size()), variables);
+  }
+  BDD_Manager bdd;
+  const BDD_Manager::Node root = bdd.build(expression.convertToPostfix());
+  return Logic_Minimizer::toExpression(Logic_Minimizer::minimizeHeuristic(bdd, root), bdd.getVariables());
+}
+
+int main() {
+  struct Case {
+    const char* expression;
+    const char* expected;
+  };
+  const Case cases[] = {
+    {"TRUE", "TRUE"},
+    {"NOT FALSE", "TRUE"},
+    {"TRUE NAND TRUE", "FALSE"},
+    {"FALSE", "FALSE"},
+    {"A OR NOT A", "TRUE"},
+    {"A AND NOT A", "FALSE"},
+    {"(A AND B) OR NOT (A AND B)", "TRUE"},
+    {"A AND B OR A", "A"},
+  };
+
+  for (const Case& test : cases) {
+    for (bool exact : {true, false}) {
+      const string got = minimized(test.expression, exact);
+      check(got == test.expected, string(exact ? "exact" : "heuristic") + ": " + test.expression +
+                                  " gave '" + got + "', expected '" + test.expected + "'");
+    }
+  }
+
+  check(Logic_Minimizer::toExpression({}, {}) == "FALSE", "empty cover without variables");
+  check(Logic_Minimizer::toExpression({Logic_Minimizer::Cube{}}, {}) == "TRUE", "full cover without variables");
+  check(Logic_Minimizer::toExpression({}, {"A"}) == "FALSE", "empty cover with variables");
+
+  {
+    // Parity of 20 variables: 39 BDD nodes, but 2^19 product terms in any cover
+    string parity = "v0";
+    for (int i = 1; i < 20; ++i) parity += " XOR v" + to_string(i);
+    BDD_Manager bdd;
+    const BDD_Manager::Node root = bdd.build(Boolean_Expression(parity).convertToPostfix());
+
+    check(throws<length_error>([&] { Logic_Minimizer::minimizeHeuristic(bdd, root); }),
+          "heuristic refuses parity of 20 variables");
+    check(throws<length_error>([&] { Logic_Minimizer::irredundantCover(bdd, root, 1000); }),
+          "irredundantCover stops past max_cubes");
+  }
+
+  {
+    // A plain sum of products over 34 variables: its BDD has many paths,
+    // but the starting cover is about the expression's own terms
+    const string sop = "(v0 AND v1 AND NOT v2) OR (v3 AND v4 AND v5 AND v6) OR (NOT v7 AND v8 AND v9) OR "
+                       "(v10 AND NOT v11 AND v12 AND v13) OR (v14 AND v15 AND v16) OR (NOT v17 AND v18 AND v19) OR "
+                       "(v20 AND v21 AND NOT v22 AND v23) OR (v24 AND v25 AND v26) OR (v27 AND NOT v28 AND v29) OR "
+                       "(v30 AND v31 AND v32 AND v33) OR (v0 AND v1) OR (v5 AND v12 AND v20) OR (NOT v2 AND v33)";
+    BDD_Manager bdd;
+    const BDD_Manager::Node root = bdd.build(Boolean_Expression(sop).convertToPostfix());
+    check(Logic_Minimizer::irredundantCover(bdd, root).size() <= 13, "irredundantCover of a 13-term SOP");
+    const auto cover = Logic_Minimizer::minimizeHeuristic(bdd, root);
+    const string minimized = Logic_Minimizer::toExpression(cover, bdd.getVariables());
+    const BDD_Manager::Node back = bdd.build(Boolean_Expression(minimized).convertToPostfix());
+    check(back == root, "heuristic cover of a 13-term SOP over 34 variables is equivalent");
+    check(cover.size() == 12, "heuristic drops the term (v0 AND v1 AND NOT v2)");
+  }
+
+  return finish("minimizer_test");
+}
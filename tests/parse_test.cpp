@@ -0,0 +1,129 @@
+/**
+ * @file parse_test.cpp
+ * @brief Regression checks for parsing, canonical forms and simplification.
+ *
+ * Tokens must point back into the source; every malformed input must
+ * raise a Parse_Error of the right kind at the right column. Spellings
+ * that differ only by operand order share a canonical form, and the
+ * simplifier must reduce constants, double negations and contradictions.
+ *
+ * Built and run like every test (see test_harness.h).
+ */
+
+#include "Boolean_Expression.h"
+#include "Expression_Arena.h"
+#include "Parse_Error.h"
+#include "Tokenizer.h"
+#include "test_harness.h"
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Kind and position of the error text raises, or false if it parses
+static bool parseError(const string& text, Parse_Error::Kind& kind, size_t& position) {
+  try {
+    Boolean_Expression expression(text);
+    expression.convertToPostfix();
+  }
+  catch (const Parse_Error& error) {
+    kind = error.getKind();
+    position = error.getPosition();
+    return true;
+  }
+  return false;
+}
+
+int main() {
+  {
+    const string source = "NOT alpha_1 AND (TRUE OR b)";
+    Tokenizer tokenizer(source);
+    const auto& tokens = tokenizer.getTokens();
+    check(tokens.size() == 8, "eight tokens");
+    if (tokens.size() == 8) {
+      check(tokens[0].kind == Token_Kind::OPERATOR && tokens[0].op == Opcode::NOT, "NOT is an operator");
+      check(tokens[1].kind == Token_Kind::VARIABLE && source.substr(tokens[1].offset, tokens[1].length) == "alpha_1",
+            "a variable token points at its name");
+      check(tokens[3].kind == Token_Kind::LEFT_PAREN && tokens[3].offset == 16, "'(' at offset 16");
+      check(tokens[4].kind == Token_Kind::CONSTANT && tokens[4].op == Opcode::CONST_TRUE, "TRUE is a constant");
+      check(tokens[7].kind == Token_Kind::RIGHT_PAREN, "')' closes");
+    }
+    check(tokenizer.getNames().size() == 2 && tokenizer.getNames()[0] == "alpha_1", "names in order of appearance");
+  }
+
+  {
+    struct Case {
+      const char* text;
+      Parse_Error::Kind kind;
+      size_t position;
+    };
+    const Case cases[] = {
+      {"A AND $", Parse_Error::Kind::UNEXPECTED_CHARACTER, 6},
+      {"A AND 1x", Parse_Error::Kind::INVALID_NAME, 6},
+      {"A AND", Parse_Error::Kind::MISSING_OPERAND, 5},
+      {"A AND (OR B)", Parse_Error::Kind::MISSING_OPERAND, 7},
+      {"A B", Parse_Error::Kind::MISSING_OPERATOR, 2},
+      {"(A", Parse_Error::Kind::UNMATCHED_OPEN, 0},
+      {"A)", Parse_Error::Kind::UNMATCHED_CLOSE, 1},
+      {"   ", Parse_Error::Kind::EMPTY_EXPRESSION, 0},
+    };
+    for (const Case& test : cases) {
+      Parse_Error::Kind kind = Parse_Error::Kind::EMPTY_EXPRESSION;
+      size_t position = 0;
+      const bool raised = parseError(test.text, kind, position);
+      check(raised && kind == test.kind && position == test.position,
+            string("'") + test.text + "' is " + Parse_Error::kindName(test.kind) + " at " + to_string(test.position));
+    }
+    check(Parse_Error::quote(string(100, 'x')).size() == Parse_Error::MAX_QUOTED_BYTES + 5,
+          "long quotes are cut");
+  }
+
+  {
+    // Operand order does not change the canonical form; structure does
+    check(Boolean_Expression("A AND B").getCanonicalForm() == Boolean_Expression("B AND A").getCanonicalForm(),
+          "A AND B and B AND A share a canonical form");
+    check(Boolean_Expression("(A OR B) XOR C").getCanonicalForm() ==
+          Boolean_Expression("C XOR (B OR A)").getCanonicalForm(), "nested operands are ordered too");
+    check(Boolean_Expression("A AND B").getCanonicalForm() != Boolean_Expression("A OR B").getCanonicalForm(),
+          "different operators differ");
+    check(Boolean_Expression("NOT NOT A").getCanonicalForm() == "A", "double negation cancels");
+  }
+
+  {
+    struct Case {
+      const char* text;
+      const char* simplified;
+    };
+    const Case cases[] = {
+      {"A AND TRUE", "A"},
+      {"A OR FALSE", "A"},
+      {"A AND FALSE", "FALSE"},
+      {"NOT NOT A", "A"},
+      {"A XOR A", "FALSE"},
+      {"A AND NOT A OR B", "B"},
+      {"(A OR B) AND (B OR A)", "A OR B"},
+    };
+    for (const Case& test : cases) {
+      const string got = Boolean_Expression(test.text).getSimplifiedExpression();
+      check(got == test.simplified, string(test.text) + " simplifies to '" + got + "', expected '" +
+                                    test.simplified + "'");
+    }
+  }
+
+  {
+    // Expressions parsed in an arena behave like heap-parsed ones
+    Expression_Arena arena;
+    Boolean_Expression& first = arena.parse("A AND B");
+    Boolean_Expression& second = arena.parse("B AND NOT C");
+    check(arena.getExpressionCount() == 2, "the arena holds two expressions");
+    check(first.getCanonicalForm() == Boolean_Expression("B AND A").getCanonicalForm(), "arena canonical form");
+    check(second.convertToPostfix() == vector<string>({"B", "C", "NOT", "AND"}), "arena postfix");
+    arena.release();
+    check(arena.getExpressionCount() == 0, "release() empties the arena");
+    check(arena.parse("X OR Y").getCanonicalForm() == Boolean_Expression("Y OR X").getCanonicalForm(),
+          "the arena parses again after release()");
+  }
+
+  return finish("parse_test");
+}
@@ -0,0 +1,156 @@
+/**
+ * @file server_test.cpp
+ * @brief Regression checks for Evaluation_Server (--serve).
+ *
+ * A server runs on a socket in the temporary directory; a client sends
+ * framed requests and reads framed responses. count must agree with
+ * Batch_Runner (BDD_Manager::countRows), pipelined requests on one
+ * connection must be answered in order, and errors must arrive as 'X'
+ * frames without closing the connection.
+ *
+ * Linux only (epoll); elsewhere the test reports itself skipped.
+ *
+ * Built and run like every test (see test_harness.h).
+ */
+
+#include "Evaluation_Server.h"
+#include "test_harness.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+#ifdef __linux__
+
+// Client end of one connection
+class Client {
+  private:
+    int fd = -1;
+
+    bool readAll(char* data, size_t size) {
+      while (size > 0) {
+        const ssize_t got = ::read(fd, data, size);
+        if (got <= 0) return false;
+        data += got;
+        size -= static_cast<size_t>(got);
+      }
+      return true;
+    }
+
+  public:
+    // Connect, retrying while the server is still opening its socket
+    explicit Client(const string& path) {
+      sockaddr_un address{};
+      address.sun_family = AF_UNIX;
+      strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+      for (int attempt = 0; attempt < 200; ++attempt) {
+        fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0) return;
+        ::close(fd);
+        fd = -1;
+        this_thread::sleep_for(chrono::milliseconds(10));
+      }
+    }
+
+    ~Client() {
+      if (fd >= 0) ::close(fd);
+    }
+
+    bool connected() const {
+      return fd >= 0;
+    }
+
+    void send(const string& request) {
+      const uint32_t length = static_cast<uint32_t>(request.size());
+      string frame(reinterpret_cast<const char*>(&length), sizeof(length));
+      frame += request;
+      for (size_t sent = 0; sent < frame.size();) {
+        const ssize_t wrote = ::write(fd, frame.data() + sent, frame.size() - sent);
+        if (wrote <= 0) return;
+        sent += static_cast<size_t>(wrote);
+      }
+    }
+
+    // Body of the next response, prefixed by its last frame type ('E' or 'X')
+    string receive() {
+      string body;
+      while (true) {
+        uint32_t length = 0;
+        if (!readAll(reinterpret_cast<char*>(&length), sizeof(length)) || length == 0) return "closed";
+        string frame(length, '\0');
+        if (!readAll(&frame[0], length)) return "closed";
+        body += frame.substr(1);
+        if (frame[0] != Evaluation_Server::FRAME_DATA) return frame[0] + body;
+      }
+    }
+
+    string request(const string& text) {
+      send(text);
+      return receive();
+    }
+};
+
+int main() {
+  const string path = (filesystem::temp_directory_path() / "server_test.sock").string();
+  remove(path.c_str());
+  Evaluation_Server server(path, 2, Expression_Cache::DEFAULT_MAX_BYTES);
+  thread loop([&] { server.run(); });
+
+  {
+    Client client(path);
+    check(client.connected(), "the client connects");
+
+    check(client.request("count\nA AND B") == "E1\t4\tsatisfiable", "count A AND B");
+    check(client.request("count\nX OR NOT X") == "E2\t2\ttautology", "count a tautology");
+
+    // Past ENUMERATE_MAX_VARIABLES the count comes from the BDD, as in --batch
+    string wide = "v0";
+    for (int i = 1; i < 30; ++i) wide += " AND v" + to_string(i);
+    check(client.request("count\n" + wide) == "E1\t1073741824\tsatisfiable", "count 30 variables by BDD");
+
+    check(client.request("evaluate\nA AND NOT B\nA=1 B=0") == "E1\nNOT B\t1\n(A AND NOT B)\t1\n",
+          "evaluate with steps");
+    check(client.request("equiv\nA AND B\nB AND A") == "Eequivalent\tstructure", "equiv: equivalent");
+    check(client.request("equiv\nA AND B\nA OR B").rfind("Edifferent\t", 0) == 0, "equiv: different");
+    check(client.request("table\nA\ncsv") == "EA\n0\n1\n", "table as CSV");
+
+    const string error = client.request("count\nA AND");
+    check(error.rfind("XMissing operand", 0) == 0, "a parse error is an X frame");
+    check(client.request("bogus").rfind("XUnknown command", 0) == 0, "an unknown command is an X frame");
+    check(client.request("count\nA") == "E1\t2\tsatisfiable", "the connection survives errors");
+
+    // Several requests before reading: answered in order
+    client.send("count\nA AND B AND C");
+    client.send("count\nA OR B OR C");
+    client.send("count\nA AND NOT A");
+    check(client.receive() == "E1\t8\tsatisfiable", "pipelined request 1");
+    check(client.receive() == "E7\t8\tsatisfiable", "pipelined request 2");
+    check(client.receive() == "E0\t2\tcontradiction", "pipelined request 3");
+  }
+
+  server.stop();
+  loop.join();
+  check(server.getRequestsServed() == 13, "every request is counted");
+  return finish("server_test");
+}
+
+#else
+
+int main() {
+  printf("server_test: skipped (needs epoll)\n");
+  return 0;
+}
+
+#endif
@@ -0,0 +1,170 @@
+/**
+ * @file solver_test.cpp
+ * @brief Regression checks for SAT_Solver, Tseitin_Encoder and
+ * Equivalence_Checker.
+ *
+ * The solver must prove a pigeonhole formula unsatisfiable, return models
+ * that satisfy every clause and stop at its conflict limit. Tseitin CNFs
+ * must be satisfiable exactly when the expression can take the asked-for
+ * value, and every counterexample from the equivalence checker must
+ * really tell the two expressions apart.
+ *
+ * Built and run like every test (see test_harness.h).
+ */
+
+#include "Boolean_Expression.h"
+#include "Compiled_Program.h"
+#include "Equivalence_Checker.h"
+#include "Expression_DAG.h"
+#include "SAT_Solver.h"
+#include "Truth_Table.h"
+#include "Tseitin_Encoder.h"
+#include "test_harness.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Pigeons in holes, one pigeon per hole at most: variable p * holes + h + 1
+static void addPigeonhole(SAT_Solver& solver, int pigeons, int holes) {
+  for (int v = 0; v < pigeons * holes; ++v) solver.newVariable();
+  for (int p = 0; p < pigeons; ++p) {
+    vector<int> somewhere;
+    for (int h = 0; h < holes; ++h) somewhere.push_back(p * holes + h + 1);
+    solver.addClause(somewhere);
+  }
+  for (int h = 0; h < holes; ++h) {
+    for (int p = 0; p < pigeons; ++p) {
+      for (int q = p + 1; q < pigeons; ++q) solver.addClause({-(p * holes + h + 1), -(q * holes + h + 1)});
+    }
+  }
+}
+
+// Value of an expression for values given in the order of variables
+static bool evaluate(const string& text, const vector<string>& variables, const vector<bool>& values) {
+  Boolean_Expression expression(text);
+  const Compiled_Program program = Compiled_Program::compile(expression.convertToPostfix(), variables);
+  unique_ptr<bool[]> inputs(new bool[variables.size() + 1]);
+  unique_ptr<bool[]> steps(new bool[program.getStepCount() + 1]);
+  for (size_t i = 0; i < variables.size(); ++i) inputs[i] = values[i];
+  return program.evaluate(inputs.get(), steps.get());
+}
+
+// Solve the Tseitin CNF of "text = value"; on SAT, check the model
+static SAT_Solver::Result solveExpression(const string& text, bool value) {
+  Boolean_Expression expression(text);
+  const vector<string> variables = Truth_Table::collectVariables({&expression});
+  Expression_DAG dag(variables);
+  const Tseitin_Encoder encoder(dag, expression.buildGraph(dag), value);
+  SAT_Solver solver;
+  encoder.addTo(solver);
+  const SAT_Solver::Result result = solver.solve();
+  if (result == SAT_Solver::Result::SATISFIABLE) {
+    vector<bool> model;
+    for (size_t i = 0; i < variables.size(); ++i) model.push_back(solver.getModelValue(static_cast<int>(i) + 1));
+    check(evaluate(text, variables, model) == value, "the model of " + text + " gives it the asked-for value");
+  }
+  return result;
+}
+
+static void checkEquivalence(const string& first_text, const string& second_text, bool equivalent) {
+  Boolean_Expression first(first_text), second(second_text);
+  const Equivalence_Checker::Result result = Equivalence_Checker().check(first, second);
+  const string name = first_text.substr(0, 40) + " vs " + second_text.substr(0, 40);
+  check(result.equivalent == equivalent, name + ": " + (equivalent ? "equivalent" : "different") + " (" +
+                                         Equivalence_Checker::methodName(result.method) + ")");
+  if (!result.equivalent) {
+    const bool a = evaluate(first_text, result.variables, result.counterexample);
+    const bool b = evaluate(second_text, result.variables, result.counterexample);
+    check(a != b && a == result.first_value && b == result.second_value, name + ": the counterexample is real");
+  }
+}
+
+int main() {
+  {
+    SAT_Solver solver;
+    addPigeonhole(solver, 5, 4);
+    check(solver.solve() == SAT_Solver::Result::UNSATISFIABLE, "5 pigeons do not fit in 4 holes");
+  }
+  {
+    SAT_Solver solver;
+    addPigeonhole(solver, 10, 9);
+    // The limit is checked between conflicts, so a chain of them may run a little past it
+    check(solver.solve(50) == SAT_Solver::Result::UNKNOWN && solver.getStatistics().conflicts < 100,
+          "the conflict limit stops a hard formula");
+  }
+  {
+    // Random 3-SAT with a planted solution: satisfiable, and the model
+    // (not necessarily the planted one) satisfies every clause
+    mt19937 rng(12345);
+    const int variables = 150;
+    vector<bool> planted(variables + 1);
+    for (int v = 1; v <= variables; ++v) planted[v] = rng() & 1;
+    SAT_Solver solver;
+    for (int v = 0; v < variables; ++v) solver.newVariable();
+    vector<vector<int>> clauses;
+    while (clauses.size() < 600) {
+      vector<int> clause;
+      bool satisfied = false;
+      for (int k = 0; k < 3; ++k) {
+        const int v = static_cast<int>(rng() % variables) + 1;
+        const bool negated = rng() & 1;
+        clause.push_back(negated ? -v : v);
+        satisfied = satisfied || planted[v] != negated;
+      }
+      if (!satisfied) continue;
+      solver.addClause(clause);
+      clauses.push_back(clause);
+    }
+    check(solver.solve() == SAT_Solver::Result::SATISFIABLE, "planted 3-SAT is satisfiable");
+    bool all = true;
+    for (const vector<int>& clause : clauses) {
+      bool satisfied = false;
+      for (int literal : clause) satisfied = satisfied || solver.getModelValue(abs(literal)) == (literal > 0);
+      all = all && satisfied;
+    }
+    check(all, "the model satisfies every clause");
+  }
+
+  {
+    check(solveExpression("A AND NOT A", true) == SAT_Solver::Result::UNSATISFIABLE, "A AND NOT A is never true");
+    check(solveExpression("A OR NOT A", false) == SAT_Solver::Result::UNSATISFIABLE, "A OR NOT A is never false");
+    check(solveExpression("(A NAND B) NOR (C XOR A)", true) == SAT_Solver::Result::SATISFIABLE, "NAND / NOR / XOR");
+    check(solveExpression("(A NAND B) NOR (C XOR A)", false) == SAT_Solver::Result::SATISFIABLE, "and its negation");
+    check(solveExpression("TRUE AND NOT FALSE", false) == SAT_Solver::Result::UNSATISFIABLE, "constants");
+
+    Boolean_Expression expression("A AND (B OR NOT C)");
+    const vector<string> variables = Truth_Table::collectVariables({&expression});
+    Expression_DAG dag(variables);
+    const Tseitin_Encoder encoder(dag, expression.buildGraph(dag));
+    ostringstream dimacs;
+    encoder.writeDimacs(dimacs);
+    const string header = "p cnf " + to_string(encoder.getVariableCount()) + " " +
+                          to_string(encoder.getClauseCount()) + "\n";
+    check(dimacs.str().find(header) != string::npos, "DIMACS output has its problem line");
+    check(encoder.getVariables().size() == 3 && encoder.getVariables()[0] == "A", "CNF variable 1 is A");
+  }
+
+  {
+    checkEquivalence("A AND B", "B AND A", true);
+    checkEquivalence("NOT (A AND B)", "NOT A OR NOT B", true);
+    checkEquivalence("A XOR B", "(A OR B) AND NOT (A AND B)", true);
+    checkEquivalence("A AND B", "A OR B", false);
+    checkEquivalence("A AND B", "A AND B AND C", false);
+
+    // Random simulation rarely hits a single row of 2^30; the exact stage must
+    string parity = "v0", wide_and = "v1";
+    for (int i = 1; i < 30; ++i) parity += " XOR v" + to_string(i);
+    for (int i = 2; i < 30; ++i) wide_and += " AND v" + to_string(i);
+    checkEquivalence(parity, parity + " XOR (" + wide_and + ")", false);
+    checkEquivalence(parity, "v29 XOR (" + parity.substr(0, parity.rfind(" XOR v29")) + ")", true);
+  }
+
+  return finish("solver_test");
+}
@@ -0,0 +1,134 @@
+/**
+ * @file table_file_test.cpp
+ * @brief Regression checks for saved tables (Truth_Table::saveBinary and
+ * Table_File).
+ *
+ * A saved table must read back with the same rows, counts and labels,
+ * including labels longer than the on-screen limit. Headers whose sizes
+ * are inconsistent with the file, or would wrap when multiplied, must be
+ * rejected with an error instead of being read past the end.
+ *
+ * Built and run like every test (see test_harness.h).
+ */
+
+#include "Boolean_Expression.h"
+#include "Table_File.h"
+#include "Truth_Table.h"
+#include "test_harness.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+static vector<char> readFile(const string& path) {
+  ifstream in(path, ios::binary);
+  return vector<char>(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+}
+
+static void writeFile(const string& path, const vector<char>& bytes) {
+  ofstream out(path, ios::binary | ios::trunc);
+  out.write(bytes.data(), static_cast<streamsize>(bytes.size()));
+}
+
+// Copy of a valid file with its header changed by edit()
+template <typename Edit>
+static bool rejected(const vector<char>& valid, const string& path, Edit edit) {
+  vector<char> bytes = valid;
+  Table_File_Header header;
+  memcpy(&header, bytes.data(), sizeof(header));
+  edit(header, bytes);
+  memcpy(bytes.data(), &header, sizeof(header));
+  writeFile(path, bytes);
+  return throws<runtime_error>([&] { Table_File file(path); });
+}
+
+int main() {
+  const string path = (filesystem::temp_directory_path() / "table_file_test.ttbl").string();
+  const string crafted = (filesystem::temp_directory_path() / "table_file_test_crafted.ttbl").string();
+
+  {
+    // Round trip with step columns
+    Boolean_Expression expression("(A AND B) OR NOT (C XOR A)");
+    Truth_Table table(expression);
+    table.saveBinary(path, true);
+    const Table_File file(path);
+
+    check(file.getVariables() == table.getVariables(), "variables read back");
+    check(file.getLastRow() == table.getLastRow(), "row count reads back");
+    check(file.getColumnCount() == table.getProgram().getStepCount(), "one column per step");
+    check(file.getColumnLabels() == table.getProgram().getStepLabels(), "step labels read back");
+    check(file.countTrue() == table.countTrue(), "true rows read back");
+
+    bool same = true;
+    uint64_t first_true = UINT64_MAX;
+    for (const Table_Row& row : table.rows()) {
+      same = same && file.value(row.getIndex()) == row.getResult();
+      for (size_t step = 0; step < row.getStepCount(); ++step) {
+        same = same && file.value(row.getIndex(), step) == row.getStep(step);
+      }
+      if (row.getResult() && first_true == UINT64_MAX) first_true = row.getIndex();
+    }
+    check(same, "every row and step reads back");
+
+    uint64_t found = 0;
+    check(file.nextTrueRow(0, found) && found == first_true, "nextTrueRow finds the first true row");
+    check(throws<out_of_range>([&] { file.value(table.getLastRow() + 1); }), "rows past the end are refused");
+  }
+
+  {
+    // Labels over the display limit are saved in full
+    const string text = "(first_very_long_variable_name_alpha AND second_very_long_variable_name_beta) OR "
+                        "(third_very_long_variable_name_gamma XOR NOT fourth_very_long_variable_name_delta)";
+    Boolean_Expression expression(text);
+    Truth_Table table(expression);
+    table.saveBinary(path, true);
+    const Table_File file(path);
+
+    check(table.getProgram().getResultLabel().size() <= Compiled_Program::MAX_LABEL_BYTES,
+          "the on-screen result label is shortened");
+    check(file.getExpression() == "(" + text + ")", "the saved expression is the full text");
+    check(file.getColumnLabels().back() == file.getExpression(), "the saved result label is the full text");
+  }
+
+  {
+    // Crafted headers
+    Boolean_Expression expression("A XOR B XOR C");
+    Truth_Table table(expression);
+    table.saveBinary(path);
+    const vector<char> valid = readFile(path);
+    using Header = Table_File_Header;
+
+    check(!rejected(valid, crafted, [](Header&, vector<char>&) {}), "an unchanged copy is accepted");
+    check(rejected(valid, crafted, [](Header& h, vector<char>&) { h.magic[0] = 'X'; }), "bad magic");
+    check(rejected(valid, crafted, [](Header& h, vector<char>&) { h.version = TABLE_FILE_VERSION + 1; }),
+          "unknown version");
+    check(rejected(valid, crafted, [](Header& h, vector<char>&) { h.data_offset += 4; }), "misaligned data");
+    check(rejected(valid, crafted, [](Header& h, vector<char>& bytes) { h.data_offset = bytes.size() + 8; }),
+          "data past the end of the file");
+    check(rejected(valid, crafted, [](Header& h, vector<char>&) { h.column_count = 1u << 31; }),
+          "more columns than the file holds");
+    check(rejected(valid, crafted, [](Header& h, vector<char>&) {
+            h.last_row = UINT64_MAX - 63;   // words_per_column * 8 would wrap
+            h.words_per_column = h.last_row / 64 + 1;
+          }),
+          "a column size that wraps");
+    check(rejected(valid, crafted, [](Header& h, vector<char>&) { h.metadata_size = UINT64_MAX - 8; }),
+          "metadata larger than the file");
+    check(rejected(valid, crafted, [](Header& h, vector<char>&) { h.variable_count = 1000; }),
+          "more variable names than the metadata holds");
+    check(rejected(valid, crafted, [](Header&, vector<char>& bytes) { bytes.resize(bytes.size() - 8); }),
+          "a truncated file");
+  }
+
+  remove(path.c_str());
+  remove(crafted.c_str());
+  return finish("table_file_test");
+}
@@ -0,0 +1,59 @@
+/**
+ * @file test_harness.h
+ * @brief Shared checks for the regression programs in tests/.
+ *
+ * Each test is one program; build and run it from the repository root,
+ * linking every source except main.cpp:
+ *   g++ -std=c++17 -O2 -I. tests/NAME.cpp $(ls *.cpp | grep -v '^main.cpp$') \
+ *       -pthread -o NAME && ./NAME
+ *
+ * check() names every failed check on stderr and keeps going; main()
+ * ends with `return finish("NAME");`, which prints the summary and exits
+ * with 1 if any check failed.
+ */
+
+#ifndef TEST_HARNESS_H
+#define TEST_HARNESS_H
+
+#include <cstdio>
+#include <string>
+
+namespace test_harness {
+
+inline int failures = 0;
+
+inline void check(bool condition, const std::string& what) {
+  if (!condition) {
+    std::fprintf(stderr, "FAILED: %s\n", what.c_str());
+    ++failures;
+  }
+}
+
+// True when action() throws an Error (any other exception escapes)
+template <typename Error, typename Action>
+bool throws(Action action) {
+  try {
+    action();
+  }
+  catch (const Error&) {
+    return true;
+  }
+  return false;
+}
+
+inline int finish(const char* name) {
+  if (failures) {
+    std::fprintf(stderr, "%s: %d check(s) failed\n", name, failures);
+    return 1;
+  }
+  std::printf("%s: all checks passed\n", name);
+  return 0;
+}
+
+} // namespace test_harness
+
+using test_harness::check;
+using test_harness::finish;
+using test_harness::throws;
+
+#endif //TEST_HARNESS_H